@@ -0,0 +1,35 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "Basket.h"
+
+int main(int argc, char *argv[]) {
+  if (argc < 4) {
+	std::cerr
+		<< "missing program arguments" << std::endl
+		<< "expected: " << argv[0] << " " << "path_to_basket_data.csv path_to_basket_config.cfg path_to_composition_snapshot"
+		<< std::endl;
+	return 1;
+  }
+
+  try {
+	const auto start = std::chrono::steady_clock::now();
+	basket::pricer::BasketsComposition basket_composition(argv[1], argv[2]);
+	basket_composition.writeSnapshot(argv[3]);
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+
+	std::size_t weight_count{0};
+	for (const auto &basket_price_data : basket_composition.getBasketPriceData()) {
+	  weight_count += basket_price_data.getConstituents().size();
+	}
+
+	std::cerr << "compiled " << basket_composition.getBasketPriceData().size() << " baskets, "
+			  << basket_composition.getInstrumentCount() << " instruments and " << weight_count << " weights into "
+			  << argv[3] << " in " << elapsed.count() << "s" << std::endl;
+  }
+  catch (const std::exception &e) {
+	std::cerr << e.what();
+	return 1;
+  }
+}
@@ -0,0 +1,109 @@
+#include <iomanip>
+#include <iostream>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "Basket.h"
+#include "BasketPricer.h"
+#include "FanInMarketDataProvider.h"
+#include "SharedMemoryMarketDataProvider.h"
+#include "ThresholdEventSinks.h"
+#include "TickLatencyRecorder.h"
+
+// Prices the ticks PublishSharedMemoryTicks writes into one or more shared memory rings, until every publisher is
+// done, and reports the latency from a tick being written to the pricer being done with it.
+int main(int argc, char *argv[]) {
+  // positional parameters, then options
+  std::vector<std::string> parameters;
+  std::string threshold_events_path{};
+  bool conflate{false};
+  basket::pricer::SharedMemoryFeedConfiguration feed_configuration;
+
+  for (int i = 1; i < argc; i++) {
+	const std::string arg = argv[i];
+	if (arg == "--busy-poll") {
+	  feed_configuration.wait_policy_ = basket::pricer::FeedWaitPolicy::BUSY_POLL;
+	} else if (arg == "--from-oldest") {
+	  feed_configuration.from_oldest_ = true;
+	} else if (arg == "--conflate") {
+	  conflate = true;
+	} else if (arg == "--threshold-events" && i + 1 < argc) {
+	  threshold_events_path = argv[++i];
+	} else {
+	  parameters.push_back(arg);
+	}
+  }
+
+  // the composition is either the two csv files or a snapshot compiled from them by CompileBasketSnapshot
+  const bool from_snapshot = !parameters.empty() && basket::pricer::BasketsComposition::isSnapshot(parameters[0]);
+  const std::size_t feed_parameter = from_snapshot ? 1 : 2;
+
+  if (parameters.size() <= feed_parameter) {
+	std::cerr
+		<< "missing program arguments" << std::endl
+		<< "expected: " << argv[0] << " " << "(path_to_basket_data.csv path_to_basket_config.cfg | path_to_composition_snapshot)"
+		<< " shared_memory_name [shared_memory_name...]"
+		<< " [--busy-poll] [--from-oldest] [--conflate] [--threshold-events path_to_binary_threshold_events]"
+		<< std::endl;
+	return 1;
+  }
+
+  try {
+	auto basket_composition = from_snapshot
+		? basket::pricer::BasketsComposition::loadSnapshot(parameters[0])
+		: basket::pricer::BasketsComposition(parameters[0], parameters[1]);
+
+	// one ring per venue, merged onto the pricing thread when there are several
+	std::vector<std::shared_ptr<basket::pricer::SharedMemoryMarketDataProvider>> feeds;
+	for (auto feed = parameters.begin() + feed_parameter; feed != parameters.end(); ++feed) {
+	  feeds.push_back(std::make_shared<basket::pricer::SharedMemoryMarketDataProvider>(*feed, feed_configuration));
+	}
+
+	std::shared_ptr<basket::pricer::IMarketDataProvider> marketDataProvider = feeds.front();
+	std::shared_ptr<basket::pricer::FanInMarketDataProvider> fanIn;
+	if (feeds.size() > 1) {
+	  std::vector<basket::pricer::MarketDataSource> sources;
+	  for (std::size_t i = 0; i < feeds.size(); i++) {
+		sources.push_back({parameters[feed_parameter + i], feeds[i], feeds[i]->getInstrumentList()});
+	  }
+	  fanIn = std::make_shared<basket::pricer::FanInMarketDataProvider>(std::move(sources));
+	  marketDataProvider = fanIn;
+	}
+
+	basket::pricer::BasketPricerConfiguration configuration;
+	configuration.conflate_same_timestamp_ = conflate;
+	if (!threshold_events_path.empty()) {
+	  configuration.threshold_event_sink_ =
+		  std::make_shared<basket::pricer::BinaryThresholdEventSink>(threshold_events_path);
+	}
+
+	basket::pricer::BasketPricer pricer(basket_composition, marketDataProvider, configuration);
+	pricer.initMarketDataSubscription();
+
+	marketDataProvider->run();
+	pricer.stop();
+
+	// fanned in, a feed is done with a tick once it is queued for the pricing thread
+	std::cerr << (fanIn ? "tick to fan-in queue" : "tick to price") << " latency (ns)" << std::endl
+			  << std::left << std::setw(24) << "feed" << std::right << std::setw(14) << "read"
+			  << std::setw(14) << "overwritten" << std::setw(12) << "p50" << std::setw(12) << "p99"
+			  << std::setw(12) << "p99.9" << std::setw(12) << "max" << std::endl;
+	for (std::size_t i = 0; i < feeds.size(); i++) {
+	  const auto &latency = feeds[i]->getTickToPriceLatency();
+	  std::cerr << std::left << std::setw(24) << parameters[feed_parameter + i]
+				<< std::right << std::setw(14) << feeds[i]->getReadCount()
+				<< std::setw(14) << feeds[i]->getGapCount()
+				<< std::setw(12) << latency.getValueAtPercentile(50)
+				<< std::setw(12) << latency.getValueAtPercentile(99)
+				<< std::setw(12) << latency.getValueAtPercentile(99.9)
+				<< std::setw(12) << latency.getMax() << std::endl;
+	}
+	if (fanIn) fanIn->dumpSourceCounters(std::cerr);
+
+	if constexpr (basket::pricer::TickLatencyRecorder::ENABLED) pricer.dumpTickLatency(std::cerr);
+  }
+  catch (const std::exception &e) {
+	std::cerr << e.what();
+  }
+}
@@ -0,0 +1,146 @@
+#include <chrono>
+#include <iostream>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Basket.h"
+#include "SharedMemoryTickRing.h"
+#include "TickDataGenerator.h"
+
+#include "base/spin_wait.h"
+
+namespace {
+basket::pricer::OverflowPolicy parseOverflowPolicy(const std::string &policy) {
+  if (policy == "drop-oldest") return basket::pricer::OverflowPolicy::DROP_OLDEST;
+  if (policy == "drop-newest") return basket::pricer::OverflowPolicy::DROP_NEWEST;
+  if (policy == "spin") return basket::pricer::OverflowPolicy::SPIN;
+  throw std::invalid_argument("unknown overflow policy " + policy + ", expected drop-oldest, drop-newest or spin");
+}
+}
+
+// Stand-in for a market data gateway: writes the simulated ticks of the composition's instruments into a shared
+// memory ring, for FeedBasketPricer processes to price.
+int main(int argc, char *argv[]) {
+  // positional parameters, then options
+  std::vector<std::string> parameters;
+  std::uint64_t end_timestamp{std::numeric_limits<std::uint64_t>::max()};
+  std::uint64_t nanoseconds_per_timestamp{0};
+  int reader_count{0};
+  int partition{0};
+  int partition_count{1};
+  basket::pricer::TickDataGeneratorConfiguration generator_configuration;
+  basket::pricer::SharedMemoryTickRingConfiguration ring_configuration;
+
+  for (int i = 1; i < argc; i++) {
+	const std::string arg = argv[i];
+	if (arg == "--until" && i + 1 < argc) {
+	  end_timestamp = std::stoull(argv[++i]);
+	} else if (arg == "--seed" && i + 1 < argc) {
+	  generator_configuration.seed_ = std::stoull(argv[++i]);
+	} else if (arg == "--generation-threads" && i + 1 < argc) {
+	  generator_configuration.generation_threads_ = std::stoi(argv[++i]);
+	} else if (arg == "--capacity" && i + 1 < argc) {
+	  ring_configuration.capacity_ = std::stoull(argv[++i]);
+	} else if (arg == "--overflow" && i + 1 < argc) {
+	  ring_configuration.overflow_policy_ = parseOverflowPolicy(argv[++i]);
+	} else if (arg == "--readers" && i + 1 < argc) {
+	  reader_count = std::stoi(argv[++i]);
+	} else if (arg == "--partition" && i + 1 < argc) {
+	  const std::string value = argv[++i];
+	  const auto separator = value.find('/');
+	  partition = std::stoi(value.substr(0, separator));
+	  partition_count = separator == std::string::npos ? 1 : std::stoi(value.substr(separator + 1));
+	  if (partition_count < 1 || partition < 0 || partition >= partition_count) {
+		throw std::invalid_argument("--partition expects index/count with 0 <= index < count, got " + value);
+	  }
+	} else if (arg == "--nanoseconds-per-timestamp" && i + 1 < argc) {
+	  nanoseconds_per_timestamp = std::stoull(argv[++i]);
+	} else {
+	  parameters.push_back(arg);
+	}
+  }
+
+  // the composition is either the two csv files or a snapshot compiled from them by CompileBasketSnapshot
+  const bool from_snapshot = !parameters.empty() && basket::pricer::BasketsComposition::isSnapshot(parameters[0]);
+  const std::size_t simulation_parameter = from_snapshot ? 1 : 2;
+
+  if (parameters.size() <= simulation_parameter + 1) {
+	std::cerr
+		<< "missing program arguments" << std::endl
+		<< "expected: " << argv[0] << " " << "(path_to_basket_data.csv path_to_basket_config.cfg | path_to_composition_snapshot)"
+		<< " path_to_instrument_simulation.cfg shared_memory_name"
+		<< " [--until last_event_timestamp] [--seed seed] [--generation-threads thread_count]"
+		<< " [--capacity ring_slots] [--overflow drop-oldest|drop-newest|spin] [--readers readers_to_wait_for]"
+		<< " [--nanoseconds-per-timestamp pace, 0 publishes as fast as possible]"
+		<< " [--partition index/count, publishes every count-th instrument from the index-th on]"
+		<< std::endl;
+	return 1;
+  }
+
+  try {
+	const auto basket_composition = from_snapshot
+		? basket::pricer::BasketsComposition::loadSnapshot(parameters[0])
+		: basket::pricer::BasketsComposition(parameters[0], parameters[1]);
+
+	basket::pricer::TickDataGenerator tickDataGenerator(parameters[simulation_parameter], generator_configuration);
+	tickDataGenerator.setEndTimestamp(end_timestamp);
+
+	// a partition stands for one of several venues, each publishing its share of the instruments
+	std::vector<std::string> instrumentList;
+	const auto compositionInstruments = basket_composition.getInstrumentList();
+	for (std::size_t i = partition; i < compositionInstruments.size(); i += partition_count) {
+	  instrumentList.push_back(compositionInstruments[i]);
+	}
+	basket::pricer::SharedMemoryTickWriter writer(parameters[simulation_parameter + 1], instrumentList,
+												  ring_configuration);
+
+	// paced, each timestamp is written when due and ends its own batch
+	constexpr static auto SPIN_WINDOW = std::chrono::microseconds(50);
+	std::chrono::steady_clock::time_point start_time{};
+	std::uint64_t first_timestamp{0};
+	bool started{false};
+
+	tickDataGenerator.subscribeBatch([&](const std::span<const basket::pricer::TickEvent> &ticks,
+										 const bool &endOfBatch) {
+	  if (nanoseconds_per_timestamp == 0) {
+		writer.write(ticks, endOfBatch);
+		return;
+	  }
+
+	  for (std::size_t first = 0; first < ticks.size();) {
+		const auto event_timestamp = ticks[first].event_timestamp_;
+		auto end = first + 1;
+		while (end < ticks.size() && ticks[end].event_timestamp_ == event_timestamp) end++;
+
+		if (!started) {
+		  start_time = std::chrono::steady_clock::now();
+		  first_timestamp = event_timestamp;
+		  started = true;
+		}
+		const auto due = start_time + std::chrono::nanoseconds((event_timestamp - first_timestamp) * nanoseconds_per_timestamp);
+		if (due - std::chrono::steady_clock::now() > SPIN_WINDOW) std::this_thread::sleep_until(due - SPIN_WINDOW);
+		while (std::chrono::steady_clock::now() < due) basket::pricer::cpuRelax();
+
+		writer.write(ticks.subspan(first, end - first), end < ticks.size() || endOfBatch);
+		first = end;
+	  }
+	}, std::move(instrumentList));
+
+	while (writer.getAttachedReaderCount() < reader_count) std::this_thread::sleep_for(std::chrono::milliseconds(1));
+
+	const auto start = std::chrono::steady_clock::now();
+	tickDataGenerator.run();
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	writer.close();
+
+	std::cerr << "wrote " << writer.getWriteCount() << " ticks in " << elapsed.count() << "s, "
+			  << writer.getWriteCount() / elapsed.count() << " ticks/s, " << writer.getFullCount()
+			  << " found the ring full, " << writer.getDroppedCount() << " dropped" << std::endl;
+  }
+  catch (const std::exception &e) {
+	std::cerr << e.what();
+  }
+}
@@ -0,0 +1,53 @@
+#include <chrono>
+#include <iostream>
+#include <string>
+
+#include "Basket.h"
+#include "BasketPricer.h"
+#include "ReplayMarketDataProvider.h"
+#include "StaticTickPipeline.h"
+#include "TickLatencyRecorder.h"
+
+int main(int argc, char *argv[]) {
+  // the composition is either the two csv files or a snapshot compiled from them by CompileBasketSnapshot
+  const int composition_arguments = (argc > 1 && basket::pricer::BasketsComposition::isSnapshot(argv[1])) ? 1 : 2;
+  const int capture_argument = 1 + composition_arguments;
+
+  if (argc <= capture_argument) {
+	std::cerr
+		<< "missing program arguments" << std::endl
+		<< "expected: " << argv[0] << " " << "(path_to_basket_data.csv path_to_basket_config.cfg | path_to_composition_snapshot)"
+		<< " path_to_tick_capture"
+		<< " [nanoseconds_per_timestamp, 0 replays as fast as possible]"
+		<< std::endl;
+	return 1;
+  }
+
+  try {
+	auto basket_composition = composition_arguments == 1
+		? basket::pricer::BasketsComposition::loadSnapshot(argv[1])
+		: basket::pricer::BasketsComposition(argv[1], argv[2]);
+
+	basket::pricer::ReplayConfiguration configuration;
+	if (argc > capture_argument + 1) configuration.nanoseconds_per_timestamp_ = std::stoull(argv[capture_argument + 1]);
+
+	auto marketDataProvider = std::make_shared<basket::pricer::ReplayMarketDataProvider>(argv[capture_argument],
+																							 configuration);
+
+	basket::pricer::BasketPricer pricer(basket_composition, marketDataProvider);
+	pricer.initMarketDataSubscription();
+
+	const auto start = std::chrono::steady_clock::now();
+	basket::pricer::runTickPipeline(*marketDataProvider, pricer);
+	const std::chrono::duration<double> elapsed = std::chrono::steady_clock::now() - start;
+	pricer.stop();
+
+	std::cerr << "replayed " << marketDataProvider->getRecordCount() << " ticks in " << elapsed.count() << "s, "
+			  << marketDataProvider->getRecordCount() / elapsed.count() << " ticks/s" << std::endl;
+
+	if constexpr (basket::pricer::TickLatencyRecorder::ENABLED) pricer.dumpTickLatency(std::cerr);
+  }
+  catch (const std::exception &e) {
+	std::cerr << e.what();
+  }
+}
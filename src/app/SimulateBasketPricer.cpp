@@ -1,30 +1,211 @@
+#include <atomic>
+#include <chrono>
+#include <csignal>
+#include <cstdlib>
 #include <iostream>
+#include <limits>
+#include <optional>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
 
 #include "Basket.h"
 #include "BasketPricer.h"
+#include "CompositionWatcher.h"
+#include "RecordingMarketDataProvider.h"
+#include "ShardedBasketPricer.h"
+#include "StaticTickPipeline.h"
+#include "ThresholdEventSinks.h"
 #include "TickDataGenerator.h"
+#include "TickLatencyRecorder.h"
+
+namespace {
+// SIGINT and SIGTERM stop the simulation on a whole timestamp, the pricer then stops as at the end of the run,
+// flushing its threshold events, and the program exits with 128 + signal; a second one exits at once. SIGUSR1 dumps
+// the tick latency percentiles. The signals are blocked before any thread starts and taken by a dedicated thread,
+// which can print safely.
+std::atomic<int> stop_signal{0};
+
+sigset_t blockSignals() {
+  sigset_t signals;
+  sigemptyset(&signals);
+  if constexpr (basket::pricer::TickLatencyRecorder::ENABLED) sigaddset(&signals, SIGUSR1);
+  sigaddset(&signals, SIGINT);
+  sigaddset(&signals, SIGTERM);
+  pthread_sigmask(SIG_BLOCK, &signals, nullptr);
+  return signals;
+}
+
+// takes the signals until handling is reset
+template<typename Pricer>
+std::thread handleSignals(const Pricer &pricer,
+						  basket::pricer::TickDataGenerator &tickDataGenerator,
+						  const sigset_t &signals,
+						  const std::atomic<bool> &handling) {
+  return std::thread([&pricer, &tickDataGenerator, signals, &handling] {
+	constexpr static timespec POLL_INTERVAL{0, 100'000'000};
+
+	while (handling.load(std::memory_order_acquire)) {
+	  const int signal = sigtimedwait(&signals, nullptr, &POLL_INTERVAL);
+	  if (signal < 0) continue;
+
+	  if (signal == SIGUSR1) {
+		pricer.dumpTickLatency(std::cerr);
+	  } else if (stop_signal.exchange(signal) == 0) {
+		tickDataGenerator.requestStop();
+	  } else {
+		std::_Exit(128 + signal);
+	  }
+	}
+  });
+}
+
+// statically bound to the pricer when both types allow, see StaticTickPipeline.h
+template<typename Pricer, typename Provider>
+void run(Pricer &pricer,
+		 Provider &marketDataProvider,
+		 basket::pricer::TickDataGenerator &tickDataGenerator,
+		 const sigset_t &signals,
+		 const bool &conflate) {
+  pricer.initMarketDataSubscription();
+
+  std::atomic<bool> handling{true};
+  std::thread signal_handler = handleSignals(pricer, tickDataGenerator, signals, handling);
+
+  basket::pricer::runTickPipeline(marketDataProvider, pricer);
+  pricer.stop();
+
+  handling.store(false, std::memory_order_release);
+  signal_handler.join();
+
+  if (conflate) {
+	const auto counters = pricer.getConflationCounters();
+	std::cerr << "conflated " << counters.ticks_ << " ticks over " << counters.timestamps_ << " timestamps into "
+			  << counters.instrument_updates_ << " instrument updates, " << counters.getConflationRatio()
+			  << " ticks per update, " << counters.basket_revaluations_ << " basket revaluations" << std::endl;
+  }
+
+  if constexpr (basket::pricer::TickLatencyRecorder::ENABLED) pricer.dumpTickLatency(std::cerr);
+}
+}
 
 int main(int argc, char *argv[]) {
-  if (argc < 4) {
+  const sigset_t signals = blockSignals();
+
+  // positional parameters, then options
+  std::vector<std::string> parameters;
+  std::string record_path{};
+  std::string threshold_events_path{};
+  bool conflate{false};
+  std::uint64_t end_timestamp{std::numeric_limits<std::uint64_t>::max()};
+  basket::pricer::TickDataGeneratorConfiguration generator_configuration;
+  std::optional<basket::pricer::CompositionWatcherConfiguration> watcher_configuration{};
+
+  for (int i = 1; i < argc; i++) {
+	const std::string arg = argv[i];
+	if (arg == "--record" && i + 1 < argc) {
+	  record_path = argv[++i];
+	} else if (arg == "--until" && i + 1 < argc) {
+	  end_timestamp = std::stoull(argv[++i]);
+	} else if (arg == "--seed" && i + 1 < argc) {
+	  generator_configuration.seed_ = std::stoull(argv[++i]);
+	} else if (arg == "--generation-threads" && i + 1 < argc) {
+	  generator_configuration.generation_threads_ = std::stoi(argv[++i]);
+	} else if (arg == "--conflate") {
+	  conflate = true;
+	} else if (arg == "--threshold-events" && i + 1 < argc) {
+	  threshold_events_path = argv[++i];
+	} else if (arg == "--watch-composition" && i + 1 < argc) {
+	  watcher_configuration.emplace().poll_interval_ = std::chrono::milliseconds(std::stoll(argv[++i]));
+	} else {
+	  parameters.push_back(arg);
+	}
+  }
+
+  // the composition is either the two csv files or a snapshot compiled from them by CompileBasketSnapshot
+  const bool from_snapshot = !parameters.empty() && basket::pricer::BasketsComposition::isSnapshot(parameters[0]);
+  const std::size_t simulation_parameter = from_snapshot ? 1 : 2;
+
+  if (parameters.size() <= simulation_parameter) {
 	std::cerr
 		<< "missing program arguments" << std::endl
-		<< "expected: " << argv[0] << " " << "path_to_basket_data.csv path_to_basket_config.cfg path_to_instrument_simulation.cfg"
+		<< "expected: " << argv[0] << " " << "(path_to_basket_data.csv path_to_basket_config.cfg | path_to_composition_snapshot)"
+		<< " path_to_instrument_simulation.cfg [shard_count]"
+		<< " [--record path_to_tick_capture] [--until last_event_timestamp]"
+		<< " [--seed seed] [--generation-threads thread_count] [--watch-composition poll_interval_ms]"
+		<< " [--threshold-events path_to_binary_threshold_events] [--conflate]"
 		<< std::endl;
 	return 1;
   }
 
   try {
-	basket::pricer::BasketsComposition basket_composition(argv[1], argv[2]);
+	auto basket_composition = from_snapshot
+		? basket::pricer::BasketsComposition::loadSnapshot(parameters[0])
+		: basket::pricer::BasketsComposition(parameters[0], parameters[1]);
+
+	auto tickDataGenerator = std::make_shared<basket::pricer::TickDataGenerator>(parameters[simulation_parameter],
+																				   generator_configuration);
+	tickDataGenerator->setEndTimestamp(end_timestamp);
 
-	std::shared_ptr<basket::pricer::IMarketDataProvider> marketDataProvider(
-		new basket::pricer::TickDataGenerator(argv[3]));
+	std::shared_ptr<basket::pricer::IMarketDataProvider> marketDataProvider = tickDataGenerator;
+	if (!record_path.empty()) {
+	  marketDataProvider = std::make_shared<basket::pricer::RecordingMarketDataProvider>(tickDataGenerator, record_path);
+	}
 
-	basket::pricer::BasketPricer pricer(basket_composition, marketDataProvider);
-	pricer.initMarketDataSubscription();
+	if (parameters.size() > simulation_parameter + 1) {
+	  if (watcher_configuration) {
+		throw std::invalid_argument("--watch-composition is not supported with sharded pricing");
+	  }
 
-	marketDataProvider->run();
+	  basket::pricer::ShardedBasketPricerConfiguration configuration;
+	  configuration.shard_count_ = std::stoi(parameters[simulation_parameter + 1]);
+	  configuration.shard_pricer_configuration_.conflate_same_timestamp_ = conflate;
+	  if (!threshold_events_path.empty()) {
+		configuration.threshold_event_sink_factory_ = [&threshold_events_path](const int &shard) {
+		  return std::make_shared<basket::pricer::BinaryThresholdEventSink>(
+			  threshold_events_path + "." + std::to_string(shard));
+		};
+	  }
+
+	  basket::pricer::ShardedBasketPricer pricer(basket_composition, marketDataProvider, configuration);
+	  run(pricer, *marketDataProvider, *tickDataGenerator, signals, conflate);
+	} else {
+	  basket::pricer::BasketPricerConfiguration configuration;
+	  configuration.conflate_same_timestamp_ = conflate;
+	  if (!threshold_events_path.empty()) {
+		configuration.threshold_event_sink_ =
+			std::make_shared<basket::pricer::BinaryThresholdEventSink>(threshold_events_path);
+	  }
+
+	  basket::pricer::BasketPricer pricer(basket_composition, marketDataProvider, configuration);
+
+	  // composition file changes are priced from the next tick on, without restarting
+	  std::optional<basket::pricer::CompositionWatcher> watcher;
+	  if (watcher_configuration) {
+		const auto composition_paths = std::vector<std::string>(parameters.begin(),
+																parameters.begin() + simulation_parameter);
+		watcher.emplace(composition_paths,
+						[&pricer](const basket::pricer::BasketsComposition &composition) {
+						  pricer.reloadComposition(composition);
+						  std::cerr << "Composition reloaded, " << composition.getBasketPriceData().size()
+									<< " baskets" << std::endl;
+						},
+						*watcher_configuration);
+		watcher->start();
+	  }
+
+	  if (record_path.empty()) {
+		run(pricer, *tickDataGenerator, *tickDataGenerator, signals, conflate);
+	  } else {
+		run(pricer, *marketDataProvider, *tickDataGenerator, signals, conflate);
+	  }
+	}
   }
   catch (const std::exception &e) {
 	std::cerr << e.what();
   }
-}
\ No newline at end of file
+
+  const int signal = stop_signal.load();
+  return signal == 0 ? 0 : 128 + signal;
+}
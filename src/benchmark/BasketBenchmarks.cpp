@@ -0,0 +1,128 @@
+#include <algorithm>
+#include <fstream>
+#include <iostream>
+#include <iomanip>
+#include <utility>
+
+#include "BenchmarkHarness.h"
+
+namespace basket::benchmark {
+namespace {
+std::vector<std::pair<std::string, BenchmarkSuiteFunc>> &registeredSuites() {
+  static std::vector<std::pair<std::string, BenchmarkSuiteFunc>> suites;
+  return suites;
+}
+}
+
+BenchmarkSuiteRegistrar::BenchmarkSuiteRegistrar(const std::string &name, BenchmarkSuiteFunc &&suite) {
+  registeredSuites().emplace_back(name, std::move(suite));
+}
+
+const BenchmarkResult &BenchmarkContext::record(const std::string &name,
+												const std::uint64_t &operations,
+												std::vector<double> &&samples) {
+  std::sort(samples.begin(), samples.end());
+
+  BenchmarkResult result;
+  result.suite_ = suite_;
+  result.name_ = name;
+  result.operations_ = operations;
+  result.best_ns_ = samples.front();
+  result.median_ns_ = samples[samples.size() / 2];
+
+  std::cout << std::left << std::setw(24) << suite_ << std::setw(48) << name
+			<< std::right << std::fixed << std::setprecision(2)
+			<< std::setw(12) << result.nsPerOperation() << " ns/op"
+			<< std::setw(16) << std::setprecision(0) << result.operationsPerSecond() << " op/s"
+			<< std::endl;
+
+  results_.push_back(std::move(result));
+  return results_.back();
+}
+
+// text as a JSON string, or as a CSV field when csv is set: names may hold quotes, commas or backslashes
+void writeQuoted(std::ostream &os, const std::string &text, const bool &csv) {
+  os << '"';
+  for (const char c : text) {
+	if (c == '"') {
+	  os << (csv ? "\"\"" : "\\\"");
+	} else if (c == '\\' && !csv) {
+	  os << "\\\\";
+	} else if (static_cast<unsigned char>(c) < 0x20 && !csv) {
+	  os << "\\u" << std::hex << std::setw(4) << std::setfill('0') << static_cast<int>(c) << std::dec
+		 << std::setfill(' ');
+	} else {
+	  os << c;
+	}
+  }
+  os << '"';
+}
+
+void writeJsonReport(std::ostream &os, const std::vector<BenchmarkResult> &results) {
+  os << "[" << std::endl;
+  for (std::size_t i = 0; i < results.size(); i++) {
+	const auto &result = results[i];
+	os << std::setprecision(17) << "  {\"suite\": ";
+	writeQuoted(os, result.suite_, false);
+	os << ", \"name\": ";
+	writeQuoted(os, result.name_, false);
+	os << ", \"operations\": " << result.operations_
+	   << ", \"best_ns\": " << result.best_ns_
+	   << ", \"median_ns\": " << result.median_ns_
+	   << ", \"ns_per_operation\": " << result.nsPerOperation()
+	   << ", \"operations_per_second\": " << result.operationsPerSecond() << "}"
+	   << (i + 1 < results.size() ? "," : "") << std::endl;
+  }
+  os << "]" << std::endl;
+}
+
+void writeCsvReport(std::ostream &os, const std::vector<BenchmarkResult> &results) {
+  os << "suite,name,operations,best_ns,median_ns,ns_per_operation,operations_per_second" << std::endl;
+  for (const auto &result : results) {
+	os << std::setprecision(17);
+	writeQuoted(os, result.suite_, true);
+	os << ',';
+	writeQuoted(os, result.name_, true);
+	os << ',' << result.operations_ << ','
+	   << result.best_ns_ << ',' << result.median_ns_ << ','
+	   << result.nsPerOperation() << ',' << result.operationsPerSecond() << std::endl;
+  }
+}
+}
+
+int main(int argc, char *argv[]) {
+  using namespace basket::benchmark;
+
+  constexpr static int REPETITIONS = 5;
+
+  // [filter] [--json path] [--csv path] - only run suites whose name contains filter, write the reports to path
+  std::string filter{}, json_path{}, csv_path{};
+  for (int i = 1; i < argc; i++) {
+	const std::string arg = argv[i];
+	if ((arg == "--json" || arg == "--csv") && i + 1 < argc) {
+	  (arg == "--json" ? json_path : csv_path) = argv[++i];
+	} else if (arg.rfind("--", 0) == 0) {
+	  std::cerr << "usage: " << argv[0] << " [suite_filter] [--json path] [--csv path]" << std::endl;
+	  return 1;
+	} else {
+	  filter = arg;
+	}
+  }
+
+  BenchmarkContext context(REPETITIONS);
+
+  for (auto &[name, suite] : registeredSuites()) {
+	if (name.find(filter) == std::string::npos) continue;
+	context.setSuite(name);
+	suite(context);
+  }
+
+  if (!json_path.empty()) {
+	std::ofstream json(json_path);
+	writeJsonReport(json, context.getResults());
+  }
+  if (!csv_path.empty()) {
+	std::ofstream csv(csv_path);
+	writeCsvReport(csv, context.getResults());
+  }
+}
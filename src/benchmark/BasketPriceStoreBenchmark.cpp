@@ -0,0 +1,142 @@
+#include <algorithm>
+#include <iostream>
+#include <iterator>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Basket.h"
+#include "BasketPriceStore.h"
+#include "BenchmarkHarness.h"
+#include "SyntheticData.h"
+
+#include "base/fixed_point.h"
+
+namespace basket::benchmark {
+namespace {
+using pricer::BasketBreach;
+using pricer::BasketPriceStore;
+using pricer::InstrumentPriceDelta;
+
+constexpr static int INSTRUMENTS = 2000;
+constexpr static int BASKETS = 20000;
+constexpr static int CONSTITUENTS_PER_BASKET = 32;
+constexpr static int BATCHES = 64;
+constexpr static double THRESHOLD_PCT = 0.05;
+
+const char *simdLevelName(const BasketPriceStore::SimdLevel &simdLevel) {
+  switch (simdLevel) {
+	case BasketPriceStore::SimdLevel::AVX512: return "avx512";
+	case BasketPriceStore::SimdLevel::AVX2: return "avx2";
+	default: return "scalar";
+  }
+}
+
+// Batches of +/- 0.01 moves, every batch followed by its reversal so prices stay bounded however often it replays
+std::vector<std::vector<InstrumentPriceDelta>> makeBatches(const int &deltas_per_batch) {
+  std::mt19937 generator(11);
+  std::uniform_int_distribution<int> instrument_draw(0, INSTRUMENTS - 1);
+  std::uniform_int_distribution<int> move_draw(-2, 2);
+
+  constexpr pricer::PriceType CENT = pricer::PRICE_SCALE / 100;
+
+  std::vector<std::vector<InstrumentPriceDelta>> batches;
+  for (int batch = 0; batch < BATCHES / 2; batch++) {
+	std::vector<InstrumentPriceDelta> deltas, reversed;
+	for (int i = 0; i < deltas_per_batch; i++) {
+	  const InstrumentPriceDelta delta{instrument_draw(generator), move_draw(generator) * CENT,
+									   move_draw(generator) * CENT, move_draw(generator) * CENT};
+	  deltas.push_back(delta);
+	  reversed.push_back({delta.instrumentId_, -delta.bid_delta_, -delta.ask_delta_, -delta.last_delta_});
+	}
+	batches.push_back(std::move(deltas));
+	batches.push_back(std::move(reversed));
+  }
+  return batches;
+}
+
+bool sameState(const BasketPriceStore &lhs, const BasketPriceStore &rhs) {
+  for (int i = 0; i < lhs.getBasketCount(); i++) {
+	if (lhs.getBidPrice(i) != rhs.getBidPrice(i) || lhs.getAskPrice(i) != rhs.getAskPrice(i) ||
+		lhs.getMidPrice(i) != rhs.getMidPrice(i) || lhs.getLastPrice(i) != rhs.getLastPrice(i)) {
+	  return false;
+	}
+  }
+  return true;
+}
+
+bool sameBreaches(const std::vector<BasketBreach> &lhs, const std::vector<BasketBreach> &rhs) {
+  if (lhs.size() != rhs.size()) return false;
+  for (int i = 0; i < lhs.size(); i++) {
+	if (lhs[i].basket_id_ != rhs[i].basket_id_ || lhs[i].is_last_price_ != rhs[i].is_last_price_ ||
+		lhs[i].prev_price_ != rhs[i].prev_price_ || lhs[i].new_price_ != rhs[i].new_price_) {
+	  return false;
+	}
+  }
+  return true;
+}
+
+// Batch revaluation throughput, in instrument deltas applied per second, for every kernel the cpu supports
+void batchRevaluation(BenchmarkContext &context) {
+  std::mt19937 generator(5);
+  std::vector<int> universe(INSTRUMENTS);
+  for (int i = 0; i < INSTRUMENTS; i++) universe[i] = i;
+
+  std::vector<std::vector<int>> baskets(BASKETS);
+  for (auto &basket : baskets) {
+	std::sample(universe.begin(), universe.end(), std::back_inserter(basket), CONSTITUENTS_PER_BASKET, generator);
+  }
+
+  const auto files = writeSyntheticBaskets("price_store", baskets, THRESHOLD_PCT);
+  const pricer::BasketsComposition composition(files.basket_data_csv_, files.basket_config_csv_);
+
+  std::vector<pricer::InstrumentPrice> instrument_prices(composition.getInstrumentCount(),
+														pricer::InstrumentPrice{pricer::toPrice(100.00),
+																				pricer::toPrice(100.02),
+																				pricer::toPrice(100.01)});
+
+  std::vector<BasketPriceStore::SimdLevel> simd_levels{BasketPriceStore::SimdLevel::SCALAR};
+  if (BasketPriceStore::getSupportedSimdLevel() >= BasketPriceStore::SimdLevel::AVX2)
+	simd_levels.push_back(BasketPriceStore::SimdLevel::AVX2);
+  if (BasketPriceStore::getSupportedSimdLevel() >= BasketPriceStore::SimdLevel::AVX512)
+	simd_levels.push_back(BasketPriceStore::SimdLevel::AVX512);
+
+  for (const int deltas_per_batch : {100, 1000, 10000}) {
+	const auto batches = makeBatches(deltas_per_batch);
+
+	// reference results of the scalar kernel on one pass over the batches
+	std::vector<BasketBreach> reference_breaches;
+	BasketPriceStore reference(composition);
+	reference.setSimdLevel(BasketPriceStore::SimdLevel::SCALAR);
+	reference.revalue(instrument_prices);
+	for (const auto &batch : batches) reference.applyDeltas(batch, reference_breaches);
+
+	for (const auto &simd_level : simd_levels) {
+	  BasketPriceStore store(composition);
+	  store.setSimdLevel(simd_level);
+	  store.revalue(instrument_prices);
+
+	  std::vector<BasketBreach> breaches;
+	  for (const auto &batch : batches) store.applyDeltas(batch, breaches);
+	  if (!sameState(store, reference) || !sameBreaches(breaches, reference_breaches)) {
+		std::cout << "  " << simdLevelName(simd_level) << " kernel disagrees with the scalar kernel" << std::endl;
+	  }
+
+	  context.measure("apply_deltas/" + std::string(simdLevelName(simd_level)) +
+						  "/deltas_per_batch=" + std::to_string(deltas_per_batch),
+					  static_cast<std::uint64_t>(deltas_per_batch) * batches.size(), [&] {
+		for (const auto &batch : batches) {
+		  breaches.clear();
+		  store.applyDeltas(batch, breaches);
+		}
+		doNotOptimize(breaches.size());
+	  });
+	}
+  }
+}
+
+const BenchmarkSuiteRegistrar registrar("basket_price_store", [](BenchmarkContext &context) {
+  batchRevaluation(context);
+});
+}
+}
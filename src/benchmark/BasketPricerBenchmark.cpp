@@ -0,0 +1,272 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <vector>
+
+#include "Basket.h"
+#include "BasketPricer.h"
+#include "BenchmarkHarness.h"
+#include "BenchmarkMarketDataProvider.h"
+#include "SyntheticData.h"
+
+namespace basket::benchmark {
+namespace {
+struct WarmPricer {
+  std::shared_ptr<BenchmarkMarketDataProvider> provider_{};
+  std::unique_ptr<pricer::BasketPricer> pricer_{};
+};
+
+// Builds a pricer over the composition with every basket ready
+WarmPricer makeWarmPricer(const std::string &tag,
+						  const std::vector<std::vector<int>> &basket_constituents,
+						  const pricer::BasketPricerConfiguration &configuration = {}) {
+  const auto files = writeSyntheticBaskets(tag, basket_constituents, NEVER_BREACHED_THRESHOLD_PCT);
+  pricer::BasketsComposition composition(files.basket_data_csv_, files.basket_config_csv_);
+
+  WarmPricer warm_pricer;
+  warm_pricer.provider_ = std::make_shared<BenchmarkMarketDataProvider>();
+  warm_pricer.pricer_ = std::make_unique<pricer::BasketPricer>(composition, warm_pricer.provider_, configuration);
+  warm_pricer.pricer_->initMarketDataSubscription();
+
+  for (const auto &tick : warmUpTicks(static_cast<int>(warm_pricer.provider_->getInstrumentList().size()))) {
+	warm_pricer.provider_->publish(tick);
+  }
+  return warm_pricer;
+}
+
+// Per tick cost should follow the fan-out of the ticking instrument, not the total basket count:
+// the same hot baskets are priced while more and more baskets over unrelated instruments are added.
+void unrelatedBasketScaling(BenchmarkContext &context) {
+  constexpr static int HOT_INSTRUMENTS = 64;
+  constexpr static int HOT_BASKETS = 256;
+  constexpr static int UNRELATED_INSTRUMENTS = 4096;
+  constexpr static int CONSTITUENTS_PER_BASKET = 16;
+  constexpr static int TICK_COUNT = 300000;
+
+  const auto ticks = makeTicks(TICK_COUNT, HOT_INSTRUMENTS);
+
+  for (const int unrelated_baskets : {0, 1000, 10000, 50000}) {
+	std::mt19937 generator(42);
+	auto baskets = randomBaskets(HOT_BASKETS, 0, HOT_INSTRUMENTS, CONSTITUENTS_PER_BASKET, generator);
+	auto unrelated = randomBaskets(unrelated_baskets, HOT_INSTRUMENTS, UNRELATED_INSTRUMENTS,
+								   CONSTITUENTS_PER_BASKET, generator);
+	baskets.insert(baskets.end(), unrelated.begin(), unrelated.end());
+
+	auto warm_pricer = makeWarmPricer("unrelated_scaling", baskets);
+
+	context.measure("onTickUpdate/unrelated_baskets=" + std::to_string(unrelated_baskets), ticks.size(), [&] {
+	  for (const auto &tick : ticks) warm_pricer.provider_->publish(tick);
+	});
+  }
+}
+
+// Per tick cost against the number of baskets each instrument belongs to: basket_count * 16 / instrument_count
+void basketAndInstrumentScaling(BenchmarkContext &context) {
+  constexpr static int CONSTITUENTS_PER_BASKET = 16;
+  constexpr static int TICK_COUNT = 300000;
+
+  for (const int instrument_count : {100, 1000}) {
+	const auto ticks = makeTicks(TICK_COUNT, instrument_count);
+
+	for (const int basket_count : {100, 1000, 10000}) {
+	  std::mt19937 generator(42);
+	  auto warm_pricer = makeWarmPricer("basket_instrument_scaling",
+										randomBaskets(basket_count, 0, instrument_count, CONSTITUENTS_PER_BASKET,
+													  generator));
+
+	  context.measure("onTickUpdate/instruments=" + std::to_string(instrument_count) +
+						  ",baskets=" + std::to_string(basket_count), ticks.size(), [&] {
+		for (const auto &tick : ticks) warm_pricer.provider_->publish(tick);
+	  });
+	}
+  }
+}
+
+// Per tick cost of the market open, from the first tick until every basket is ready: the bids of every instrument
+// arrive first, then the asks, then the trades, so most baskets wait for their last constituent trade. Includes
+// building the pricer.
+void marketOpen(BenchmarkContext &context) {
+  constexpr static int INSTRUMENTS = 2000;
+
+  for (const int constituents_per_basket : {16, 256}) {
+	std::mt19937 generator(42);
+	const auto files = writeSyntheticBaskets("market_open",
+											 randomBaskets(1000, 0, INSTRUMENTS, constituents_per_basket, generator),
+											 NEVER_BREACHED_THRESHOLD_PCT);
+	const pricer::BasketsComposition composition(files.basket_data_csv_, files.basket_config_csv_);
+
+	auto ticks = warmUpTicks(INSTRUMENTS);
+	std::stable_sort(ticks.begin(), ticks.end(), [](const pricer::TickEvent &lhs, const pricer::TickEvent &rhs) {
+	  return lhs.eventType_ < rhs.eventType_;
+	});
+
+	context.measure("marketOpen/baskets=1000,constituents=" + std::to_string(constituents_per_basket), ticks.size(),
+					[&] {
+					  auto provider = std::make_shared<BenchmarkMarketDataProvider>();
+					  pricer::BasketPricer basket_pricer(composition, provider);
+					  basket_pricer.initMarketDataSubscription();
+					  for (const auto &tick : ticks) provider->publish(tick);
+					});
+  }
+}
+
+// Per tick cost of the same ticks delivered one per call, then in batches, over the instrument state of 100 and
+// 10000 instruments. Through the subscribed callback, then handed to onTickBatch as a statically bound provider does.
+void tickDelivery(BenchmarkContext &context) {
+  constexpr static int CONSTITUENTS_PER_BASKET = 4;
+  constexpr static int TICK_COUNT = 300000;
+
+  for (const int instrument_count : {100, 10000}) {
+	std::mt19937 generator(42);
+	auto warm_pricer = makeWarmPricer("tick_delivery",
+									  randomBaskets(instrument_count, 0, instrument_count, CONSTITUENTS_PER_BASKET,
+													generator));
+
+	// instruments in a random order, as they tick in a market
+	auto ticks = makeTicks(TICK_COUNT, instrument_count);
+	std::vector<int> instrument_order(instrument_count);
+	for (int i = 0; i < instrument_count; i++) instrument_order[i] = i;
+	std::shuffle(instrument_order.begin(), instrument_order.end(), generator);
+	for (auto &tick : ticks) tick.instrumentId_ = instrument_order[tick.instrumentId_];
+
+	const auto name = "/instruments=" + std::to_string(instrument_count);
+	context.measure("tickDelivery/single" + name, ticks.size(), [&] {
+	  for (const auto &tick : ticks) warm_pricer.provider_->publish(tick);
+	});
+
+	for (const std::size_t batch_size : {16, 256}) {
+	  context.measure("tickDelivery/batch=" + std::to_string(batch_size) + name, ticks.size(), [&] {
+		for (std::size_t i = 0; i < ticks.size(); i += batch_size) {
+		  warm_pricer.provider_->publishBatch(
+			  std::span<const pricer::TickEvent>(ticks).subspan(i, std::min(batch_size, ticks.size() - i)));
+		}
+	  });
+	}
+
+	auto &basket_pricer = *warm_pricer.pricer_;
+	context.measure("tickDelivery/static/single" + name, ticks.size(), [&] {
+	  for (const auto &tick : ticks) basket_pricer.onTickBatch(std::span<const pricer::TickEvent>(&tick, 1), false);
+	});
+
+	for (const std::size_t batch_size : {16, 256}) {
+	  context.measure("tickDelivery/static/batch=" + std::to_string(batch_size) + name, ticks.size(), [&] {
+		for (std::size_t i = 0; i < ticks.size(); i += batch_size) {
+		  basket_pricer.onTickBatch(
+			  std::span<const pricer::TickEvent>(ticks).subspan(i, std::min(batch_size, ticks.size() - i)), false);
+		}
+	  });
+	}
+  }
+}
+
+// Per tick cost when ticks arrive in bursts sharing a timestamp - the bid, ask and trade of an instrument, then those
+// of 8 and 32 instruments - priced tick by tick then conflated per timestamp. Over 1000 instruments the instruments of
+// a burst hardly share a basket, over 100 they share most.
+void sameTimestampConflation(BenchmarkContext &context) {
+  constexpr static int CONSTITUENTS_PER_BASKET = 16;
+  constexpr static int TICK_COUNT = 300000;
+
+  for (const auto &[instruments, baskets] : {std::pair{1000, 10000}, std::pair{100, 1000}}) {
+	for (const int burst : {3, 24, 96}) {
+	  auto ticks = makeTicks(TICK_COUNT, instruments);
+	  for (std::size_t i = 0; i < ticks.size(); i++) ticks[i].event_timestamp_ = i / burst;
+
+	  for (const bool conflate : {false, true}) {
+		std::mt19937 generator(42);
+		pricer::BasketPricerConfiguration configuration;
+		configuration.conflate_same_timestamp_ = conflate;
+		auto warm_pricer = makeWarmPricer("conflation",
+										  randomBaskets(baskets, 0, instruments, CONSTITUENTS_PER_BASKET, generator),
+										  configuration);
+
+		context.measure(std::string(conflate ? "conflated" : "onTickUpdate") + "/instruments=" +
+							std::to_string(instruments) + ",burst=" + std::to_string(burst), ticks.size(), [&] {
+		  for (const auto &tick : ticks) warm_pricer.provider_->publish(tick);
+		});
+	  }
+	}
+  }
+}
+
+// Writer side, per tick cost with and without publishing the basket price snapshots, each tick updating 16 baskets
+// on average over 1000 baskets and 160 over 10000. Reader side, per basket cost of reading snapshots one at a time
+// then all at once, the pricing thread idle.
+void basketSnapshots(BenchmarkContext &context) {
+  constexpr static int INSTRUMENTS = 1000;
+  constexpr static int CONSTITUENTS_PER_BASKET = 16;
+  constexpr static int TICK_COUNT = 300000;
+  constexpr static int READ_COUNT = 1000000;
+
+  const auto ticks = makeTicks(TICK_COUNT, INSTRUMENTS);
+
+  for (const int basket_count : {1000, 10000}) {
+	const auto name = "/baskets=" + std::to_string(basket_count);
+
+	for (const bool publish : {false, true}) {
+	  std::mt19937 generator(42);
+	  pricer::BasketPricerConfiguration configuration;
+	  configuration.publish_basket_snapshots_ = publish;
+	  auto warm_pricer = makeWarmPricer("basket_snapshots",
+										randomBaskets(basket_count, 0, INSTRUMENTS, CONSTITUENTS_PER_BASKET,
+													  generator),
+										configuration);
+
+	  context.measure(std::string("onTickUpdate/snapshots=") + (publish ? "on" : "off") + name, ticks.size(), [&] {
+		for (const auto &tick : ticks) warm_pricer.provider_->publish(tick);
+	  });
+	  if (!publish) continue;
+
+	  std::vector<int> basket_ids(READ_COUNT);
+	  for (auto &basket_id : basket_ids) basket_id = static_cast<int>(generator() % basket_count);
+	  context.measure("getBasketSnapshot" + name, basket_ids.size(), [&] {
+		pricer::WeightedPriceType sum{0};
+		for (const auto &basket_id : basket_ids) sum += warm_pricer.pricer_->getBasketSnapshot(basket_id).mid_price_;
+		doNotOptimize(sum);
+	  });
+
+	  std::vector<pricer::BasketPriceSnapshot> snapshots;
+	  context.measure("getAllSnapshots" + name, basket_count, [&] {
+		warm_pricer.pricer_->getAllSnapshots(snapshots);
+		doNotOptimize(snapshots.data());
+	  });
+	}
+  }
+}
+
+// Per basket cost of a hot reload: renumbering the composition to the subscription on the calling thread, then
+// adopting it and revaluing every basket on the pricing thread, which happens on the tick following the reload
+void compositionReload(BenchmarkContext &context) {
+  constexpr static int INSTRUMENTS = 1000;
+  constexpr static int CONSTITUENTS_PER_BASKET = 16;
+
+  const auto ticks = makeTicks(1, INSTRUMENTS);
+
+  for (const int basket_count : {1000, 10000}) {
+	std::mt19937 generator(42);
+	const auto baskets = randomBaskets(basket_count, 0, INSTRUMENTS, CONSTITUENTS_PER_BASKET, generator);
+	auto warm_pricer = makeWarmPricer("composition_reload", baskets);
+
+	const auto files = writeSyntheticBaskets("composition_reload", baskets, NEVER_BREACHED_THRESHOLD_PCT);
+	const pricer::BasketsComposition composition(files.basket_data_csv_, files.basket_config_csv_);
+
+	context.measure("reloadComposition/baskets=" + std::to_string(basket_count), basket_count, [&] {
+	  warm_pricer.pricer_->reloadComposition(composition);
+	  warm_pricer.provider_->publish(ticks.front());
+	  doNotOptimize(warm_pricer.pricer_->getCompositionGeneration());
+	});
+  }
+}
+
+const BenchmarkSuiteRegistrar registrar("basket_pricer", [](BenchmarkContext &context) {
+  unrelatedBasketScaling(context);
+  basketAndInstrumentScaling(context);
+  marketOpen(context);
+  sameTimestampConflation(context);
+  tickDelivery(context);
+  basketSnapshots(context);
+  compositionReload(context);
+});
+}
+}
@@ -0,0 +1,213 @@
+#include <algorithm>
+#include <chrono>
+#include <iostream>
+#include <memory>
+#include <random>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Basket.h"
+#include "BasketPricer.h"
+#include "BasketUpdateBroadcast.h"
+#include "BenchmarkHarness.h"
+#include "BenchmarkMarketDataProvider.h"
+#include "SyntheticData.h"
+
+namespace basket::benchmark {
+namespace {
+using pricer::BasketUpdate;
+using pricer::BasketUpdateBroadcast;
+using pricer::BasketUpdateConflation;
+using pricer::BasketUpdateSubscriber;
+using pricer::BasketUpdateSubscription;
+
+constexpr static int UPDATES = 1 << 20;
+constexpr static int BASKETS = 1000;
+constexpr static std::size_t SPAN = 256;
+constexpr static std::size_t CAPACITY = 1 << 16;
+
+// the slow subscriber's callback takes this long per span of updates, far behind any writer
+constexpr static auto SLOW_CALLBACK = std::chrono::microseconds(200);
+
+// Subscribers each running run() on a thread of their own from construction until the broadcast is closed,
+// optionally joined by one deliberately slow subscriber with the same subscription
+class SubscriberThreads {
+ public:
+  SubscriberThreads(const std::shared_ptr<BasketUpdateBroadcast> &broadcast,
+					const int &subscriber_count,
+					const bool &slow_subscriber,
+					const BasketUpdateSubscription &subscription)
+	  : broadcast_(broadcast), subscription_(subscription), slow_subscriber_(slow_subscriber),
+		first_update_(broadcast->getPublishedCount()) {
+	for (int i = 0; i < subscriber_count + slow_subscriber; i++) {
+	  const bool slow = i == subscriber_count;
+	  subscribers_.push_back(std::make_unique<BasketUpdateSubscriber>(
+		  broadcast, [slow](const std::span<const BasketUpdate> &updates) {
+			doNotOptimize(updates.data());
+			if (slow) std::this_thread::sleep_for(SLOW_CALLBACK);
+		  }, subscription));
+	}
+	for (auto &subscriber : subscribers_) threads_.emplace_back([&subscriber = *subscriber] { subscriber.run(); });
+  }
+
+  SubscriberThreads() = delete;
+
+  SubscriberThreads(const SubscriberThreads &) = delete;
+
+  SubscriberThreads &operator=(const SubscriberThreads &) = delete;
+
+  SubscriberThreads(SubscriberThreads &&) noexcept = delete;
+
+  SubscriberThreads &operator=(SubscriberThreads &&) noexcept = delete;
+
+  ~SubscriberThreads() {
+	for (auto &subscriber : subscribers_) subscriber->stop();
+	join();
+  }
+
+  // Once the broadcast is closed, waits for every subscriber to read it to the end, then checks each one accounts
+  // for every update published: read or lost to the writer lapping it, and delivered as read without conflation
+  void joinAndCheck(const std::string &name) {
+	join();
+
+	// subscribers read from the next update published on
+	const auto published = broadcast_->getPublishedCount() - first_update_;
+	for (std::size_t i = 0; i < subscribers_.size(); i++) {
+	  const auto &subscriber = *subscribers_[i];
+	  const auto accounted = (subscription_.conflation_ == BasketUpdateConflation::EVERY_UPDATE)
+							 ? subscriber.getDeliveredCount() + subscriber.getGapCount()
+							 : subscriber.getReadCount() + subscriber.getGapCount();
+	  if (accounted != published) {
+		std::ostringstream oss;
+		oss << name << " subscriber " << i << " accounts for " << accounted << " of " << published << " updates";
+		throw std::runtime_error(oss.str());
+	  }
+	}
+
+	if (slow_subscriber_) {
+	  std::cout << "  " << name << ": the slow subscriber lost " << subscribers_.back()->getGapCount() << " of "
+				<< published << " updates" << std::endl;
+	}
+  }
+
+ private:
+  void join() {
+	for (auto &thread : threads_) {
+	  if (thread.joinable()) thread.join();
+	}
+  }
+
+  std::shared_ptr<BasketUpdateBroadcast> broadcast_;
+  BasketUpdateSubscription subscription_;
+  bool slow_subscriber_;
+  std::uint64_t first_update_;
+  std::vector<std::unique_ptr<BasketUpdateSubscriber>> subscribers_{};
+  std::vector<std::thread> threads_{};
+};
+
+std::string subscribersName(const int &subscriber_count, const bool &slow_subscriber) {
+  return "subscribers=" + std::to_string(subscriber_count) + (slow_subscriber ? "+slow" : "");
+}
+
+// Writer side cost per update published while every subscriber reads the broadcast on a thread of its own, the
+// pricing thread never waiting for them: a slow subscriber only loses updates. On fewer cores than threads the
+// subscribers share the writer's.
+void broadcastThroughput(BenchmarkContext &context) {
+  std::vector<BasketUpdate> updates(UPDATES);
+  for (int i = 0; i < UPDATES; i++) {
+	updates[i].basket_id_ = i % BASKETS;
+	updates[i].tick_sequence_ = i / 16;
+	updates[i].mid_price_ = 100 + i % 7;
+  }
+
+  auto publishAll = [&updates](BasketUpdateBroadcast &broadcast) {
+	for (const auto &update : updates) broadcast.publish(update);
+  };
+
+  {
+	auto broadcast = std::make_shared<BasketUpdateBroadcast>(CAPACITY);
+	context.measure("publish/subscribers=0", UPDATES, [&] { publishAll(*broadcast); });
+  }
+
+  const std::pair<std::string, BasketUpdateSubscription> subscriptions[] = {
+	  {"every_update", {BasketUpdateConflation::EVERY_UPDATE}},
+	  {"latest_per_64_ticks", {BasketUpdateConflation::LATEST_PER_TICKS, 64}},
+	  {"latest_per_1ms", {BasketUpdateConflation::LATEST_PER_INTERVAL, 0, std::chrono::milliseconds(1)}},
+  };
+
+  // subscriber count and whether a slow subscriber joins them
+  const std::pair<int, bool> subscriber_cases[] = {{1, false}, {4, false}, {16, false}, {4, true}};
+
+  for (const auto &[subscription_name, subscription] : subscriptions) {
+	for (const auto &[subscriber_count, slow_subscriber] : subscriber_cases) {
+	  auto broadcast = std::make_shared<BasketUpdateBroadcast>(CAPACITY);
+	  SubscriberThreads subscribers(broadcast, subscriber_count, slow_subscriber, subscription);
+
+	  const auto name = "publish/" + subscription_name + "/" + subscribersName(subscriber_count, slow_subscriber);
+	  context.measure(name, UPDATES, [&] { publishAll(*broadcast); });
+
+	  broadcast->close();
+	  subscribers.joinAndCheck(name);
+	}
+  }
+}
+
+// Per tick cost of a pricer broadcasting its basket updates, 16 per tick on average, with and without a slow
+// subscriber among those reading every update on threads of their own
+void pricerBroadcast(BenchmarkContext &context) {
+  constexpr static int INSTRUMENTS = 1000;
+  constexpr static int CONSTITUENTS_PER_BASKET = 16;
+  constexpr static int TICK_COUNT = 300000;
+
+  std::mt19937 generator(42);
+  const auto files = writeSyntheticBaskets("basket_update_broadcast",
+										   randomBaskets(BASKETS, 0, INSTRUMENTS, CONSTITUENTS_PER_BASKET, generator),
+										   NEVER_BREACHED_THRESHOLD_PCT);
+  const pricer::BasketsComposition composition(files.basket_data_csv_, files.basket_config_csv_);
+  const auto ticks = makeTicks(TICK_COUNT, INSTRUMENTS);
+
+  // subscriber count, -1 without a broadcast, and whether a slow subscriber joins them
+  const std::pair<int, bool> subscriber_cases[] = {{-1, false}, {0, false}, {1, false}, {4, false}, {0, true},
+												   {4, true}};
+
+  for (const auto &[subscriber_count, slow_subscriber] : subscriber_cases) {
+	pricer::BasketPricerConfiguration configuration;
+	if (subscriber_count >= 0) configuration.basket_update_broadcast_ = std::make_shared<BasketUpdateBroadcast>(CAPACITY);
+
+	auto provider = std::make_shared<BenchmarkMarketDataProvider>();
+	pricer::BasketPricer basket_pricer(composition, provider, configuration);
+	basket_pricer.initMarketDataSubscription();
+	for (const auto &tick : warmUpTicks(composition.getInstrumentCount())) provider->publish(tick);
+
+	std::unique_ptr<SubscriberThreads> subscribers;
+	if (subscriber_count >= 0) {
+	  subscribers = std::make_unique<SubscriberThreads>(configuration.basket_update_broadcast_, subscriber_count,
+														slow_subscriber,
+														BasketUpdateSubscription{BasketUpdateConflation::EVERY_UPDATE});
+	}
+
+	const auto name = "onTickUpdate/" + (subscriber_count < 0 ? std::string("no_broadcast")
+																: subscribersName(subscriber_count, slow_subscriber));
+	context.measure(name, ticks.size(), [&] {
+	  const std::span<const pricer::TickEvent> all_ticks(ticks);
+	  for (std::size_t i = 0; i < all_ticks.size(); i += SPAN) {
+		provider->publishBatch(all_ticks.subspan(i, std::min(SPAN, all_ticks.size() - i)));
+	  }
+	});
+
+	// closes the broadcast
+	basket_pricer.stop();
+	if (subscribers) subscribers->joinAndCheck(name);
+  }
+}
+
+const BenchmarkSuiteRegistrar registrar("basket_update_broadcast", [](BenchmarkContext &context) {
+  broadcastThroughput(context);
+  pricerBroadcast(context);
+});
+}
+}
@@ -0,0 +1,104 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <ostream>
+#include <string>
+#include <vector>
+
+namespace basket::benchmark {
+
+struct BenchmarkResult {
+  std::string suite_{};
+  std::string name_{};
+  std::uint64_t operations_{0};
+  double best_ns_{0};
+  double median_ns_{0};
+
+  [[nodiscard]] double nsPerOperation() const {
+	return operations_ ? best_ns_ / operations_ : 0;
+  }
+
+  [[nodiscard]] double operationsPerSecond() const {
+	return best_ns_ > 0 ? operations_ * 1e9 / best_ns_ : 0;
+  }
+};
+
+template<typename T>
+inline void doNotOptimize(const T &value) {
+  asm volatile("" : : "r,m"(value) : "memory");
+}
+
+class BenchmarkContext {
+ public:
+  explicit BenchmarkContext(const int &repetitions) : repetitions_(repetitions) {}
+
+  void setSuite(const std::string &suite) {
+	suite_ = suite;
+  }
+
+  // body performs `operations` units of work per call, one untimed warm up call precedes the timed ones
+  template<typename F>
+  const BenchmarkResult &measure(const std::string &name, const std::uint64_t &operations, F &&body) {
+	body();
+
+	std::vector<double> samples;
+	samples.reserve(repetitions_);
+	for (int i = 0; i < repetitions_; i++) {
+	  const auto start = std::chrono::steady_clock::now();
+	  body();
+	  const auto end = std::chrono::steady_clock::now();
+	  samples.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+	}
+
+	return record(name, operations, std::move(samples));
+  }
+
+  // body returns the units of work it performed, for workloads whose size is only known afterwards
+  template<typename F>
+  const BenchmarkResult &measureCounted(const std::string &name, F &&body) {
+	body();
+
+	std::vector<double> samples;
+	std::uint64_t operations{0};
+	samples.reserve(repetitions_);
+	for (int i = 0; i < repetitions_; i++) {
+	  const auto start = std::chrono::steady_clock::now();
+	  const std::uint64_t performed = body();
+	  const auto end = std::chrono::steady_clock::now();
+	  if (performed == 0) continue;
+
+	  // samples normalised to the work of the first timed call
+	  if (operations == 0) operations = performed;
+	  samples.push_back(std::chrono::duration<double, std::nano>(end - start).count() * operations / performed);
+	}
+	if (samples.empty()) samples.push_back(0);
+
+	return record(name, operations, std::move(samples));
+  }
+
+  [[nodiscard]] const std::vector<BenchmarkResult> &getResults() const {
+	return results_;
+  }
+
+ private:
+  const BenchmarkResult &record(const std::string &name, const std::uint64_t &operations, std::vector<double> &&samples);
+
+  int repetitions_{1};
+  std::string suite_{};
+  std::vector<BenchmarkResult> results_{};
+};
+
+// machine readable reports, one row per measurement
+void writeJsonReport(std::ostream &os, const std::vector<BenchmarkResult> &results);
+
+void writeCsvReport(std::ostream &os, const std::vector<BenchmarkResult> &results);
+
+using BenchmarkSuiteFunc = std::function<void(BenchmarkContext &context)>;
+
+struct BenchmarkSuiteRegistrar {
+  BenchmarkSuiteRegistrar(const std::string &name, BenchmarkSuiteFunc &&suite);
+};
+
+}
@@ -0,0 +1,40 @@
+#pragma once
+
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "IMarketDataProvider.h"
+#include "TickEvent.h"
+
+namespace basket::benchmark {
+
+// Hands ticks prepared by a benchmark straight to the subscriber
+class BenchmarkMarketDataProvider : public pricer::IMarketDataProvider {
+ public:
+  void subscribeBatch(BatchCallbackFunc &&callback, std::vector<std::string> &&instrumentList) override {
+	callback_ = std::move(callback);
+	instrument_list_ = std::move(instrumentList);
+  }
+
+  void run() override {}
+
+  // one tick per batch
+  inline void publish(const pricer::TickEvent &tickEvent) {
+	callback_(std::span<const pricer::TickEvent>(&tickEvent, 1), false);
+  }
+
+  inline void publishBatch(const std::span<const pricer::TickEvent> &ticks, const bool &endOfBatch = false) {
+	callback_(ticks, endOfBatch);
+  }
+
+  [[nodiscard]] const std::vector<std::string> &getInstrumentList() const {
+	return instrument_list_;
+  }
+
+ private:
+  std::vector<std::string> instrument_list_{};
+};
+
+}
@@ -0,0 +1,52 @@
+#include <random>
+#include <string>
+
+#include "Basket.h"
+#include "BenchmarkHarness.h"
+#include "CSVReader.h"
+#include "SyntheticData.h"
+
+namespace basket::benchmark {
+namespace {
+constexpr static int INSTRUMENTS = 1000;
+constexpr static int CONSTITUENTS_PER_BASKET = 20;
+
+// Rows per second of the basket data csv, read raw - copied or streamed in place - and loaded into a composition,
+// against mapping the same composition from a snapshot
+const BenchmarkSuiteRegistrar registrar("csv_loading", [](BenchmarkContext &context) {
+  for (const int basket_count : {1000, 10000, 50000}) {
+	std::mt19937 generator(7);
+	const auto files = writeSyntheticBaskets("csv_loading_" + std::to_string(basket_count),
+											 randomBaskets(basket_count, 0, INSTRUMENTS, CONSTITUENTS_PER_BASKET,
+														   generator),
+											 NEVER_BREACHED_THRESHOLD_PCT);
+	const auto rows = static_cast<std::uint64_t>(basket_count) * CONSTITUENTS_PER_BASKET;
+
+	context.measure("CSVReader::getData/rows=" + std::to_string(rows), rows, [&] {
+	  doNotOptimize(pricer::CSVReader(files.basket_data_csv_).getData().size());
+	});
+
+	context.measure("CSVReader::forEachRow/rows=" + std::to_string(rows), rows, [&] {
+	  std::size_t fields{0};
+	  pricer::CSVReader(files.basket_data_csv_).forEachRow([&fields](const pricer::CSVReader::RowView &row) {
+		fields += row.size();
+	  });
+	  doNotOptimize(fields);
+	});
+
+	context.measure("BasketsComposition/rows=" + std::to_string(rows), rows, [&] {
+	  pricer::BasketsComposition composition(files.basket_data_csv_, files.basket_config_csv_);
+	  doNotOptimize(composition.getInstrumentCount());
+	});
+
+	const auto snapshot_path = files.basket_data_csv_ + ".snapshot";
+	pricer::BasketsComposition(files.basket_data_csv_, files.basket_config_csv_).writeSnapshot(snapshot_path);
+
+	context.measure("BasketsComposition::loadSnapshot/rows=" + std::to_string(rows), rows, [&] {
+	  const auto composition = pricer::BasketsComposition::loadSnapshot(snapshot_path);
+	  doNotOptimize(composition.getInstrumentCount());
+	});
+  }
+});
+}
+}
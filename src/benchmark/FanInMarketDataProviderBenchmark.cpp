@@ -0,0 +1,82 @@
+#include <memory>
+#include <span>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "BenchmarkHarness.h"
+#include "FanInMarketDataProvider.h"
+
+namespace basket::benchmark {
+namespace {
+using pricer::FanInMarketDataProvider;
+using pricer::MarketDataSource;
+using pricer::TickEvent;
+
+constexpr static int TICKS = 1 << 20;
+constexpr static int INSTRUMENTS = 1024;
+constexpr static std::size_t SPAN = 64;
+
+// publishes its share of the ticks from run(), as a venue feed thread would
+class ReplayingSource : public pricer::IMarketDataProvider {
+ public:
+  explicit ReplayingSource(std::vector<TickEvent> &&ticks) : ticks_(std::move(ticks)) {}
+
+  void subscribeBatch(BatchCallbackFunc &&callback, std::vector<std::string> &&) override {
+	callback_ = std::move(callback);
+  }
+
+  void run() override {
+	const std::span<const TickEvent> ticks(ticks_);
+	for (std::size_t i = 0; i < ticks.size(); i += SPAN) callback_(ticks.subspan(i, std::min(SPAN, ticks.size() - i)), true);
+  }
+
+ private:
+  std::vector<TickEvent> ticks_;
+};
+
+std::vector<std::string> makeInstrumentList() {
+  std::vector<std::string> instrumentList;
+  for (int i = 0; i < INSTRUMENTS; i++) instrumentList.push_back("I" + std::to_string(i));
+  return instrumentList;
+}
+
+// Delivery cost per tick merged from 1 to 4 source threads onto a subscriber which only counts them, queues and
+// source threads set up included.
+void fanInThroughput(BenchmarkContext &context) {
+  const auto instrumentList = makeInstrumentList();
+  std::uint64_t delivered{0};
+  auto count = [&delivered](const std::span<const TickEvent> &ticks, const bool &) { delivered += ticks.size(); };
+
+  // every source ticks its own instruments, source s those with s == instrument id % sources
+  auto makeSources = [&instrumentList](const int &source_count) {
+	std::vector<MarketDataSource> sources;
+	for (int s = 0; s < source_count; s++) {
+	  std::vector<TickEvent> ticks;
+	  std::vector<std::string> instruments;
+	  for (int i = s; i < INSTRUMENTS; i += source_count) instruments.push_back(instrumentList[i]);
+	  for (int i = 0; i < TICKS / source_count; i++) {
+		ticks.emplace_back(i, 100 + i % 7, pricer::TickEventType::BID, i % instruments.size());
+	  }
+	  sources.push_back({"source" + std::to_string(s), std::make_shared<ReplayingSource>(std::move(ticks)),
+						 std::move(instruments)});
+	}
+	return sources;
+  };
+
+  for (const int source_count : {1, 2, 4}) {
+	const auto sources = makeSources(source_count);
+	context.measure("fan_in/sources=" + std::to_string(source_count), TICKS, [&] {
+	  FanInMarketDataProvider fanIn{std::vector<MarketDataSource>(sources)};
+	  fanIn.subscribeBatch(count, std::vector<std::string>(instrumentList));
+	  fanIn.run();
+	});
+  }
+  doNotOptimize(delivered);
+}
+
+const BenchmarkSuiteRegistrar registrar("fan_in", [](BenchmarkContext &context) {
+  fanInThroughput(context);
+});
+}
+}
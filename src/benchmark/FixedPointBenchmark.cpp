@@ -0,0 +1,206 @@
+#include <cmath>
+#include <cstdint>
+#include <iomanip>
+#include <iostream>
+#include <random>
+#include <vector>
+
+#include "BenchmarkHarness.h"
+
+#include "base/fixed_point.h"
+
+namespace basket::benchmark {
+namespace {
+using pricer::PriceType;
+using pricer::WeightType;
+using pricer::WeightedPriceType;
+
+constexpr static int INSTRUMENTS = 256;
+constexpr static int BASKETS = 1024;
+constexpr static int CONSTITUENTS_PER_BASKET = 16;
+constexpr static int UPDATES = 1000000;
+constexpr static double THRESHOLD_PCT = 0.5;
+
+struct PriceUpdate {
+  int instrument_;
+  PriceType price_;
+};
+
+// Random composition in instrument -> (basket, weight) form, as walked by the pricer hot path,
+// and a random walk of 0.01 tick moves over all instruments
+struct Workload {
+  std::vector<int> offsets_{};
+  std::vector<int> baskets_{};
+  std::vector<double> weights_{};
+  std::vector<PriceType> initial_prices_{};
+  std::vector<PriceUpdate> updates_{};
+};
+
+Workload makeWorkload() {
+  std::mt19937 generator(7);
+  std::uniform_int_distribution<int> instrument_draw(0, INSTRUMENTS - 1);
+  std::uniform_int_distribution<int> move_draw(-3, 3);
+  std::uniform_real_distribution<double> weight_draw(0.01, 1.0);
+
+  std::vector<std::vector<std::pair<int, double>>> instrument_baskets(INSTRUMENTS);
+  for (int basket = 0; basket < BASKETS; basket++) {
+	for (int i = 0; i < CONSTITUENTS_PER_BASKET; i++) {
+	  // weights with 6 decimals as typically configured in basket data files
+	  const double weight = std::round(weight_draw(generator) * 1e6) / 1e6;
+	  instrument_baskets[instrument_draw(generator)].emplace_back(basket, weight);
+	}
+  }
+
+  Workload workload;
+  workload.offsets_.push_back(0);
+  for (const auto &baskets : instrument_baskets) {
+	for (const auto &[basket, weight] : baskets) {
+	  workload.baskets_.push_back(basket);
+	  workload.weights_.push_back(weight);
+	}
+	workload.offsets_.push_back(static_cast<int>(workload.baskets_.size()));
+  }
+
+  constexpr PriceType CENT = pricer::PRICE_SCALE / 100;
+  workload.initial_prices_.assign(INSTRUMENTS, 100 * pricer::PRICE_SCALE);
+
+  auto prices = workload.initial_prices_;
+  for (int i = 0; i < UPDATES; i++) {
+	const auto instrument = instrument_draw(generator);
+	prices[instrument] += move_draw(generator) * CENT;
+	workload.updates_.push_back({instrument, prices[instrument]});
+  }
+  return workload;
+}
+
+// prev + (new - old) * weight in double, as the pricer computed it before moving to fixed point
+struct DoubleKernel {
+  explicit DoubleKernel(const Workload &workload) : workload_(workload) {
+	for (const auto &weight : workload.weights_) weights_.push_back(weight);
+  }
+
+  std::uint64_t run() {
+	std::vector<double> prices(INSTRUMENTS);
+	for (int i = 0; i < INSTRUMENTS; i++) prices[i] = pricer::priceToDouble(workload_.initial_prices_[i]);
+	basket_prices_ = initialBasketPrices(prices);
+
+	std::uint64_t breaches{0};
+	for (const auto &update : workload_.updates_) {
+	  const double new_price = pricer::priceToDouble(update.price_);
+	  const double delta = new_price - prices[update.instrument_];
+	  prices[update.instrument_] = new_price;
+
+	  for (int i = workload_.offsets_[update.instrument_]; i < workload_.offsets_[update.instrument_ + 1]; i++) {
+		double &basket_price = basket_prices_[workload_.baskets_[i]];
+		const double prev_price = basket_price;
+		basket_price = prev_price + delta * weights_[i];
+		breaches += (std::fabs(basket_price - prev_price) / prev_price) * 100.0 > THRESHOLD_PCT;
+	  }
+	}
+	final_prices_ = prices;
+	return breaches;
+  }
+
+  std::vector<double> initialBasketPrices(const std::vector<double> &prices) const {
+	std::vector<double> basket_prices(BASKETS);
+	for (int instrument = 0; instrument < INSTRUMENTS; instrument++) {
+	  for (int i = workload_.offsets_[instrument]; i < workload_.offsets_[instrument + 1]; i++) {
+		basket_prices[workload_.baskets_[i]] += prices[instrument] * weights_[i];
+	  }
+	}
+	return basket_prices;
+  }
+
+  // largest gap between the incrementally maintained basket and a full revaluation
+  double drift() const {
+	const auto revalued = initialBasketPrices(final_prices_);
+	double max_drift{0};
+	for (int basket = 0; basket < BASKETS; basket++) {
+	  max_drift = std::fmax(max_drift, std::fabs(revalued[basket] - basket_prices_[basket]));
+	}
+	return max_drift;
+  }
+
+  const Workload &workload_;
+  std::vector<double> weights_{};
+  std::vector<double> basket_prices_{};
+  std::vector<double> final_prices_{};
+};
+
+// the same update in the fixed point domain the pricer works in now
+struct FixedPointKernel {
+  explicit FixedPointKernel(const Workload &workload) : workload_(workload) {
+	for (const auto &weight : workload.weights_) weights_.push_back(pricer::toWeight(weight));
+  }
+
+  std::uint64_t run() {
+	std::vector<PriceType> prices = workload_.initial_prices_;
+	basket_prices_ = initialBasketPrices(prices);
+
+	const auto threshold = pricer::toThreshold(THRESHOLD_PCT);
+
+	std::uint64_t breaches{0};
+	for (const auto &update : workload_.updates_) {
+	  const PriceType delta = update.price_ - prices[update.instrument_];
+	  prices[update.instrument_] = update.price_;
+
+	  for (int i = workload_.offsets_[update.instrument_]; i < workload_.offsets_[update.instrument_ + 1]; i++) {
+		WeightedPriceType &basket_price = basket_prices_[workload_.baskets_[i]];
+		const WeightedPriceType prev_price = basket_price;
+		basket_price = prev_price + delta * weights_[i];
+		breaches += pricer::isThresholdBreached(prev_price, basket_price, threshold);
+	  }
+	}
+	final_prices_ = prices;
+	return breaches;
+  }
+
+  std::vector<WeightedPriceType> initialBasketPrices(const std::vector<PriceType> &prices) const {
+	std::vector<WeightedPriceType> basket_prices(BASKETS);
+	for (int instrument = 0; instrument < INSTRUMENTS; instrument++) {
+	  for (int i = workload_.offsets_[instrument]; i < workload_.offsets_[instrument + 1]; i++) {
+		basket_prices[workload_.baskets_[i]] += prices[instrument] * weights_[i];
+	  }
+	}
+	return basket_prices;
+  }
+
+  double drift() const {
+	const auto revalued = initialBasketPrices(final_prices_);
+	WeightedPriceType max_drift{0};
+	for (int basket = 0; basket < BASKETS; basket++) {
+	  max_drift = std::max(max_drift, std::abs(revalued[basket] - basket_prices_[basket]));
+	}
+	return pricer::weightedPriceToDouble(max_drift);
+  }
+
+  const Workload &workload_;
+  std::vector<WeightType> weights_{};
+  std::vector<WeightedPriceType> basket_prices_{};
+  std::vector<PriceType> final_prices_{};
+};
+
+// before / after comparison of the incremental basket revaluation in the pricer hot path
+void incrementalRevaluation(BenchmarkContext &context) {
+  const auto workload = makeWorkload();
+
+  DoubleKernel double_kernel(workload);
+  context.measure("incremental_update/double", workload.updates_.size(), [&] {
+	doNotOptimize(double_kernel.run());
+  });
+
+  FixedPointKernel fixed_point_kernel(workload);
+  context.measure("incremental_update/fixed_point", workload.updates_.size(), [&] {
+	doNotOptimize(fixed_point_kernel.run());
+  });
+
+  std::cout << std::scientific << std::setprecision(3)
+			<< "  max basket drift after " << UPDATES << " updates - double " << double_kernel.drift()
+			<< ", fixed point " << fixed_point_kernel.drift() << std::endl;
+}
+
+const BenchmarkSuiteRegistrar registrar("fixed_point", [](BenchmarkContext &context) {
+  incrementalRevaluation(context);
+});
+}
+}
@@ -0,0 +1,44 @@
+#include <cstdint>
+#include <random>
+#include <vector>
+
+#include "BenchmarkHarness.h"
+#include "LatencyHistogram.h"
+#include "TickLatencyRecorder.h"
+
+#include "base/latency_clock.h"
+
+namespace basket::benchmark {
+namespace {
+using pricer::LatencyClock;
+using pricer::LatencyHistogram;
+
+constexpr static int OPERATIONS = 1000000;
+
+// What BASKET_LATENCY_HISTOGRAM adds to every tick: two clock reads and a histogram record
+const BenchmarkSuiteRegistrar registrar("latency_histogram", [](BenchmarkContext &context) {
+  context.measure("LatencyClock::now", OPERATIONS, [] {
+	for (int i = 0; i < OPERATIONS; i++) doNotOptimize(LatencyClock::now());
+  });
+
+  std::mt19937_64 generator(42);
+  std::lognormal_distribution<double> latency_draw(6.0, 1.0);
+  std::vector<std::uint64_t> latencies(OPERATIONS);
+  for (auto &latency : latencies) latency = static_cast<std::uint64_t>(latency_draw(generator));
+
+  LatencyHistogram histogram;
+  context.measure("LatencyHistogram::record", OPERATIONS, [&] {
+	for (const auto &latency : latencies) histogram.record(latency);
+  });
+  doNotOptimize(histogram.getValueAtPercentile(99.9));
+
+  pricer::TickLatencyRecorder recorder;
+  context.measure("TickLatencyRecorder::start+record", OPERATIONS, [&] {
+	for (int i = 0; i < OPERATIONS; i++) {
+	  const auto start = recorder.start();
+	  recorder.record(start, pricer::TickEventType::TRADE, i & 1);
+	}
+  });
+});
+}
+}
@@ -0,0 +1,77 @@
+#include <algorithm>
+#include <memory>
+#include <random>
+#include <span>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Basket.h"
+#include "BasketPricer.h"
+#include "BenchmarkHarness.h"
+#include "BenchmarkMarketDataProvider.h"
+#include "ShardedBasketPricer.h"
+#include "SyntheticData.h"
+
+namespace basket::benchmark {
+namespace {
+constexpr static int INSTRUMENTS = 1000;
+constexpr static int BASKETS = 8000;
+constexpr static int CONSTITUENTS_PER_BASKET = 16;
+constexpr static int TICK_COUNT = 200000;
+
+// Ticks per second priced from 1 shard up to one shard per hardware thread, next to the unsharded pricer.
+// Every tick fans out to ~128 baskets.
+void shardScaling(BenchmarkContext &context) {
+  std::mt19937 generator(42);
+  const auto files = writeSyntheticBaskets("sharded_scaling",
+										   randomBaskets(BASKETS, 0, INSTRUMENTS, CONSTITUENTS_PER_BASKET, generator),
+										   NEVER_BREACHED_THRESHOLD_PCT);
+  const pricer::BasketsComposition composition(files.basket_data_csv_, files.basket_config_csv_);
+
+  const auto warm_up = warmUpTicks(composition.getInstrumentCount());
+  const auto ticks = makeTicks(TICK_COUNT, composition.getInstrumentCount());
+
+  {
+	auto provider = std::make_shared<BenchmarkMarketDataProvider>();
+	pricer::BasketPricer basket_pricer(composition, provider);
+	basket_pricer.initMarketDataSubscription();
+	for (const auto &tick : warm_up) provider->publish(tick);
+
+	context.measure("unsharded", ticks.size(), [&] {
+	  for (const auto &tick : ticks) provider->publish(tick);
+	});
+  }
+
+  const int hardware_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  for (int shard_count = 1; shard_count <= std::max(2, hardware_threads); shard_count *= 2) {
+	pricer::ShardedBasketPricerConfiguration configuration;
+	configuration.shard_count_ = shard_count;
+
+	auto provider = std::make_shared<BenchmarkMarketDataProvider>();
+	pricer::ShardedBasketPricer sharded_pricer(composition, provider, configuration);
+	sharded_pricer.initMarketDataSubscription();
+	for (const auto &tick : warm_up) provider->publish(tick);
+	sharded_pricer.waitUntilPriced();
+
+	context.measure("shards=" + std::to_string(shard_count), ticks.size(), [&] {
+	  for (const auto &tick : ticks) provider->publish(tick);
+	  sharded_pricer.waitUntilPriced();
+	});
+
+	// each shard queues its share of a batch at once
+	context.measure("shards=" + std::to_string(shard_count) + "/batch=64", ticks.size(), [&] {
+	  const std::span<const pricer::TickEvent> all_ticks(ticks);
+	  for (std::size_t i = 0; i < all_ticks.size(); i += 64) {
+		provider->publishBatch(all_ticks.subspan(i, std::min<std::size_t>(64, all_ticks.size() - i)), true);
+	  }
+	  sharded_pricer.waitUntilPriced();
+	});
+  }
+}
+
+const BenchmarkSuiteRegistrar registrar("sharded_pricer", [](BenchmarkContext &context) {
+  shardScaling(context);
+});
+}
+}
@@ -0,0 +1,90 @@
+#include <span>
+#include <string>
+#include <vector>
+
+#include "BenchmarkHarness.h"
+#include "SharedMemoryMarketDataProvider.h"
+#include "SharedMemoryTickRing.h"
+
+namespace basket::benchmark {
+namespace {
+using pricer::OverflowPolicy;
+using pricer::SharedMemoryMarketDataProvider;
+using pricer::SharedMemoryTickRingConfiguration;
+using pricer::SharedMemoryTickWriter;
+using pricer::TickEvent;
+
+constexpr static int TICKS = 1 << 20;
+constexpr static int INSTRUMENTS = 256;
+constexpr static std::size_t SPAN = 64;
+constexpr static char RING_NAME[] = "/basket_benchmark_ticks";
+
+std::vector<TickEvent> makeTicks() {
+  std::vector<TickEvent> ticks(TICKS);
+  for (int i = 0; i < TICKS; i++) {
+	ticks[i] = TickEvent(i / 16, 100 + i % 7, pricer::TickEventType::BID, i % INSTRUMENTS);
+  }
+  return ticks;
+}
+
+std::vector<std::string> makeInstrumentList() {
+  std::vector<std::string> instrumentList;
+  for (int i = 0; i < INSTRUMENTS; i++) instrumentList.push_back("I" + std::to_string(i));
+  return instrumentList;
+}
+
+// Ring overhead per tick, both ends in one thread so the figures leave out the cross-core cache line transfers a
+// reader process on another core adds
+void ringRoundTrip(BenchmarkContext &context) {
+  const auto ticks = makeTicks();
+  const std::span<const TickEvent> all_ticks(ticks);
+
+  SharedMemoryTickRingConfiguration configuration;
+  configuration.capacity_ = 1 << 12;
+  configuration.overflow_policy_ = OverflowPolicy::DROP_OLDEST;
+  SharedMemoryTickWriter writer(RING_NAME, makeInstrumentList(), configuration);
+
+  context.measure("write/no_reader/span=64", TICKS, [&] {
+	for (std::size_t i = 0; i < all_ticks.size(); i += SPAN) writer.write(all_ticks.subspan(i, SPAN), true);
+  });
+
+  SharedMemoryMarketDataProvider provider(RING_NAME);
+  std::uint64_t delivered{0};
+  provider.subscribeBatch([&delivered](const std::span<const TickEvent> &batch, const bool &) {
+	delivered += batch.size();
+  }, makeInstrumentList());
+
+  context.measure("write_then_poll/span=64", TICKS, [&] {
+	for (std::size_t i = 0; i < all_ticks.size(); i += SPAN) {
+	  writer.write(all_ticks.subspan(i, SPAN), true);
+	  provider.poll();
+	}
+  });
+  doNotOptimize(delivered);
+
+  // lossless, with two attached readers the writer must not lap
+  configuration.overflow_policy_ = OverflowPolicy::SPIN;
+  SharedMemoryTickWriter lossless_writer(std::string(RING_NAME) + "_lossless", makeInstrumentList(), configuration);
+  SharedMemoryMarketDataProvider first_reader(std::string(RING_NAME) + "_lossless");
+  SharedMemoryMarketDataProvider second_reader(std::string(RING_NAME) + "_lossless");
+  for (auto *reader : {&first_reader, &second_reader}) {
+	reader->subscribeBatch([&delivered](const std::span<const TickEvent> &batch, const bool &) {
+	  delivered += batch.size();
+	}, makeInstrumentList());
+  }
+
+  context.measure("write_then_poll/spin/2_readers", TICKS, [&] {
+	for (std::size_t i = 0; i < all_ticks.size(); i += SPAN) {
+	  lossless_writer.write(all_ticks.subspan(i, SPAN), true);
+	  first_reader.poll();
+	  second_reader.poll();
+	}
+  });
+  doNotOptimize(delivered);
+}
+
+const BenchmarkSuiteRegistrar registrar("shared_memory_ring", [](BenchmarkContext &context) {
+  ringRoundTrip(context);
+});
+}
+}
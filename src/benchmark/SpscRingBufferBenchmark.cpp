@@ -0,0 +1,124 @@
+#include <atomic>
+#include <condition_variable>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BasketPricer.h"
+#include "BenchmarkHarness.h"
+#include "SpscRingBuffer.h"
+
+namespace basket::benchmark {
+namespace {
+using pricer::ConsumerWaitPolicy;
+using pricer::OverflowPolicy;
+using pricer::SpscRingBuffer;
+using pricer::ThresholdEvent;
+
+constexpr static int EVENTS = 1000000;
+constexpr static std::size_t CAPACITY = 1 << 14;
+
+ThresholdEvent makeEvent(const int &i) {
+  return ThresholdEvent{i, pricer::TickEventType::TRADE, 100, 101, 1.0};
+}
+
+// the producer side of the breach hand off before the ring: lock, push into a vector, notify
+struct MutexQueue {
+  std::mutex mutex_{};
+  std::condition_variable cv_{};
+  std::vector<ThresholdEvent> events_{};
+  bool closed_{false};
+
+  void push(const ThresholdEvent &event) {
+	std::lock_guard<std::mutex> lg(mutex_);
+	events_.push_back(event);
+	cv_.notify_one();
+  }
+
+  void consume() {
+	std::vector<ThresholdEvent> outstanding;
+	while (true) {
+	  std::unique_lock<std::mutex> ul(mutex_);
+	  cv_.wait(ul, [this] { return !events_.empty() || closed_; });
+	  if (closed_) return;
+	  outstanding.swap(events_);
+	  ul.unlock();
+	  doNotOptimize(outstanding.data());
+	  outstanding.clear();
+	}
+  }
+
+  void close() {
+	std::lock_guard<std::mutex> lg(mutex_);
+	closed_ = true;
+	cv_.notify_one();
+  }
+};
+
+void measureRing(BenchmarkContext &context,
+				 const std::string &name,
+				 const OverflowPolicy &overflowPolicy,
+				 const ConsumerWaitPolicy &waitPolicy,
+				 const bool &with_consumer,
+				 const std::size_t &batch_size = 1) {
+  SpscRingBuffer<ThresholdEvent> ring(CAPACITY, overflowPolicy, waitPolicy);
+
+  std::thread consumer;
+  if (with_consumer) {
+	consumer = std::thread([&ring] {
+	  ThresholdEvent event;
+	  while (!ring.isClosed()) {
+		ring.waitForData();
+		while (ring.tryPop(event)) doNotOptimize(event);
+	  }
+	});
+  }
+
+  std::vector<ThresholdEvent> batch(batch_size);
+  context.measure(name, EVENTS, [&] {
+	if (batch_size == 1) {
+	  for (int i = 0; i < EVENTS; i++) ring.push(makeEvent(i));
+	  return;
+	}
+	for (int i = 0; i < EVENTS; i += static_cast<int>(batch_size)) {
+	  for (std::size_t j = 0; j < batch_size; j++) batch[j] = makeEvent(i + static_cast<int>(j));
+	  ring.pushBatch(batch);
+	}
+  });
+
+  ring.close();
+  if (consumer.joinable()) consumer.join();
+}
+
+// Producer side cost of publishing a breach, with and without a consumer draining concurrently
+void producerLatency(BenchmarkContext &context) {
+  measureRing(context, "push/no_consumer/drop_newest", OverflowPolicy::DROP_NEWEST, ConsumerWaitPolicy::PARK, false);
+  measureRing(context, "push/no_consumer/drop_oldest", OverflowPolicy::DROP_OLDEST, ConsumerWaitPolicy::PARK, false);
+  measureRing(context, "push/busy_poll_consumer/spin", OverflowPolicy::SPIN, ConsumerWaitPolicy::BUSY_POLL, true);
+  measureRing(context, "push/parked_consumer/spin", OverflowPolicy::SPIN, ConsumerWaitPolicy::PARK, true);
+  measureRing(context, "push/parked_consumer/drop_oldest", OverflowPolicy::DROP_OLDEST, ConsumerWaitPolicy::PARK, true);
+  // one publication, hence one check for a parked consumer, per batch
+  measureRing(context, "push_batch=64/parked_consumer/spin", OverflowPolicy::SPIN, ConsumerWaitPolicy::PARK, true, 64);
+  measureRing(context, "push_batch=64/parked_consumer/drop_oldest", OverflowPolicy::DROP_OLDEST,
+			  ConsumerWaitPolicy::PARK, true, 64);
+
+  MutexQueue queue;
+  context.measure("mutex_vector/no_consumer", EVENTS, [&] {
+	for (int i = 0; i < EVENTS; i++) queue.push(makeEvent(i));
+	queue.events_.clear();
+  });
+
+  std::thread consumer([&queue] { queue.consume(); });
+  context.measure("mutex_vector/consumer", EVENTS, [&] {
+	for (int i = 0; i < EVENTS; i++) queue.push(makeEvent(i));
+  });
+  queue.close();
+  consumer.join();
+}
+
+const BenchmarkSuiteRegistrar registrar("spsc_ring", [](BenchmarkContext &context) {
+  producerLatency(context);
+});
+}
+}
@@ -0,0 +1,126 @@
+#include "SyntheticData.h"
+
+#include <algorithm>
+#include <cstdio>
+#include <filesystem>
+#include <fstream>
+#include <iterator>
+
+namespace basket::benchmark {
+namespace {
+using pricer::TickEvent;
+using pricer::TickEventType;
+
+constexpr static pricer::PriceType CENT = pricer::PRICE_SCALE / 100;
+constexpr static TickEventType EVENT_TYPES[] = {TickEventType::BID, TickEventType::ASK, TickEventType::TRADE};
+constexpr static pricer::PriceType BASE_PRICES[] = {10000 * CENT, 10002 * CENT, 10001 * CENT};
+
+std::filesystem::path syntheticDataDirectory() {
+  auto directory = std::filesystem::temp_directory_path() / "basket_benchmarks";
+  std::filesystem::create_directories(directory);
+  return directory;
+}
+
+std::string syntheticBasketName(const int &basket) {
+  char name[16];
+  std::snprintf(name, sizeof(name), "SB%07d", basket);
+  return name;
+}
+}
+
+std::string syntheticInstrumentName(const int &instrument) {
+  char name[16];
+  std::snprintf(name, sizeof(name), "SI%07d", instrument);
+  return name;
+}
+
+SyntheticBasketFiles writeSyntheticBaskets(const std::string &tag,
+										   const std::vector<std::vector<int>> &basket_constituents,
+										   const double &threshold_pct) {
+  const auto directory = syntheticDataDirectory();
+
+  SyntheticBasketFiles files;
+  files.basket_data_csv_ = directory / (tag + "_basket_data.csv");
+  files.basket_config_csv_ = directory / (tag + "_basket_config.csv");
+
+  std::ofstream data(files.basket_data_csv_);
+  std::ofstream config(files.basket_config_csv_);
+
+  data << "Basket ID,Basket Item ID,Weight\n";
+  config << "Basket ID,LastPrice Threshold,MidPrice Threshold\n";
+
+  for (int basket = 0; basket < basket_constituents.size(); basket++) {
+	const auto &constituents = basket_constituents[basket];
+	const auto basket_name = syntheticBasketName(basket);
+
+	for (const auto &instrument : constituents) {
+	  data << basket_name << ',' << syntheticInstrumentName(instrument) << ',' << (1.0 / constituents.size()) << '\n';
+	}
+	config << basket_name << ',' << threshold_pct << ',' << threshold_pct << '\n';
+  }
+
+  return files;
+}
+
+std::string writeSyntheticSimulationConfig(const std::string &tag,
+										   const int &instrument_count,
+										   const int &mean_event_interval,
+										   const int &model_shapes) {
+  const auto path = syntheticDataDirectory() / (tag + "_instrument_simulation.cfg");
+
+  std::ofstream cfg(path);
+  for (int instrument = 0; instrument < instrument_count; instrument++) {
+	const int shape = instrument % std::clamp(model_shapes, 1, 4);
+
+	cfg << syntheticInstrumentName(instrument) << '\n';
+	if (shape % 2 == 0) {
+	  cfg << "poisson_distribution," << mean_event_interval << '\n';
+	} else {
+	  cfg << "uniform_int_distribution,1," << 2 * mean_event_interval - 1 << '\n';
+	}
+	cfg << "uniform_real_distribution," << 50 + instrument % 50 << ',' << 51 + instrument % 50 << '\n'
+		<< "uniform_real_distribution,0,1\n"
+		<< (shape < 2 ? "uniform_int_distribution,1,15\n" : "poisson_distribution,4\n")
+		<< "30\n";
+  }
+  return path;
+}
+
+std::vector<std::vector<int>> randomBaskets(const int &basket_count,
+											const int &first_instrument,
+											const int &instrument_count,
+											const int &constituents_per_basket,
+											std::mt19937 &generator) {
+  std::vector<int> universe(instrument_count);
+  for (int i = 0; i < instrument_count; i++) universe[i] = first_instrument + i;
+
+  std::vector<std::vector<int>> baskets(basket_count);
+  for (auto &basket : baskets) {
+	std::sample(universe.begin(), universe.end(), std::back_inserter(basket), constituents_per_basket, generator);
+  }
+  return baskets;
+}
+
+std::vector<TickEvent> warmUpTicks(const int &instrument_count) {
+  std::vector<TickEvent> ticks;
+  ticks.reserve(3 * instrument_count);
+
+  for (pricer::InstrumentIdType instrumentId = 0; instrumentId < instrument_count; instrumentId++) {
+	for (int type = 0; type < 3; type++) ticks.emplace_back(0, BASE_PRICES[type], EVENT_TYPES[type], instrumentId);
+  }
+  return ticks;
+}
+
+std::vector<TickEvent> makeTicks(const int &tick_count, const int &instrument_count) {
+  std::vector<TickEvent> ticks;
+  ticks.reserve(tick_count);
+
+  for (int i = 0; i < tick_count; i++) {
+	const int type = i % 3;
+	const int instrument = (i / 3) % instrument_count;
+	const pricer::PriceType offset = ((i / 3 / instrument_count) % 2) ? CENT : 0;
+	ticks.emplace_back(i, BASE_PRICES[type] + offset, EVENT_TYPES[type], instrument);
+  }
+  return ticks;
+}
+}
@@ -0,0 +1,49 @@
+#pragma once
+
+#include <random>
+#include <string>
+#include <vector>
+
+#include "TickEvent.h"
+
+namespace basket::benchmark {
+
+// threshold no price move of the synthetic ticks can breach
+constexpr static double NEVER_BREACHED_THRESHOLD_PCT = 1e9;
+
+struct SyntheticBasketFiles {
+  std::string basket_data_csv_{};
+  std::string basket_config_csv_{};
+};
+
+[[nodiscard]] std::string syntheticInstrumentName(const int &instrument);
+
+// Writes a basket data / basket config csv pair into the temp directory.
+// Each basket holds its constituents with an equal weight, every basket shares the same threshold.
+SyntheticBasketFiles writeSyntheticBaskets(const std::string &tag,
+										   const std::vector<std::vector<int>> &basket_constituents,
+										   const double &threshold_pct);
+
+// Writes an instrument simulation cfg for instruments [0, instrument_count) into the temp directory,
+// every instrument ticks on average every mean_event_interval clock ticks. Instruments cycle through
+// model_shapes (1 to 4) combinations of next event time and tick move distributions.
+std::string writeSyntheticSimulationConfig(const std::string &tag,
+										   const int &instrument_count,
+										   const int &mean_event_interval,
+										   const int &model_shapes = 1);
+
+// basket_count baskets of constituents_per_basket instruments drawn from [first_instrument, first_instrument + instrument_count)
+std::vector<std::vector<int>> randomBaskets(const int &basket_count,
+											const int &first_instrument,
+											const int &instrument_count,
+											const int &constituents_per_basket,
+											std::mt19937 &generator);
+
+// bid, ask and trade of every instrument id in [0, instrument_count), readies every basket
+std::vector<pricer::TickEvent> warmUpTicks(const int &instrument_count);
+
+// Ticks cycle through bid, ask and trade updates oscillating around the warm up prices.
+// Ids are interned in order of first appearance in the basket data, the ticks cover ids [0, instrument_count)
+std::vector<pricer::TickEvent> makeTicks(const int &tick_count, const int &instrument_count);
+
+}
@@ -0,0 +1,83 @@
+#include <fstream>
+#include <random>
+#include <span>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "BenchmarkHarness.h"
+#include "ThresholdEventSinks.h"
+
+#include "base/fixed_point.h"
+
+namespace basket::benchmark {
+namespace {
+constexpr static int BASKETS = 1000;
+constexpr static int EVENTS = 200000;
+constexpr static std::size_t BATCH_SIZE = 256;
+
+std::vector<pricer::ThresholdEvent> makeThresholdEvents(const std::vector<std::string> &basket_names) {
+  std::mt19937 generator(42);
+  std::uniform_int_distribution<int> basket(0, BASKETS - 1);
+  std::uniform_int_distribution<pricer::WeightedPriceType> price(1'000'000'000LL, 1'000'000'000'000LL);
+  std::uniform_int_distribution<int> event_type(0, 2);
+
+  std::vector<pricer::ThresholdEvent> events;
+  events.reserve(EVENTS);
+  for (int i = 0; i < EVENTS; i++) {
+	const auto basket_id = basket(generator);
+	const auto prev_price = price(generator);
+	const auto new_price = price(generator);
+	events.push_back({basket_id, static_cast<pricer::TickEventType>(event_type(generator)), prev_price, new_price,
+					  pricer::deltaPercentage(prev_price, new_price), basket_names[basket_id]});
+  }
+  return events;
+}
+
+template<typename Sink>
+void writeInBatches(Sink &sink, const std::vector<pricer::ThresholdEvent> &events) {
+  for (std::size_t first = 0; first < events.size(); first += BATCH_SIZE) {
+	sink.write(std::span<const pricer::ThresholdEvent>(events).subspan(first, std::min(BATCH_SIZE,
+																					  events.size() - first)));
+  }
+  sink.flush();
+}
+
+// Threshold events per second written to /dev/null, the former per message std::ostream formatting against the sinks
+const BenchmarkSuiteRegistrar registrar("threshold_event_sink", [](BenchmarkContext &context) {
+  std::vector<std::string> basket_names;
+  for (int i = 0; i < BASKETS; i++) basket_names.push_back("B" + std::to_string(i));
+  const auto events = makeThresholdEvents(basket_names);
+
+  {
+	std::ofstream ofs("/dev/null");
+	context.measure("ostream/per_message", events.size(), [&] {
+	  for (const auto &event : events) {
+		std::ostringstream oss;
+		oss << event.basket_name_;
+		if (event.event_type_ == pricer::TickEventType::TRADE) {
+		  oss << " PrevLastPrice " << pricer::weightedPriceToDouble(event.prev_price_)
+			  << " NewLastPrice " << pricer::weightedPriceToDouble(event.new_price_);
+		} else {
+		  oss << " PrevMidPrice " << pricer::weightedPriceToDouble(event.prev_price_)
+			  << " NewMidPrice " << pricer::weightedPriceToDouble(event.new_price_);
+		}
+		oss << " DeltaPct " << event.delta_pct_ << std::endl;
+		ofs << oss.str();
+	  }
+	  ofs.flush();
+	});
+  }
+
+  {
+	pricer::TextThresholdEventSink sink("/dev/null");
+	context.measure("TextThresholdEventSink", events.size(), [&] { writeInBatches(sink, events); });
+  }
+
+  {
+	pricer::BinaryThresholdEventSink sink("/dev/null");
+	context.measure("BinaryThresholdEventSink", events.size(), [&] { writeInBatches(sink, events); });
+  }
+});
+}
+}
@@ -0,0 +1,363 @@
+#include <algorithm>
+#include <cstdint>
+#include <random>
+#include <memory>
+#include <span>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "BenchmarkHarness.h"
+#include "CSVReader.h"
+#include "InstrumentSimulationModel.h"
+#include "RandomDistributionGeneratorFactory.h"
+#include "ShapedSimulationModels.h"
+#include "SyntheticData.h"
+#include "TickDataGenerator.h"
+
+namespace basket::benchmark {
+namespace {
+using pricer::TickDataGenerator;
+using pricer::TickDataGeneratorConfiguration;
+using pricer::TickEvent;
+
+constexpr static int DRAWS = 1000000;
+constexpr static int FILL_BLOCK = 1000;
+
+// Events published per second by run(), each call publishes the events of the next window of clock ticks,
+// about 2 million events whatever the instrument count. Subscribed one call per event, then one call per batch.
+void generatorRun(BenchmarkContext &context) {
+  constexpr static int MEAN_EVENT_INTERVAL = 3;
+  constexpr static std::uint64_t WINDOW_INSTRUMENTS = 3000000;
+
+  for (const int instrument_count : {100, 1000, 10000, 100000}) {
+	const std::uint64_t window = WINDOW_INSTRUMENTS / instrument_count;
+	const auto cfg = writeSyntheticSimulationConfig("generator_run", instrument_count, MEAN_EVENT_INTERVAL);
+
+	for (const bool batch : {false, true}) {
+	  std::vector<std::string> instrumentList;
+	  for (int i = 0; i < instrument_count; i++) instrumentList.push_back(syntheticInstrumentName(i));
+
+	  std::uint64_t published{0};
+	  TickDataGenerator generator(cfg);
+	  if (batch) {
+		generator.subscribeBatch([&published](const std::span<const TickEvent> &ticks, const bool &) {
+		  for (const auto &tickEvent : ticks) doNotOptimize(tickEvent.price_);
+		  published += ticks.size();
+		}, std::move(instrumentList));
+	  } else {
+		generator.subscribe([&published](const TickEvent &tickEvent) {
+		  doNotOptimize(tickEvent.price_);
+		  published++;
+		}, std::move(instrumentList));
+	  }
+
+	  context.measureCounted(std::string(batch ? "runBatch" : "run") + "/instruments=" +
+								 std::to_string(instrument_count), [&] {
+		published = 0;
+		generator.setEndTimestamp(generator.getLatestEventTimestamp() + window);
+		generator.run();
+		return published;
+	  });
+	}
+  }
+}
+
+// Hash of the events the generator publishes over the first windows of clock ticks
+std::uint64_t publishedEventsHash(const std::string &cfg,
+								  const int &instrument_count,
+								  const TickDataGeneratorConfiguration &configuration,
+								  const std::uint64_t &window) {
+  constexpr static int WINDOWS = 16;
+
+  std::vector<std::string> instrumentList;
+  for (int i = 0; i < instrument_count; i++) instrumentList.push_back(syntheticInstrumentName(i));
+
+  std::uint64_t hash{14695981039346656037ULL};
+  TickDataGenerator generator(cfg, configuration);
+  generator.subscribe([&hash](const TickEvent &tickEvent) {
+	for (const std::uint64_t value : {tickEvent.event_timestamp_,
+									  static_cast<std::uint64_t>(tickEvent.price_),
+									  static_cast<std::uint64_t>(tickEvent.eventType_),
+									  static_cast<std::uint64_t>(tickEvent.instrumentId_)}) {
+	  hash = (hash ^ value) * 1099511628211ULL;
+	}
+  }, std::move(instrumentList));
+
+  for (int i = 0; i < WINDOWS; i++) {
+	generator.setEndTimestamp(generator.getLatestEventTimestamp() + window);
+	generator.run();
+  }
+  return hash;
+}
+
+// Same as generatorRun with the instruments simulated on generation threads and merged back on the caller,
+// seeded so that every thread count must publish the single threaded event sequence
+void generatorThreads(BenchmarkContext &context) {
+  constexpr static int MEAN_EVENT_INTERVAL = 3;
+  constexpr static std::uint64_t WINDOW_INSTRUMENTS = 3000000;
+  constexpr static std::uint64_t SEED = 20240601;
+
+  const int hardware_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+  for (const int instrument_count : {1000, 100000}) {
+	const std::uint64_t window = WINDOW_INSTRUMENTS / instrument_count;
+	const auto cfg = writeSyntheticSimulationConfig("generator_threads", instrument_count, MEAN_EVENT_INTERVAL);
+
+	// generation threads run up to two rounds ahead of the merge, keep those small against a measured window
+	TickDataGeneratorConfiguration configuration;
+	configuration.seed_ = SEED;
+	configuration.generation_window_ = std::max<std::uint64_t>(1, window / 16);
+	const auto expected_hash = publishedEventsHash(cfg, instrument_count, configuration, window);
+
+	for (int threads = 1; threads <= std::max(2, hardware_threads); threads *= 2) {
+	  configuration.generation_threads_ = threads;
+
+	  if (threads > 1 && publishedEventsHash(cfg, instrument_count, configuration, window) != expected_hash) {
+		std::ostringstream oss;
+		oss << "generation_threads=" << threads << " published a different event sequence than a single thread";
+		throw std::runtime_error(oss.str());
+	  }
+
+	  std::vector<std::string> instrumentList;
+	  for (int i = 0; i < instrument_count; i++) instrumentList.push_back(syntheticInstrumentName(i));
+
+	  std::uint64_t published{0};
+	  TickDataGenerator generator(cfg, configuration);
+	  generator.subscribe([&published](const TickEvent &tickEvent) {
+		doNotOptimize(tickEvent.price_);
+		published++;
+	  }, std::move(instrumentList));
+
+	  const auto name = "threads=" + std::to_string(threads) + "/instruments=" + std::to_string(instrument_count);
+	  context.measureCounted(name, [&] {
+		published = 0;
+		generator.setEndTimestamp(generator.getLatestEventTimestamp() + window);
+		generator.run();
+		return published;
+	  });
+	}
+  }
+}
+
+// The simulation models as they were before shape grouping - five std::mt19937 backed distributions behind a virtual
+// call each, the baseline of modelShapes
+class VirtualDistribution {
+ public:
+  virtual ~VirtualDistribution() = default;
+
+  virtual double getNextValue() = 0;
+};
+
+template<typename D>
+class StdDistribution : public VirtualDistribution {
+ public:
+  template<typename... Args>
+  explicit StdDistribution(const std::uint32_t &seed, Args &&... args)
+	  : generator_(seed), distribution_(std::forward<Args>(args)...) {
+  }
+
+  double getNextValue() override {
+	return distribution_(generator_);
+  }
+
+ private:
+  std::mt19937 generator_;
+  D distribution_;
+};
+
+std::unique_ptr<VirtualDistribution> makeVirtualDistribution(const std::vector<std::string> &params,
+															 const std::uint32_t &seed) {
+  const double args1 = std::stod(params[1]);
+  const double args2 = params.size() > 2 ? std::stod(params[2]) : 0;
+
+  if (params[0] == "poisson_distribution") return std::make_unique<StdDistribution<std::poisson_distribution<>>>(seed, args1);
+  if (params[0] == "uniform_int_distribution") {
+	return std::make_unique<StdDistribution<std::uniform_int_distribution<>>>(seed, args1, args2);
+  }
+  if (params[0] == "normal_distribution") return std::make_unique<StdDistribution<std::normal_distribution<>>>(seed, args1, args2);
+  return std::make_unique<StdDistribution<std::uniform_real_distribution<>>>(seed, args1, args2);
+}
+
+class VirtualSimulationModel {
+ public:
+  VirtualSimulationModel(const std::vector<std::vector<std::string>> &cfg, const int &max_tick_diff, std::uint32_t seed)
+	  : next_event_time_rg_(makeVirtualDistribution(cfg[0], seed++)),
+		initial_price_rg_(makeVirtualDistribution(cfg[1], seed++)),
+		direction_rg_(makeVirtualDistribution(cfg[2], seed++)),
+		tick_move_rg_(makeVirtualDistribution(cfg[3], seed++)),
+		side_rg_(makeVirtualDistribution({"uniform_real_distribution", "0", "1"}, seed)),
+		max_tick_diff_(max_tick_diff) {
+  }
+
+  std::uint64_t getNextEventTime() {
+	int value = static_cast<int>(next_event_time_rg_->getNextValue());
+	return (value < 1) ? 1 : value;
+  }
+
+  pricer::PriceType getInitialPrice() { return pricer::toPrice(initial_price_rg_->getNextValue()); }
+
+  int getDirection() { return (direction_rg_->getNextValue() < 0.5) ? -1 : 1; }
+
+  pricer::Side getSide() { return (side_rg_->getNextValue() < 0.5) ? pricer::Side::BID : pricer::Side::ASK; }
+
+  int getTickMove() { return static_cast<int>(tick_move_rg_->getNextValue()); }
+
+  int getMaxTickDiff() const { return max_tick_diff_; }
+
+ private:
+  std::unique_ptr<VirtualDistribution> next_event_time_rg_;
+  std::unique_ptr<VirtualDistribution> initial_price_rg_;
+  std::unique_ptr<VirtualDistribution> direction_rg_;
+  std::unique_ptr<VirtualDistribution> tick_move_rg_;
+  std::unique_ptr<VirtualDistribution> side_rg_;
+  int max_tick_diff_{};
+};
+
+struct SimulationConfig {
+  std::vector<std::vector<std::string>> distributions_{};
+  int max_tick_diff_{0};
+};
+
+std::vector<SimulationConfig> readSimulationConfig(const std::string &cfg) {
+  const auto data = pricer::CSVReader(cfg).getData();
+
+  std::vector<SimulationConfig> configs;
+  for (std::size_t i = 0; i + 5 < data.size(); i += 6) {
+	configs.push_back({{data[i + 1], data[i + 2], data[i + 3], data[i + 4]}, std::stoi(data[i + 5][0])});
+  }
+  return configs;
+}
+
+// Simulates every instrument of a 100k instrument universe once per call - next price shape and next event time -
+// through the virtual models above, the runtime dispatched InstrumentSimulationModel and ShapedSimulationModels
+void modelShapes(BenchmarkContext &context) {
+  constexpr static int INSTRUMENTS = 100000;
+  constexpr static int MEAN_EVENT_INTERVAL = 3;
+
+  for (const int model_shapes : {1, 4}) {
+	const auto configs = readSimulationConfig(writeSyntheticSimulationConfig(
+		"model_shapes", INSTRUMENTS, MEAN_EVENT_INTERVAL, model_shapes));
+	const auto suffix = "/shapes=" + std::to_string(model_shapes);
+
+	std::vector<pricer::InstrumentPrice> prices(configs.size());
+	std::vector<pricer::InstrumentPrice> next_prices(configs.size());
+	std::vector<std::uint64_t> next_event_intervals(configs.size());
+
+	{
+	  std::vector<VirtualSimulationModel> models;
+	  models.reserve(configs.size());
+	  for (std::size_t i = 0; i < configs.size(); i++) {
+		models.emplace_back(configs[i].distributions_, configs[i].max_tick_diff_, static_cast<std::uint32_t>(5 * i));
+	  }
+
+	  auto body = [&] {
+		for (std::size_t i = 0; i < models.size(); i++) {
+		  prices[i] = pricer::produceNewPriceShape(models[i], prices[i]);
+		  next_event_intervals[i] = models[i].getNextEventTime();
+		}
+	  };
+	  body();
+	  context.measure("virtual" + suffix, configs.size(), body);
+	}
+
+	std::fill(prices.begin(), prices.end(), pricer::InstrumentPrice{});
+	{
+	  std::vector<std::unique_ptr<pricer::InstrumentSimulationModel>> models;
+	  for (std::size_t i = 0; i < configs.size(); i++) {
+		const auto &distributions = configs[i].distributions_;
+		models.push_back(pricer::InstrumentSimulationFactory::create(
+			distributions[0], distributions[1], distributions[2], distributions[3], configs[i].max_tick_diff_, i));
+	  }
+
+	  auto body = [&] {
+		for (std::size_t i = 0; i < models.size(); i++) {
+		  prices[i] = pricer::produceNewPriceShape(*models[i], prices[i]);
+		  next_event_intervals[i] = models[i]->getNextEventTime();
+		}
+	  };
+	  body();
+	  context.measure("variant" + suffix, configs.size(), body);
+	}
+
+	std::fill(prices.begin(), prices.end(), pricer::InstrumentPrice{});
+	{
+	  pricer::ShapedSimulationModels models;
+	  std::vector<pricer::InstrumentIdType> instruments;
+	  for (std::size_t i = 0; i < configs.size(); i++) {
+		const auto &distributions = configs[i].distributions_;
+		models.add(std::move(*pricer::InstrumentSimulationFactory::create(
+			distributions[0], distributions[1], distributions[2], distributions[3], configs[i].max_tick_diff_, i)));
+		instruments.push_back(static_cast<pricer::InstrumentIdType>(i));
+	  }
+
+	  std::vector<std::vector<pricer::InstrumentIdType>> pending;
+	  auto body = [&] {
+		models.simulate(instruments, prices.data(), next_prices.data(), next_event_intervals.data(), pending);
+		prices.swap(next_prices);
+	  };
+	  body();
+	  context.measure("shaped" + suffix, configs.size(), body);
+	}
+	doNotOptimize(prices.front().getBidPrice());
+	doNotOptimize(next_event_intervals.front());
+  }
+}
+
+void producePriceShape(BenchmarkContext &context) {
+  pricer::GenerationData generation_data;
+  generation_data.generation_model_ = pricer::InstrumentSimulationFactory::create(
+	  {"poisson_distribution", "3"},
+	  {"uniform_real_distribution", "37", "38"},
+	  {"uniform_real_distribution", "0", "1"},
+	  {"uniform_int_distribution", "1", "15"},
+	  30);
+
+  context.measure("produceNewPriceShape", DRAWS, [&] {
+	for (int i = 0; i < DRAWS; i++) {
+	  generation_data.instrumentPrice = TickDataGenerator::produceNewPriceShape(generation_data);
+	}
+  });
+  doNotOptimize(generation_data.instrumentPrice.getBidPrice());
+}
+
+void distributionDrawRate(BenchmarkContext &context) {
+  const std::vector<std::vector<std::string>> distributions{
+	  {"poisson_distribution", "3"},
+	  {"poisson_distribution", "250"},
+	  {"uniform_real_distribution", "0", "1"},
+	  {"uniform_int_distribution", "1", "15"},
+	  {"normal_distribution", "0", "1"},
+  };
+
+  for (const auto &params : distributions) {
+	auto distribution = pricer::RandomDistributionGeneratorFactory::create(params, DRAWS);
+
+	std::string name = params[0];
+	for (std::size_t i = 1; i < params.size(); i++) name += "," + params[i];
+
+	context.measure("getNextValue/" + name, DRAWS, [&] {
+	  for (int i = 0; i < DRAWS; i++) doNotOptimize(distribution.getNextValue());
+	});
+
+	std::vector<double> values(FILL_BLOCK);
+	context.measure("fill/" + name, DRAWS, [&] {
+	  for (int i = 0; i < DRAWS; i += FILL_BLOCK) {
+		distribution.fill(values.data(), values.size());
+		doNotOptimize(values.back());
+	  }
+	});
+  }
+}
+
+const BenchmarkSuiteRegistrar registrar("tick_data_generator", [](BenchmarkContext &context) {
+  generatorRun(context);
+  generatorThreads(context);
+  modelShapes(context);
+  producePriceShape(context);
+  distributionDrawRate(context);
+});
+}
+}
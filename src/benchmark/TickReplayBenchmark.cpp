@@ -0,0 +1,71 @@
+#include <filesystem>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "Basket.h"
+#include "BasketPricer.h"
+#include "BenchmarkHarness.h"
+#include "ReplayMarketDataProvider.h"
+#include "StaticTickPipeline.h"
+#include "SyntheticData.h"
+#include "TickCapture.h"
+
+namespace basket::benchmark {
+namespace {
+constexpr static int INSTRUMENTS = 1000;
+constexpr static int BASKETS = 1000;
+constexpr static int CONSTITUENTS_PER_BASKET = 16;
+constexpr static int TICK_COUNT = 5000000;
+
+// Capture write rate, then replay rate of the capture into a counting subscriber and into a BasketPricer, through
+// the subscribed callback then statically bound
+const BenchmarkSuiteRegistrar registrar("tick_replay", [](BenchmarkContext &context) {
+  std::mt19937 generator(42);
+  const auto files = writeSyntheticBaskets("tick_replay",
+										   randomBaskets(BASKETS, 0, INSTRUMENTS, CONSTITUENTS_PER_BASKET, generator),
+										   NEVER_BREACHED_THRESHOLD_PCT);
+  const pricer::BasketsComposition composition(files.basket_data_csv_, files.basket_config_csv_);
+  const auto capture_path = (std::filesystem::temp_directory_path() / "basket_benchmarks" / "tick_replay.tick").string();
+
+  auto ticks = warmUpTicks(composition.getInstrumentCount());
+  const auto oscillating = makeTicks(TICK_COUNT, composition.getInstrumentCount());
+  ticks.insert(ticks.end(), oscillating.begin(), oscillating.end());
+
+  context.measure("TickCaptureWriter::write+close", ticks.size(), [&] {
+	pricer::TickCaptureWriter capture(capture_path, composition.getInstrumentList());
+	for (const auto &tick : ticks) capture.write(tick);
+	capture.close();
+  });
+
+  {
+	pricer::ReplayMarketDataProvider replay(capture_path);
+	std::uint64_t checksum{0};
+	replay.subscribe([&checksum](const pricer::TickEvent &tickEvent) {
+	  checksum += tickEvent.price_;
+	}, composition.getInstrumentList());
+
+	context.measure("replay/counting_subscriber", replay.getRecordCount(), [&] {
+	  replay.seekToTimestamp(0);
+	  replay.run();
+	});
+	doNotOptimize(checksum);
+  }
+
+  auto replay = std::make_shared<pricer::ReplayMarketDataProvider>(capture_path);
+  pricer::BasketPricer basket_pricer(composition, replay);
+  basket_pricer.initMarketDataSubscription();
+
+  context.measure("replay/basket_pricer", replay->getRecordCount(), [&] {
+	replay->seekToTimestamp(0);
+	replay->run();
+  });
+
+  context.measure("replay/basket_pricer/static", replay->getRecordCount(), [&] {
+	replay->seekToTimestamp(0);
+	pricer::runTickPipeline(*replay, basket_pricer);
+  });
+});
+}
+}
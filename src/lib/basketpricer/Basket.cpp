@@ -1,23 +1,29 @@
 #include <algorithm>
+#include <numeric>
 #include <sstream>
+#include <stdexcept>
+#include <string_view>
 
 #include <iostream>
 
 #include "Basket.h"
 #include "CSVReader.h"
 
+#include "base/fixed_point.h"
+#include "base/string_hash.h"
+
 namespace basket::pricer {
-void BasketPriceData::setBidPrice(const PriceType &price) {
+void BasketPriceData::setBidPrice(const WeightedPriceType &price) {
   bid_price_ = price;
   updateMidPrice();
 }
 
-void BasketPriceData::setAskPrice(const PriceType &price) {
+void BasketPriceData::setAskPrice(const WeightedPriceType &price) {
   ask_price_ = price;
   updateMidPrice();
 }
 
-void BasketPriceData::setLastPrice(const PriceType &price) {
+void BasketPriceData::setLastPrice(const WeightedPriceType &price) {
   last_price_ = price;
 }
 
@@ -27,21 +33,37 @@ void BasketPriceData::updateMidPrice() {
   }
 }
 
-void BasketPriceData::setInstrumentWeight(const int &symbol_id, const double &weight) {
-  if (weighting_.size() <= symbol_id) weighting_.resize(symbol_id + 1);
-  weighting_[symbol_id] = weight;
-}
-
 void BasketPriceData::setBasketToReady() {
   is_ready_ = true;
 }
 
-[[nodiscard]] double BasketPriceData::getInstrumentWeighting(const int &symbol_id) const {
-  if (symbol_id >= weighting_.size()) return 0;
-  return weighting_[symbol_id];
+[[nodiscard]] WeightType BasketPriceData::getInstrumentWeighting(const int &symbol_id) const {
+  auto itr = std::lower_bound(constituents_.begin(), constituents_.end(), symbol_id,
+							  [](const BasketConstituent &constituent, const int &instrumentId) {
+								return constituent.instrument_id_ < instrumentId;
+							  });
+  if (itr == constituents_.end() || itr->instrument_id_ != symbol_id) return 0;
+  return itr->weight_;
 }
 
+struct BasketsComposition::OwnedLayout {
+  std::vector<std::uint64_t> instrument_name_offsets_{};
+  std::vector<char> instrument_names_{};
+  std::vector<std::int32_t> instruments_by_name_{};
+
+  std::vector<std::uint64_t> basket_name_offsets_{};
+  std::vector<char> basket_names_{};
+  std::vector<BasketConfiguration> basket_configurations_{};
+
+  std::vector<std::uint64_t> basket_constituent_offsets_{};
+  std::vector<BasketConstituent> basket_constituents_{};
+
+  std::vector<std::uint64_t> instrument_basket_offsets_{};
+  std::vector<BasketWeight> instrument_baskets_{};
+};
+
 BasketsComposition::BasketsComposition(const std::string &basketInfoCsv, const std::string &basketConfigCsvPath) {
+  StringMap<BasketConfiguration> basket_configs;
 
   // Basket Config
   {
@@ -49,141 +71,325 @@ BasketsComposition::BasketsComposition(const std::string &basketInfoCsv, const s
 	constexpr static std::string_view LAST_PRICE_THRESHOLD = "LastPrice Threshold";
 	constexpr static std::string_view MID_PRICE_THRESHOLD = "MidPrice Threshold";
 
-	constexpr static int HEADER_ROW_INDEX = 0;
+	bool header_row{true};
+	int basket_id_col{-1}, last_price_threshold_col{-1}, mid_price_threshold_col{-1};
+	int column_count{0};
 
 	CSVReader basketConfigCsvReader(basketConfigCsvPath);
-	auto data = basketConfigCsvReader.getData();
+	basketConfigCsvReader.forEachRow([&](const CSVReader::RowView &row) {
+	  if (header_row) {
+		header_row = false;
+		for (int i = 0; i < row.size(); i++) {
+		  if (row[i] == BASKET_ID) {
+			basket_id_col = i;
+		  } else if (row[i] == LAST_PRICE_THRESHOLD) {
+			last_price_threshold_col = i;
+		  } else if (row[i] == MID_PRICE_THRESHOLD) {
+			mid_price_threshold_col = i;
+		  }
+		}
+		column_count = std::max({basket_id_col, last_price_threshold_col, mid_price_threshold_col}) + 1;
+		return;
+	  }
+	  if (basket_id_col < 0 || last_price_threshold_col < 0 || mid_price_threshold_col < 0) return;
+	  if (row.size() < column_count) return;
+
+	  double midPriceThreshold{0}, lastPriceThreshold{0};
+	  CSVReader::parseField(row[last_price_threshold_col], lastPriceThreshold);
+	  CSVReader::parseField(row[mid_price_threshold_col], midPriceThreshold);
+
+	  const BasketConfiguration basketConfig{toThreshold(lastPriceThreshold), toThreshold(midPriceThreshold)};
+	  const auto &basketName = row[basket_id_col];
+	  auto itr = basket_configs.find(basketName);
+	  if (itr == basket_configs.end()) {
+		basket_configs.emplace(basketName, basketConfig);
+	  } else {
+		itr->second = basketConfig;
+	  }
+	});
+  }
 
-	const auto &header_row = data[HEADER_ROW_INDEX];
-	int basket_id_col{-1}, last_price_threshold_col{-1}, mid_price_threshold_col{-1};
+  // Basket Items
+  std::vector<std::string> instrument_names;
+  std::vector<std::string> basket_names;
+  struct Row {
+	int basket_id_;
+	BasketConstituent constituent_;
+  };
+  std::vector<Row> rows;
+  {
+	constexpr static std::string_view BASKET_ID = "Basket ID";
+	constexpr static std::string_view BASKET_ITEM_ID = "Basket Item ID";
+	constexpr static std::string_view WEIGHT = "Weight";
+
+	bool header_row{true};
+	int basket_id_col{-1}, basket_item_id_col{-1}, item_weight_col{-1};
+	int column_count{0};
+
+	StringMap<int> basket_name_to_id_map_{};
+	StringMap<int> instrument_name_to_id_map_{};
 
-	for (int i = 0; i < header_row.size(); i++) {
-	  if (header_row[i] == BASKET_ID) {
-		basket_id_col = i;
-	  } else if (header_row[i] == LAST_PRICE_THRESHOLD) {
-		last_price_threshold_col = i;
-	  } else if (header_row[i] == MID_PRICE_THRESHOLD) {
-		mid_price_threshold_col = i;
+	CSVReader basketInfoCsvReader(basketInfoCsv);
+	basketInfoCsvReader.forEachRow([&](const CSVReader::RowView &row) {
+	  if (header_row) {
+		header_row = false;
+		for (int i = 0; i < row.size(); i++) {
+		  if (row[i] == BASKET_ID) {
+			basket_id_col = i;
+		  } else if (row[i] == BASKET_ITEM_ID) {
+			basket_item_id_col = i;
+		  } else if (row[i] == WEIGHT) {
+			item_weight_col = i;
+		  }
+		}
+		column_count = std::max({basket_id_col, basket_item_id_col, item_weight_col}) + 1;
+		return;
+	  }
+	  if (basket_id_col < 0 || basket_item_id_col < 0 || item_weight_col < 0) return;
+	  if (row.size() < column_count) return;
+
+	  double instrument_weight_in_basket{0};
+	  CSVReader::parseField(row[item_weight_col], instrument_weight_in_basket);
+
+	  int basket_index_position = 0;
+	  const auto &basket_name = row[basket_id_col];
+	  {
+		auto itr = basket_name_to_id_map_.find(basket_name);
+		if (itr == basket_name_to_id_map_.end()) {
+		  basket_index_position = static_cast<int>(basket_names.size());
+		  basket_name_to_id_map_.emplace(basket_name, basket_index_position);
+		  basket_names.emplace_back(basket_name);
+		} else {
+		  basket_index_position = itr->second;
+		}
 	  }
-	}
 
-	std::istringstream iss;
+	  int instrument_index_position = 0;
+	  const auto &instrumentName = row[basket_item_id_col];
+	  {
+		auto itr = instrument_name_to_id_map_.find(instrumentName);
+		if (itr == instrument_name_to_id_map_.end()) {
+		  instrument_index_position = static_cast<int>(instrument_names.size());
+		  instrument_name_to_id_map_.emplace(instrumentName, instrument_index_position);
+		  instrument_names.emplace_back(instrumentName);
+		} else {
+		  instrument_index_position = itr->second;
+		}
+	  }
 
-	if (basket_id_col >= 0 && last_price_threshold_col >= 0 && mid_price_threshold_col >= 0) {
-	  for (int i = 1; i < data.size(); i++) {
-		const auto &row = data[i];
+	  rows.push_back({basket_index_position, {instrument_index_position, toWeight(instrument_weight_in_basket)}});
+	});
+  }
 
-		const auto &basketName = row[basket_id_col];
+  // a later row of the same basket and instrument replaces the earlier one, zero weights hold nothing
+  std::stable_sort(rows.begin(), rows.end(), [](const Row &lhs, const Row &rhs) {
+	if (lhs.basket_id_ != rhs.basket_id_) return lhs.basket_id_ < rhs.basket_id_;
+	return lhs.constituent_.instrument_id_ < rhs.constituent_.instrument_id_;
+  });
+
+  std::vector<std::uint64_t> constituent_offsets(basket_names.size() + 1, 0);
+  std::vector<BasketConstituent> constituents;
+  constituents.reserve(rows.size());
+  for (std::size_t i = 0; i < rows.size(); i++) {
+	const auto &row = rows[i];
+	if (i + 1 < rows.size() && rows[i + 1].basket_id_ == row.basket_id_ &&
+		rows[i + 1].constituent_.instrument_id_ == row.constituent_.instrument_id_) {
+	  continue;
+	}
+	if (row.constituent_.weight_ == 0) continue;
 
-		double midPriceThreshold{0}, lastPriceThreshold{0};
+	constituents.push_back(row.constituent_);
+	constituent_offsets[row.basket_id_ + 1]++;
+  }
+  for (std::size_t i = 0; i < basket_names.size(); i++) constituent_offsets[i + 1] += constituent_offsets[i];
 
-		iss.clear();
-		iss.str(row[last_price_threshold_col]);
-		iss >> lastPriceThreshold;
+  std::vector<BasketConfiguration> basket_configurations;
+  basket_configurations.reserve(basket_names.size());
+  for (const auto &basket_name : basket_names) {
+	auto itr = basket_configs.find(basket_name);
+	basket_configurations.push_back(itr != basket_configs.end() ? itr->second : BasketConfiguration{});
+  }
 
-		iss.clear();
-		iss.str(row[mid_price_threshold_col]);
-		iss >> midPriceThreshold;
+  *this = build(std::vector<std::string_view>(instrument_names.begin(), instrument_names.end()),
+				std::vector<std::string_view>(basket_names.begin(), basket_names.end()),
+				basket_configurations,
+				constituent_offsets,
+				constituents);
+}
 
-		basket_configs_[basketName] = std::move(BasketConfiguration{lastPriceThreshold, midPriceThreshold});
-	  }
+BasketsComposition BasketsComposition::build(const std::vector<std::string_view> &instrumentNames,
+											 const std::vector<std::string_view> &basketNames,
+											 const std::vector<BasketConfiguration> &basketConfigurations,
+											 const std::vector<std::uint64_t> &constituentOffsets,
+											 const std::vector<BasketConstituent> &constituents) {
+  auto owned = std::make_shared<OwnedLayout>();
+
+  auto concatenate = [](const std::vector<std::string_view> &names,
+						std::vector<std::uint64_t> &offsets,
+						std::vector<char> &blob) {
+	offsets.reserve(names.size() + 1);
+	offsets.push_back(0);
+	for (const auto &name : names) {
+	  blob.insert(blob.end(), name.begin(), name.end());
+	  offsets.push_back(blob.size());
+	}
+  };
+  concatenate(instrumentNames, owned->instrument_name_offsets_, owned->instrument_names_);
+  concatenate(basketNames, owned->basket_name_offsets_, owned->basket_names_);
+
+  owned->instruments_by_name_.resize(instrumentNames.size());
+  std::iota(owned->instruments_by_name_.begin(), owned->instruments_by_name_.end(), 0);
+  std::sort(owned->instruments_by_name_.begin(), owned->instruments_by_name_.end(),
+			[&instrumentNames](const std::int32_t &lhs, const std::int32_t &rhs) {
+			  return instrumentNames[lhs] < instrumentNames[rhs];
+			});
+
+  owned->basket_configurations_ = basketConfigurations;
+  owned->basket_constituent_offsets_ = constituentOffsets;
+  owned->basket_constituents_ = constituents;
+
+  // transpose into the instrument -> basket index, baskets are visited in id order hence each instrument's
+  // entries come out sorted by basket id
+  const auto instrument_count = instrumentNames.size();
+  auto &offsets = owned->instrument_basket_offsets_;
+  offsets.assign(instrument_count + 1, 0);
+  for (const auto &constituent : constituents) offsets[constituent.instrument_id_ + 1]++;
+  for (std::size_t i = 0; i < instrument_count; i++) offsets[i + 1] += offsets[i];
+
+  owned->instrument_baskets_.resize(offsets[instrument_count]);
+  std::vector<std::uint64_t> next_position(offsets.begin(), offsets.end() - 1);
+  for (int basket_id = 0; basket_id < basketNames.size(); basket_id++) {
+	for (auto i = constituentOffsets[basket_id]; i < constituentOffsets[basket_id + 1]; i++) {
+	  const auto &constituent = constituents[i];
+	  owned->instrument_baskets_[next_position[constituent.instrument_id_]++] =
+		  BasketWeight{basket_id, constituent.weight_};
 	}
   }
 
-  // Basket Items
-  {
-	constexpr static std::string_view BASKET_ID = "Basket ID";
-	constexpr static std::string_view BASKET_ITEM_ID = "Basket Item ID";
-	constexpr static std::string_view WEIGHT = "Weight";
+  BasketsComposition composition;
+  composition.layout_ = Layout{
+	  owned->instrument_name_offsets_,
+	  owned->instrument_names_,
+	  owned->instruments_by_name_,
+	  owned->basket_name_offsets_,
+	  owned->basket_names_,
+	  owned->basket_configurations_,
+	  owned->basket_constituent_offsets_,
+	  owned->basket_constituents_,
+	  owned->instrument_basket_offsets_,
+	  owned->instrument_baskets_};
+  composition.storage_ = std::move(owned);
+  composition.initBasketPriceData();
+  return composition;
+}
 
-	constexpr static int HEADER_ROW_INDEX = 0;
+void BasketsComposition::initBasketPriceData() {
+  const auto basket_count = layout_.basket_configurations_.size();
 
-	CSVReader basketInfoCsvReader(basketInfoCsv);
-	auto data = basketInfoCsvReader.getData();
+  baskets_price_data_.clear();
+  baskets_price_data_.reserve(basket_count);
+  for (int basket_id = 0; basket_id < basket_count; basket_id++) {
+	const auto first = layout_.basket_constituent_offsets_[basket_id];
+	const auto last = layout_.basket_constituent_offsets_[basket_id + 1];
 
-	const auto &header_row = data[HEADER_ROW_INDEX];
-	int basket_id_col{-1}, basket_item_id_col{-1}, item_weight_col{-1};
+	baskets_price_data_.emplace_back(nameAt(layout_.basket_name_offsets_, layout_.basket_names_, basket_id),
+									 basket_id,
+									 layout_.basket_configurations_[basket_id],
+									 layout_.basket_constituents_.subspan(first, last - first));
+  }
+}
 
-	for (int i = 0; i < header_row.size(); i++) {
-	  if (header_row[i] == BASKET_ID) {
-		basket_id_col = i;
-	  } else if (header_row[i] == BASKET_ITEM_ID) {
-		basket_item_id_col = i;
-	  } else if (header_row[i] == WEIGHT) {
-		item_weight_col = i;
-	  }
-	}
+[[nodiscard]] BasketsComposition BasketsComposition::selectBaskets(const std::vector<int> &basketIds) const {
+  std::vector<std::string_view> instrument_names;
+  instrument_names.reserve(getInstrumentCount());
+  for (int instrumentId = 0; instrumentId < getInstrumentCount(); instrumentId++) {
+	instrument_names.push_back(getInstrumentName(instrumentId));
+  }
 
-	std::istringstream iss;
-	std::unordered_map<std::string, int> basket_name_to_id_map_{};
-
-	if (basket_id_col >= 0 && basket_item_id_col >= 0 && item_weight_col >= 0) {
-	  for (int i = 1; i < data.size(); i++) {
-		const auto &row = data[i];
-
-		iss.clear();
-		iss.str(row[item_weight_col]);
-		double instrument_weight_in_basket{0};
-		iss >> instrument_weight_in_basket;
-
-		int basket_index_position = 0;
-		const auto &basket_name = row[basket_id_col];
-		{
-		  auto itr = basket_name_to_id_map_.find(basket_name);
-		  if (itr == basket_name_to_id_map_.end()) {
-			basket_index_position = basket_name_to_id_map_.size();
-			basket_name_to_id_map_[basket_name] = basket_index_position;
-		  } else {
-			basket_index_position = itr->second;
-		  }
-		}
+  std::vector<std::string_view> basket_names;
+  std::vector<BasketConfiguration> basket_configurations;
+  std::vector<std::uint64_t> constituent_offsets{0};
+  std::vector<BasketConstituent> constituents;
 
-		int instrument_index_position = 0;
-		const auto &instrumentName = row[basket_item_id_col];
-		{
-		  auto itr = instrumentName_to_id_map_.find(instrumentName);
-		  if (itr == instrumentName_to_id_map_.end()) {
-			instrument_index_position = instrumentName_to_id_map_.size();
-			instrumentName_to_id_map_[instrumentName] = instrument_index_position;
-		  } else {
-			instrument_index_position = itr->second;
-		  }
-		}
+  for (const auto &basketId : basketIds) {
+	const auto &basket_price_data = baskets_price_data_.at(basketId);
 
-		if (basket_index_position >= baskets_price_data_.size()) {
-		  BasketConfiguration basketConfig;
-		  auto itr = basket_configs_.find(basket_name);
-		  if (itr != basket_configs_.end()) basketConfig = itr->second;
+	basket_names.push_back(basket_price_data.getBasketName());
+	basket_configurations.push_back(basket_price_data.getBasketConfiguration());
+	const auto basket_constituents = basket_price_data.getConstituents();
+	constituents.insert(constituents.end(), basket_constituents.begin(), basket_constituents.end());
+	constituent_offsets.push_back(constituents.size());
+  }
 
-		  BasketPriceData basketInfo(basket_name, basket_index_position, basketConfig);
-		  basketInfo.setInstrumentWeight(instrument_index_position, instrument_weight_in_basket);
+  return build(instrument_names, basket_names, basket_configurations, constituent_offsets, constituents);
+}
 
-		  baskets_price_data_.push_back(std::move(basketInfo));
-		} else {
-		  BasketPriceData &basketInfo = baskets_price_data_[basket_index_position];
-		  basketInfo.setInstrumentWeight(instrument_index_position, instrument_weight_in_basket);
-		}
+[[nodiscard]] BasketsComposition BasketsComposition::renumberInstruments(
+	const std::vector<std::string> &instrumentList) const {
+  StringMap<int> instrument_positions;
+  instrument_positions.reserve(instrumentList.size());
+  for (int position = 0; position < instrumentList.size(); position++) {
+	instrument_positions.emplace(instrumentList[position], position);
+  }
+
+  std::vector<int> renumbered_ids(getInstrumentCount(), -1);
+  for (int instrumentId = 0; instrumentId < getInstrumentCount(); instrumentId++) {
+	auto itr = instrument_positions.find(getInstrumentName(instrumentId));
+	if (itr != instrument_positions.end()) renumbered_ids[instrumentId] = itr->second;
+  }
+
+  std::vector<std::string_view> basket_names;
+  std::vector<BasketConfiguration> basket_configurations;
+  std::vector<std::uint64_t> constituent_offsets{0};
+  std::vector<BasketConstituent> constituents;
+  basket_names.reserve(baskets_price_data_.size());
+  basket_configurations.reserve(baskets_price_data_.size());
+  constituents.reserve(layout_.basket_constituents_.size());
+
+  for (const auto &basket_price_data : baskets_price_data_) {
+	basket_names.push_back(basket_price_data.getBasketName());
+	basket_configurations.push_back(basket_price_data.getBasketConfiguration());
+
+	const auto first = constituents.size();
+	for (const auto &constituent : basket_price_data.getConstituents()) {
+	  const auto renumbered_id = renumbered_ids[constituent.instrument_id_];
+	  if (renumbered_id < 0) {
+		std::ostringstream oss;
+		oss << "Basket " << basket_price_data.getBasketName() << " holds instrument "
+			<< getInstrumentName(constituent.instrument_id_) << " which is not in the instrument list";
+		throw std::invalid_argument(oss.str());
 	  }
+	  constituents.push_back({renumbered_id, constituent.weight_});
 	}
-
+	std::sort(constituents.begin() + first, constituents.end(),
+			  [](const BasketConstituent &lhs, const BasketConstituent &rhs) {
+				return lhs.instrument_id_ < rhs.instrument_id_;
+			  });
+	constituent_offsets.push_back(constituents.size());
   }
+
+  return build(std::vector<std::string_view>(instrumentList.begin(), instrumentList.end()),
+			   basket_names, basket_configurations, constituent_offsets, constituents);
 }
 
-[[nodiscard]] int BasketsComposition::getInstrumentID(const std::string &instrumentName) const {
-  auto itr = instrumentName_to_id_map_.find(instrumentName);
-  if (itr != instrumentName_to_id_map_.end()) return itr->second;
+[[nodiscard]] int BasketsComposition::getInstrumentID(const std::string_view &instrumentName) const {
+  auto itr = std::lower_bound(layout_.instruments_by_name_.begin(), layout_.instruments_by_name_.end(),
+							  instrumentName,
+							  [this](const std::int32_t &instrumentId, const std::string_view &name) {
+								return getInstrumentName(instrumentId) < name;
+							  });
+  if (itr != layout_.instruments_by_name_.end() && getInstrumentName(*itr) == instrumentName) return *itr;
   return -1;
 }
 
 [[nodiscard]] std::vector<std::string> BasketsComposition::getInstrumentList() const {
   std::vector<std::string> instrumentList;
+  instrumentList.reserve(getInstrumentCount());
 
-  std::transform(instrumentName_to_id_map_.begin(), instrumentName_to_id_map_.end(),
-				 std::inserter(instrumentList, instrumentList.begin()),
-				 [](const auto &itr) {
-				   return itr.first;
-				 });
+  for (int instrumentId = 0; instrumentId < getInstrumentCount(); instrumentId++) {
+	instrumentList.emplace_back(getInstrumentName(instrumentId));
+  }
 
   return instrumentList;
 }
-}
\ No newline at end of file
+}
@@ -0,0 +1,115 @@
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include "BasketPriceSnapshots.h"
+
+#include "base/spin_wait.h"
+
+namespace basket::pricer {
+BasketPriceSnapshots::ReadGuard::ReadGuard(const BasketPriceSnapshots &snapshots)
+	: readers_(snapshots.readers_[snapshots.reader_epoch_.load(std::memory_order_relaxed) & 1]) {
+  // counted before the table is loaded, a writer seeing no reader counted knows any later one loads a later table
+  readers_.fetch_add(1, std::memory_order_seq_cst);
+  table_ = snapshots.current_.load(std::memory_order_seq_cst);
+}
+
+BasketPriceSnapshots::ReadGuard::~ReadGuard() {
+  readers_.fetch_sub(1, std::memory_order_release);
+}
+
+void BasketPriceSnapshots::reset(const std::size_t &basket_count, const std::uint64_t &composition_generation) {
+  auto table = std::make_unique<Table>();
+  table->composition_generation_ = composition_generation;
+  table->basket_count_ = basket_count;
+  table->records_ = std::make_unique<Record[]>(basket_count);
+
+  records_ = table->records_.get();
+  current_.store(table.get(), std::memory_order_seq_cst);
+  if (current_table_) retired_tables_.push_back({std::move(current_table_)});
+  current_table_ = std::move(table);
+
+  // readers arriving from now on count on the other counter, the ones counted on this one only drain
+  const std::size_t parity = reader_epoch_.fetch_add(1, std::memory_order_seq_cst) & 1;
+  markQuiescent(parity, false);
+
+  // past the bound, both counters are waited for in turn, each drained by moving the epoch on
+  if (retired_tables_.size() > MAX_RETIRED_TABLES) {
+	markQuiescent(parity, true);
+	reader_epoch_.fetch_add(1, std::memory_order_seq_cst);
+	markQuiescent(parity ^ 1, true);
+  }
+
+  std::erase_if(retired_tables_, [](const RetiredTable &retired) {
+	return retired.quiescent_[0] && retired.quiescent_[1];
+  });
+}
+
+void BasketPriceSnapshots::markQuiescent(const std::size_t &parity, const bool &wait) {
+  constexpr static int SPINS_BEFORE_YIELDING = 256;
+
+  for (int spins = 0; readers_[parity].load(std::memory_order_seq_cst) != 0; spins++) {
+	if (!wait) return;
+	(spins < SPINS_BEFORE_YIELDING) ? cpuRelax() : std::this_thread::yield();
+  }
+  for (auto &retired : retired_tables_) retired.quiescent_[parity] = true;
+}
+
+std::size_t BasketPriceSnapshots::getBasketCount() const {
+  const ReadGuard guard(*this);
+  return guard.getTable() ? guard.getTable()->basket_count_ : 0;
+}
+
+BasketPriceSnapshot BasketPriceSnapshots::read(const int &basket_id) const {
+  const ReadGuard guard(*this);
+  const Table *table = guard.getTable();
+  if (!table || basket_id < 0 || static_cast<std::size_t>(basket_id) >= table->basket_count_) {
+	std::ostringstream oss;
+	oss << "No basket price snapshot for basket id " << basket_id;
+	throw std::out_of_range(oss.str());
+  }
+  return readRecord(*table, basket_id);
+}
+
+void BasketPriceSnapshots::readAll(std::vector<BasketPriceSnapshot> &snapshots) const {
+  snapshots.clear();
+  const ReadGuard guard(*this);
+  const Table *table = guard.getTable();
+  if (!table) return;
+
+  snapshots.reserve(table->basket_count_);
+  for (std::size_t basket_id = 0; basket_id < table->basket_count_; basket_id++) {
+	snapshots.push_back(readRecord(*table, static_cast<int>(basket_id)));
+  }
+}
+
+BasketPriceSnapshot BasketPriceSnapshots::readRecord(const Table &table, const int &basket_id) {
+  const Record &record = table.records_[basket_id];
+
+  BasketPriceSnapshot snapshot;
+  snapshot.basket_id_ = basket_id;
+  snapshot.composition_generation_ = table.composition_generation_;
+
+  while (true) {
+	const std::uint64_t sequence = record.sequence_.load(std::memory_order_acquire);
+	if (sequence & 1) [[unlikely]] {
+	  cpuRelax();
+	  continue;
+	}
+
+	snapshot.bid_price_ = record.bid_price_.load(std::memory_order_relaxed);
+	snapshot.ask_price_ = record.ask_price_.load(std::memory_order_relaxed);
+	snapshot.mid_price_ = record.mid_price_.load(std::memory_order_relaxed);
+	snapshot.last_price_ = record.last_price_.load(std::memory_order_relaxed);
+	snapshot.event_timestamp_ = record.event_timestamp_.load(std::memory_order_relaxed);
+	snapshot.is_ready_ = record.is_ready_.load(std::memory_order_relaxed);
+
+	// the fence keeps the price loads before the recheck, a write started meanwhile changed the sequence
+	std::atomic_thread_fence(std::memory_order_acquire);
+	if (record.sequence_.load(std::memory_order_relaxed) == sequence) [[likely]] {
+	  snapshot.version_ = sequence / 2;
+	  return snapshot;
+	}
+  }
+}
+}
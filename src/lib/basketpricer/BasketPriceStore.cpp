@@ -0,0 +1,486 @@
+#include "BasketPriceStore.h"
+
+#include <algorithm>
+#include <limits>
+
+#if defined(__x86_64__)
+#include <immintrin.h>
+#endif
+
+#include "base/fixed_point.h"
+
+namespace basket::pricer {
+namespace {
+
+struct StoreColumns {
+  WeightedPriceType *bid_price_;
+  WeightedPriceType *ask_price_;
+  WeightedPriceType *mid_price_;
+  WeightedPriceType *last_price_;
+  const ThresholdType *last_price_threshold_;
+  const ThresholdType *mid_price_threshold_;
+  WeightedPriceType *bid_delta_;
+  WeightedPriceType *ask_delta_;
+  WeightedPriceType *last_delta_;
+};
+
+// Vector kernels multiply in 64 bits, exact as long as a lane stays within these bounds,
+// otherwise that group of lanes goes through the scalar kernel
+struct KernelBounds {
+  // |price delta| * 100 * THRESHOLD_SCALE fits 64 bits
+  WeightedPriceType max_delta_;
+  // prev price * threshold fits 64 bits
+  WeightedPriceType max_prev_price_;
+  // bid + ask fits 64 bits
+  WeightedPriceType max_side_price_;
+};
+
+void revalueScalar(const StoreColumns &columns, const int &begin, const int &end, std::vector<BasketBreach> &breaches) {
+  for (int i = begin; i < end; i++) {
+	const WeightedPriceType new_bid = columns.bid_price_[i] + columns.bid_delta_[i];
+	const WeightedPriceType new_ask = columns.ask_price_[i] + columns.ask_delta_[i];
+	const WeightedPriceType new_last = columns.last_price_[i] + columns.last_delta_[i];
+	// as BasketPriceData::updateMidPrice, the mid price moves once both sides are positive
+	const WeightedPriceType new_mid = (new_bid > 0 && new_ask > 0) ? (new_bid + new_ask) / 2 : columns.mid_price_[i];
+
+	if (isThresholdBreached(columns.last_price_[i], new_last, columns.last_price_threshold_[i])) {
+	  breaches.push_back({i, true, columns.last_price_[i], new_last});
+	}
+	if (isThresholdBreached(columns.mid_price_[i], new_mid, columns.mid_price_threshold_[i])) {
+	  breaches.push_back({i, false, columns.mid_price_[i], new_mid});
+	}
+
+	columns.bid_price_[i] = new_bid;
+	columns.ask_price_[i] = new_ask;
+	columns.last_price_[i] = new_last;
+	columns.mid_price_[i] = new_mid;
+	columns.bid_delta_[i] = 0;
+	columns.ask_delta_[i] = 0;
+	columns.last_delta_[i] = 0;
+  }
+}
+
+#if defined(__x86_64__)
+
+// a * b for 0 <= a, 0 <= b < 2^32 and a product below 2^63
+__attribute__((target("avx2"))) inline __m256i multiply64x32(const __m256i &a, const __m256i &b) {
+  const __m256i low = _mm256_mul_epu32(a, b);
+  const __m256i high = _mm256_mul_epu32(_mm256_srli_epi64(a, 32), b);
+  return _mm256_add_epi64(low, _mm256_slli_epi64(high, 32));
+}
+
+__attribute__((target("avx2"))) inline __m256i outside(const __m256i &value,
+													   const __m256i &low,
+													   const __m256i &high) {
+  return _mm256_or_si256(_mm256_cmpgt_epi64(low, value), _mm256_cmpgt_epi64(value, high));
+}
+
+__attribute__((target("avx2")))
+void revalueAvx2(const StoreColumns &columns,
+				 const KernelBounds &bounds,
+				 const int &begin,
+				 const int &end,
+				 std::vector<BasketBreach> &breaches) {
+  constexpr static int LANES = 4;
+
+  const __m256i zero = _mm256_setzero_si256();
+  const __m256i pct_scale = _mm256_set1_epi64x(100 * THRESHOLD_SCALE);
+  const __m256i max_delta = _mm256_set1_epi64x(bounds.max_delta_);
+  const __m256i min_delta = _mm256_set1_epi64x(-bounds.max_delta_);
+  const __m256i max_prev_price = _mm256_set1_epi64x(bounds.max_prev_price_);
+  const __m256i max_side_price = _mm256_set1_epi64x(bounds.max_side_price_);
+
+  int i = begin;
+  for (; i + LANES <= end; i += LANES) {
+	const __m256i prev_bid = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns.bid_price_ + i));
+	const __m256i prev_ask = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns.ask_price_ + i));
+	const __m256i prev_last = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns.last_price_ + i));
+	const __m256i prev_mid = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns.mid_price_ + i));
+
+	const __m256i new_bid = _mm256_add_epi64(
+		prev_bid, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns.bid_delta_ + i)));
+	const __m256i new_ask = _mm256_add_epi64(
+		prev_ask, _mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns.ask_delta_ + i)));
+	const __m256i last_delta = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns.last_delta_ + i));
+	const __m256i new_last = _mm256_add_epi64(prev_last, last_delta);
+	// a logical shift halves exactly as bid and ask are checked non-negative below, the mid price moves once both
+	// sides are positive
+	const __m256i both_sides_priced = _mm256_and_si256(_mm256_cmpgt_epi64(new_bid, zero),
+													   _mm256_cmpgt_epi64(new_ask, zero));
+	const __m256i new_mid = _mm256_blendv_epi8(
+		prev_mid, _mm256_srli_epi64(_mm256_add_epi64(new_bid, new_ask), 1), both_sides_priced);
+	const __m256i mid_delta = _mm256_sub_epi64(new_mid, prev_mid);
+
+	const __m256i out_of_bounds = _mm256_or_si256(
+		_mm256_or_si256(outside(prev_last, zero, max_prev_price), outside(prev_mid, zero, max_prev_price)),
+		_mm256_or_si256(
+			_mm256_or_si256(outside(last_delta, min_delta, max_delta), outside(mid_delta, min_delta, max_delta)),
+			_mm256_or_si256(outside(new_bid, zero, max_side_price), outside(new_ask, zero, max_side_price))));
+
+	if (!_mm256_testz_si256(out_of_bounds, out_of_bounds)) [[unlikely]] {
+	  revalueScalar(columns, i, i + LANES, breaches);
+	  continue;
+	}
+
+	// |new - prev| * 100 * THRESHOLD_SCALE > threshold * prev, as isThresholdBreached
+	const __m256i last_threshold =
+		_mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns.last_price_threshold_ + i));
+	const __m256i mid_threshold =
+		_mm256_loadu_si256(reinterpret_cast<const __m256i *>(columns.mid_price_threshold_ + i));
+
+	const __m256i last_sign = _mm256_cmpgt_epi64(zero, last_delta);
+	const __m256i abs_last_delta = _mm256_sub_epi64(_mm256_xor_si256(last_delta, last_sign), last_sign);
+	const __m256i mid_sign = _mm256_cmpgt_epi64(zero, mid_delta);
+	const __m256i abs_mid_delta = _mm256_sub_epi64(_mm256_xor_si256(mid_delta, mid_sign), mid_sign);
+
+	const __m256i last_breached = _mm256_cmpgt_epi64(multiply64x32(abs_last_delta, pct_scale),
+													 multiply64x32(prev_last, last_threshold));
+	const __m256i mid_breached = _mm256_cmpgt_epi64(multiply64x32(abs_mid_delta, pct_scale),
+													multiply64x32(prev_mid, mid_threshold));
+
+	const int last_mask = _mm256_movemask_pd(_mm256_castsi256_pd(last_breached));
+	const int mid_mask = _mm256_movemask_pd(_mm256_castsi256_pd(mid_breached));
+	if (last_mask | mid_mask) [[unlikely]] {
+	  alignas(32) WeightedPriceType new_lasts[LANES], new_mids[LANES];
+	  _mm256_store_si256(reinterpret_cast<__m256i *>(new_lasts), new_last);
+	  _mm256_store_si256(reinterpret_cast<__m256i *>(new_mids), new_mid);
+
+	  for (int lane = 0; lane < LANES; lane++) {
+		if (last_mask & (1 << lane)) breaches.push_back({i + lane, true, columns.last_price_[i + lane], new_lasts[lane]});
+		if (mid_mask & (1 << lane)) breaches.push_back({i + lane, false, columns.mid_price_[i + lane], new_mids[lane]});
+	  }
+	}
+
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(columns.bid_price_ + i), new_bid);
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(columns.ask_price_ + i), new_ask);
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(columns.last_price_ + i), new_last);
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(columns.mid_price_ + i), new_mid);
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(columns.bid_delta_ + i), zero);
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(columns.ask_delta_ + i), zero);
+	_mm256_storeu_si256(reinterpret_cast<__m256i *>(columns.last_delta_ + i), zero);
+  }
+
+  revalueScalar(columns, i, end, breaches);
+}
+
+__attribute__((target("avx512f,avx512dq")))
+void revalueAvx512(const StoreColumns &columns,
+				   const KernelBounds &bounds,
+				   const int &begin,
+				   const int &end,
+				   std::vector<BasketBreach> &breaches) {
+  constexpr static int LANES = 8;
+
+  const __m512i zero = _mm512_setzero_si512();
+  const __m512i pct_scale = _mm512_set1_epi64(100 * THRESHOLD_SCALE);
+  const __m512i max_delta = _mm512_set1_epi64(bounds.max_delta_);
+  const __m512i max_prev_price = _mm512_set1_epi64(bounds.max_prev_price_);
+  const __m512i max_side_price = _mm512_set1_epi64(bounds.max_side_price_);
+
+  int i = begin;
+  for (; i + LANES <= end; i += LANES) {
+	const __m512i prev_bid = _mm512_loadu_si512(columns.bid_price_ + i);
+	const __m512i prev_ask = _mm512_loadu_si512(columns.ask_price_ + i);
+	const __m512i prev_last = _mm512_loadu_si512(columns.last_price_ + i);
+	const __m512i prev_mid = _mm512_loadu_si512(columns.mid_price_ + i);
+
+	const __m512i new_bid = _mm512_add_epi64(prev_bid, _mm512_loadu_si512(columns.bid_delta_ + i));
+	const __m512i new_ask = _mm512_add_epi64(prev_ask, _mm512_loadu_si512(columns.ask_delta_ + i));
+	const __m512i last_delta = _mm512_loadu_si512(columns.last_delta_ + i);
+	const __m512i new_last = _mm512_add_epi64(prev_last, last_delta);
+	const __mmask8 both_sides_priced = _mm512_cmpgt_epi64_mask(new_bid, zero) & _mm512_cmpgt_epi64_mask(new_ask, zero);
+	const __m512i new_mid = _mm512_mask_blend_epi64(
+		both_sides_priced, prev_mid, _mm512_srli_epi64(_mm512_add_epi64(new_bid, new_ask), 1));
+	const __m512i abs_last_delta = _mm512_abs_epi64(last_delta);
+	const __m512i abs_mid_delta = _mm512_abs_epi64(_mm512_sub_epi64(new_mid, prev_mid));
+
+	// unsigned compares also reject negative values
+	const __mmask8 in_bounds =
+		_mm512_cmple_epu64_mask(prev_last, max_prev_price) & _mm512_cmple_epu64_mask(prev_mid, max_prev_price) &
+			_mm512_cmple_epu64_mask(abs_last_delta, max_delta) & _mm512_cmple_epu64_mask(abs_mid_delta, max_delta) &
+			_mm512_cmple_epu64_mask(new_bid, max_side_price) & _mm512_cmple_epu64_mask(new_ask, max_side_price);
+
+	if (in_bounds != 0xFF) [[unlikely]] {
+	  revalueScalar(columns, i, i + LANES, breaches);
+	  continue;
+	}
+
+	const __m512i last_threshold = _mm512_loadu_si512(columns.last_price_threshold_ + i);
+	const __m512i mid_threshold = _mm512_loadu_si512(columns.mid_price_threshold_ + i);
+
+	const __mmask8 last_mask = _mm512_cmpgt_epi64_mask(_mm512_mullo_epi64(abs_last_delta, pct_scale),
+													   _mm512_mullo_epi64(prev_last, last_threshold));
+	const __mmask8 mid_mask = _mm512_cmpgt_epi64_mask(_mm512_mullo_epi64(abs_mid_delta, pct_scale),
+													  _mm512_mullo_epi64(prev_mid, mid_threshold));
+	if (last_mask | mid_mask) [[unlikely]] {
+	  alignas(64) WeightedPriceType new_lasts[LANES], new_mids[LANES];
+	  _mm512_store_si512(new_lasts, new_last);
+	  _mm512_store_si512(new_mids, new_mid);
+
+	  for (int lane = 0; lane < LANES; lane++) {
+		if (last_mask & (1 << lane)) breaches.push_back({i + lane, true, columns.last_price_[i + lane], new_lasts[lane]});
+		if (mid_mask & (1 << lane)) breaches.push_back({i + lane, false, columns.mid_price_[i + lane], new_mids[lane]});
+	  }
+	}
+
+	_mm512_storeu_si512(columns.bid_price_ + i, new_bid);
+	_mm512_storeu_si512(columns.ask_price_ + i, new_ask);
+	_mm512_storeu_si512(columns.last_price_ + i, new_last);
+	_mm512_storeu_si512(columns.mid_price_ + i, new_mid);
+	_mm512_storeu_si512(columns.bid_delta_ + i, zero);
+	_mm512_storeu_si512(columns.ask_delta_ + i, zero);
+	_mm512_storeu_si512(columns.last_delta_ + i, zero);
+  }
+
+  revalueScalar(columns, i, end, breaches);
+}
+
+#endif
+}
+
+BasketPriceStore::BasketPriceStore(const BasketsComposition &basketComposition) {
+  const auto &baskets_price_data = basketComposition.getBasketPriceData();
+  const auto basket_count = baskets_price_data.size();
+
+  bid_price_.resize(basket_count);
+  ask_price_.resize(basket_count);
+  mid_price_.resize(basket_count);
+  last_price_.resize(basket_count);
+  bid_delta_.assign(basket_count, 0);
+  ask_delta_.assign(basket_count, 0);
+  last_delta_.assign(basket_count, 0);
+  missing_price_fields_.assign(basket_count, 0);
+  is_ready_.assign(basket_count, 0);
+
+  for (const auto &basket_price_data : baskets_price_data) {
+	const auto &configuration = basket_price_data.getBasketConfiguration();
+	last_price_threshold_.push_back(configuration.lastPriceThreshold_);
+	mid_price_threshold_.push_back(configuration.midPriceThreshold_);
+	min_threshold_ = std::min({min_threshold_, configuration.lastPriceThreshold_, configuration.midPriceThreshold_});
+	max_threshold_ = std::max({max_threshold_, configuration.lastPriceThreshold_, configuration.midPriceThreshold_});
+  }
+
+  for (int i = 0; i < basket_count; i++) {
+	bid_price_[i] = baskets_price_data[i].getBidPrice();
+	ask_price_[i] = baskets_price_data[i].getAskPrice();
+	mid_price_[i] = baskets_price_data[i].getMidPrice();
+	last_price_[i] = baskets_price_data[i].getLastPrice();
+	is_ready_[i] = baskets_price_data[i].isReady();
+	not_ready_count_ += !is_ready_[i];
+  }
+
+  instrument_offsets_.push_back(0);
+  for (int instrumentId = 0; instrumentId < basketComposition.getInstrumentCount(); instrumentId++) {
+	for (const auto &[basket_id, weight] : basketComposition.getInstrumentBaskets(instrumentId)) {
+	  basket_ids_.push_back(basket_id);
+	  weights_.push_back(weight);
+	}
+	instrument_offsets_.push_back(basket_ids_.size());
+  }
+
+  // transpose into the basket -> instrument direction, constituents come out ordered by instrument id
+  basket_offsets_.assign(basket_count + 1, 0);
+  for (const auto &basket_id : basket_ids_) basket_offsets_[basket_id + 1]++;
+  for (int i = 0; i < basket_count; i++) basket_offsets_[i + 1] += basket_offsets_[i];
+
+  constituent_ids_.resize(basket_ids_.size());
+  constituent_weights_.resize(basket_ids_.size());
+  std::vector<std::size_t> next_position(basket_offsets_.begin(), basket_offsets_.end() - 1);
+  for (int instrumentId = 0; instrumentId + 1 < instrument_offsets_.size(); instrumentId++) {
+	for (auto i = instrument_offsets_[instrumentId]; i < instrument_offsets_[instrumentId + 1]; i++) {
+	  const auto position = next_position[basket_ids_[i]]++;
+	  constituent_ids_[position] = instrumentId;
+	  constituent_weights_[position] = weights_[i];
+	}
+  }
+
+  instrument_prices_.assign(instrument_offsets_.size() - 1, InstrumentPrice{});
+  instrument_bid_delta_.assign(instrument_offsets_.size() - 1, 0);
+  instrument_ask_delta_.assign(instrument_offsets_.size() - 1, 0);
+  instrument_last_delta_.assign(instrument_offsets_.size() - 1, 0);
+
+  // no instrument is priced yet
+  for (int basket_id = 0; basket_id < basket_count; basket_id++) {
+	if (!is_ready_[basket_id]) missing_price_fields_[basket_id] = countMissingPriceFields(basket_id);
+  }
+
+  setSimdLevel(getSupportedSimdLevel());
+}
+
+std::uint32_t BasketPriceStore::countMissingPriceFields(const int &basket_id) const {
+  std::uint32_t missing_price_fields{0};
+  for (auto i = basket_offsets_[basket_id]; i < basket_offsets_[basket_id + 1]; i++) {
+	if (constituent_weights_[i] > 0) {
+	  const auto &instrument_price = instrument_prices_[constituent_ids_[i]];
+	  missing_price_fields += (instrument_price.getAskPrice() == 0) +
+		  (instrument_price.getBidPrice() == 0) +
+		  (instrument_price.getLastPrice() == 0);
+	}
+  }
+  return missing_price_fields;
+}
+
+void BasketPriceStore::initBasketPrices(const int &basket_id) {
+  WeightedPriceType ask_weighted{0}, bid_weighted{0}, last_weighted{0};
+  for (auto i = basket_offsets_[basket_id]; i < basket_offsets_[basket_id + 1]; i++) {
+	if (constituent_weights_[i] > 0) {
+	  const auto &instrument_price = instrument_prices_[constituent_ids_[i]];
+	  ask_weighted += instrument_price.getAskPrice() * constituent_weights_[i];
+	  bid_weighted += instrument_price.getBidPrice() * constituent_weights_[i];
+	  last_weighted += instrument_price.getLastPrice() * constituent_weights_[i];
+	}
+  }
+
+  bid_price_[basket_id] = bid_weighted;
+  ask_price_[basket_id] = ask_weighted;
+  last_price_[basket_id] = last_weighted;
+  if (bid_weighted > 0 && ask_weighted > 0) mid_price_[basket_id] = (bid_weighted + ask_weighted) / 2;
+}
+
+void BasketPriceStore::revalue(const std::vector<InstrumentPrice> &instrument_prices) {
+  std::copy_n(instrument_prices.begin(), std::min(instrument_prices.size(), instrument_prices_.size()),
+			  instrument_prices_.begin());
+
+  not_ready_count_ = 0;
+  for (int basket_id = 0; basket_id < getBasketCount(); basket_id++) {
+	missing_price_fields_[basket_id] = countMissingPriceFields(basket_id);
+	is_ready_[basket_id] = missing_price_fields_[basket_id] == 0;
+	not_ready_count_ += !is_ready_[basket_id];
+
+	bid_price_[basket_id] = ask_price_[basket_id] = mid_price_[basket_id] = last_price_[basket_id] = 0;
+	if (is_ready_[basket_id]) initBasketPrices(basket_id);
+  }
+}
+
+void BasketPriceStore::applyDeltas(std::span<const InstrumentPriceDelta> deltas, std::vector<BasketBreach> &breaches) {
+  std::size_t scatter_work{0};
+  for (const auto &delta : deltas) {
+	scatter_work += instrument_offsets_[delta.instrumentId_ + 1] - instrument_offsets_[delta.instrumentId_];
+  }
+
+  // the instrument prices as of the end of the batch, and the price fields the batch gave or cleared counted down for
+  // the baskets not yet ready, as the scalar pricer does
+  for (const auto &delta : deltas) {
+	auto &instrument_price = instrument_prices_[delta.instrumentId_];
+	const int prev_priced_fields = (instrument_price.getBidPrice() != 0) + (instrument_price.getAskPrice() != 0) +
+		(instrument_price.getLastPrice() != 0);
+	instrument_price.setBidPrice(instrument_price.getBidPrice() + delta.bid_delta_);
+	instrument_price.setAskPrice(instrument_price.getAskPrice() + delta.ask_delta_);
+	instrument_price.setLastPrice(instrument_price.getLastPrice() + delta.last_delta_);
+
+	if (not_ready_count_ == 0) [[likely]] continue;
+	const int priced_fields_delta = (instrument_price.getBidPrice() != 0) + (instrument_price.getAskPrice() != 0) +
+		(instrument_price.getLastPrice() != 0) - prev_priced_fields;
+	if (priced_fields_delta == 0) continue;
+	for (auto i = instrument_offsets_[delta.instrumentId_]; i < instrument_offsets_[delta.instrumentId_ + 1]; i++) {
+	  if (weights_[i] > 0 && !is_ready_[basket_ids_[i]]) missing_price_fields_[basket_ids_[i]] -= priced_fields_delta;
+	}
+  }
+
+  int begin = getBasketCount(), end = 0;
+
+  // a random scatter costs about twice a sequential gather per (basket, instrument) entry
+  if (2 * scatter_work < basket_ids_.size()) {
+	// sparse batch - scatter the weighted deltas into the per basket delta columns
+	for (const auto &delta : deltas) {
+	  for (auto i = instrument_offsets_[delta.instrumentId_]; i < instrument_offsets_[delta.instrumentId_ + 1]; i++) {
+		const int basket_id = basket_ids_[i];
+		bid_delta_[basket_id] += delta.bid_delta_ * weights_[i];
+		ask_delta_[basket_id] += delta.ask_delta_ * weights_[i];
+		last_delta_[basket_id] += delta.last_delta_ * weights_[i];
+		begin = std::min(begin, basket_id);
+		end = std::max(end, basket_id + 1);
+	  }
+	}
+  } else {
+	// dense batch - net the deltas per instrument, then every basket gathers its constituents' deltas,
+	// reading the basket side sequentially instead of scattering at random
+	for (const auto &delta : deltas) {
+	  instrument_bid_delta_[delta.instrumentId_] += delta.bid_delta_;
+	  instrument_ask_delta_[delta.instrumentId_] += delta.ask_delta_;
+	  instrument_last_delta_[delta.instrumentId_] += delta.last_delta_;
+	}
+
+	for (int basket_id = 0; basket_id < getBasketCount(); basket_id++) {
+	  WeightedPriceType bid_delta{0}, ask_delta{0}, last_delta{0};
+	  for (auto i = basket_offsets_[basket_id]; i < basket_offsets_[basket_id + 1]; i++) {
+		bid_delta += instrument_bid_delta_[constituent_ids_[i]] * constituent_weights_[i];
+		ask_delta += instrument_ask_delta_[constituent_ids_[i]] * constituent_weights_[i];
+		last_delta += instrument_last_delta_[constituent_ids_[i]] * constituent_weights_[i];
+	  }
+	  bid_delta_[basket_id] = bid_delta;
+	  ask_delta_[basket_id] = ask_delta;
+	  last_delta_[basket_id] = last_delta;
+	}
+
+	for (const auto &delta : deltas) {
+	  instrument_bid_delta_[delta.instrumentId_] = 0;
+	  instrument_ask_delta_[delta.instrumentId_] = 0;
+	  instrument_last_delta_[delta.instrumentId_] = 0;
+	}
+	begin = 0;
+	end = getBasketCount();
+  }
+
+  if (begin >= end) return;
+
+  // baskets not ready take no delta, those the batch made ready are summed once the kernel is done, neither breaches
+  becoming_ready_.clear();
+  if (not_ready_count_ > 0) [[unlikely]] {
+	for (int basket_id = begin; basket_id < end; basket_id++) {
+	  if (is_ready_[basket_id]) continue;
+	  bid_delta_[basket_id] = ask_delta_[basket_id] = last_delta_[basket_id] = 0;
+	  if (missing_price_fields_[basket_id] == 0) becoming_ready_.push_back(basket_id);
+	}
+  }
+
+  // then revalue the affected range and evaluate both thresholds in one pass
+  const StoreColumns columns{
+	  bid_price_.data(), ask_price_.data(), mid_price_.data(), last_price_.data(),
+	  last_price_threshold_.data(), mid_price_threshold_.data(),
+	  bid_delta_.data(), ask_delta_.data(), last_delta_.data()
+  };
+
+#if defined(__x86_64__)
+  const KernelBounds bounds{
+	  std::numeric_limits<WeightedPriceType>::max() / (100 * THRESHOLD_SCALE),
+	  std::numeric_limits<WeightedPriceType>::max() / std::max<ThresholdType>(max_threshold_, 1),
+	  std::numeric_limits<WeightedPriceType>::max() / 2
+  };
+
+  if (simd_level_ == SimdLevel::AVX512) {
+	revalueAvx512(columns, bounds, begin, end, breaches);
+  } else if (simd_level_ == SimdLevel::AVX2) {
+	revalueAvx2(columns, bounds, begin, end, breaches);
+  } else {
+	revalueScalar(columns, begin, end, breaches);
+  }
+#else
+  revalueScalar(columns, begin, end, breaches);
+#endif
+
+  for (const auto &basket_id : becoming_ready_) {
+	initBasketPrices(basket_id);
+	is_ready_[basket_id] = true;
+	not_ready_count_--;
+  }
+}
+
+BasketPriceStore::SimdLevel BasketPriceStore::getSupportedSimdLevel() {
+#if defined(__x86_64__)
+  if (__builtin_cpu_supports("avx512f") && __builtin_cpu_supports("avx512dq")) return SimdLevel::AVX512;
+  if (__builtin_cpu_supports("avx2")) return SimdLevel::AVX2;
+#endif
+  return SimdLevel::SCALAR;
+}
+
+void BasketPriceStore::setSimdLevel(const SimdLevel &simdLevel) {
+  simd_level_ = std::min(simdLevel, getSupportedSimdLevel());
+
+  // vector kernels take thresholds as unsigned, AVX2 even as 32 bit operands
+  if (min_threshold_ < 0 ||
+	  (simd_level_ == SimdLevel::AVX2 && max_threshold_ > std::numeric_limits<std::uint32_t>::max())) {
+	simd_level_ = SimdLevel::SCALAR;
+  }
+}
+}
@@ -1,193 +1,379 @@
 #include <utility>
 
-#include <future>
-#include <thread>
-#include <iostream>
-#include <sstream>
-
 #include "BasketPricer.h"
-#include "TickDataGenerator.h"
+#include "ThresholdEventSinks.h"
 
-#include "base/double_comparison.h"
+#include "base/fixed_point.h"
 
 namespace basket::pricer {
 BasketPricer::BasketPricer(const BasketsComposition &basketComposition,
-						   std::shared_ptr<IMarketDataProvider> marketDataProvider)
-	: basketComposition_(basketComposition), marketDataProvider_(marketDataProvider) {
+						   std::shared_ptr<IMarketDataProvider> marketDataProvider,
+						   const BasketPricerConfiguration &configuration)
+	: basketComposition_(basketComposition), instrument_list_(basketComposition.getInstrumentList()),
+	  marketDataProvider_(marketDataProvider),
+	  conflate_same_timestamp_(configuration.conflate_same_timestamp_),
+	  basket_update_broadcast_(configuration.basket_update_broadcast_),
+	  threshold_events_(configuration.threshold_queue_capacity_,
+						configuration.threshold_queue_overflow_policy_,
+						configuration.threshold_queue_wait_policy_),
+	  threshold_event_sink_(configuration.threshold_event_sink_) {
+  if (!threshold_event_sink_) threshold_event_sink_ = std::make_shared<TextThresholdEventSink>();
+
+  if (configuration.publish_basket_snapshots_) {
+	basket_snapshots_ = std::make_unique<BasketPriceSnapshots>();
+	basket_snapshots_->reset(basketComposition_.getBasketPriceData().size(), 0);
+  }
 }
 
-void BasketPricer::initMarketDataSubscription() {
+BasketPricer::~BasketPricer() {
+  stop();
+  delete pending_composition_.exchange(nullptr, std::memory_order_acquire);
+}
 
-  auto instrumentList = basketComposition_.getInstrumentList();
-  std::transform(instrumentList.begin(), instrumentList.end(),
-				 std::back_inserter(instrument_prices_),
-				 [](const auto &itr) {
-				   return InstrumentPrice{};
-				 });
-
-  auto init_basket_data_when_ready = [this](BasketPriceData &basket_price_data) {
-	bool is_basket_ready{true};
-
-	const auto &weights = basket_price_data.getAllWeights();
-	for (int i = 0; i < weights.size(); i++) {
-	  if (weights[i] > 0) {
-		const auto &instrument_price = instrument_prices_[i];
-		if (double_equal(instrument_price.getAskPrice(), 0) ||
-			double_equal(instrument_price.getBidPrice(), 0) ||
-			double_equal(instrument_price.getLastPrice(), 0)) {
-		  is_basket_ready = false;
-		  break;
-		}
-	  }
-	}
+void BasketPricer::reloadComposition(const BasketsComposition &basketComposition) {
+  auto composition = std::make_unique<BasketsComposition>(basketComposition.renumberInstruments(instrument_list_));
 
-	if (is_basket_ready) {
-	  // set initial prices...
-	  PriceType ask_weighted{0}, bid_weighted{0}, last_weighted{0};
+  // the pricing thread takes the pointer with an exchange too, whichever pointer comes back here was never seen by it
+  std::unique_ptr<BasketsComposition> superseded(
+	  pending_composition_.exchange(composition.release(), std::memory_order_acq_rel));
+}
 
-	  for (int i = 0; i < weights.size(); i++) {
-		if (weights[i] > 0) {
-		  const auto &instrument_price = instrument_prices_[i];
-		  ask_weighted += instrument_price.getAskPrice() * weights[i];
-		  bid_weighted += instrument_price.getBidPrice() * weights[i];
-		  last_weighted += instrument_price.getLastPrice() * weights[i];
-		}
-	  }
+void BasketPricer::adoptPendingComposition(const std::uint64_t &event_timestamp) {
+  std::unique_ptr<BasketsComposition> composition(pending_composition_.exchange(nullptr, std::memory_order_acquire));
+  if (!composition) return;
+
+  // the ticks held so far are priced with the composition they arrived under
+  if (!touched_instruments_.empty()) flushConflatedTicks();
+
+  // threshold events pushed so far view the names of the current composition
+  retired_compositions_.push_back({std::move(basketComposition_), threshold_events_.getWritePosition()});
+  basketComposition_ = std::move(*composition);
+
+  // readers move to the new basket ids along with the generation
+  const auto composition_generation = composition_generation_.load(std::memory_order_relaxed) + 1;
+  if (basket_snapshots_) {
+	basket_snapshots_->reset(basketComposition_.getBasketPriceData().size(), composition_generation);
+  }
 
-	  basket_price_data.setAskPrice(ask_weighted);
-	  basket_price_data.setBidPrice(bid_weighted);
-	  basket_price_data.setLastPrice(last_weighted);
-	  basket_price_data.setBasketToReady();
+  initBasketReadiness(event_timestamp);
+  if (conflate_same_timestamp_) touched_basket_positions_.assign(basketComposition_.getBasketPriceData().size(), -1);
+
+  const auto printed_position = printed_position_.load(std::memory_order_acquire);
+  std::erase_if(retired_compositions_, [&printed_position](const RetiredComposition &retired) {
+	return retired.retired_at_ <= printed_position;
+  });
+
+  composition_generation_.store(composition_generation, std::memory_order_release);
+}
+
+std::uint32_t BasketPricer::countMissingPriceFields(const BasketPriceData &basket_price_data) const {
+  std::uint32_t missing_price_fields{0};
+
+  for (const auto &constituent : basket_price_data.getConstituents()) {
+	if (constituent.weight_ > 0) {
+	  const auto &instrument_price = instrument_prices_[constituent.instrument_id_];
+	  missing_price_fields += (instrument_price.getAskPrice() == 0) +
+		  (instrument_price.getBidPrice() == 0) +
+		  (instrument_price.getLastPrice() == 0);
 	}
-  };
+  }
+
+  return missing_price_fields;
+}
 
-  // *** OnTickUpdate - Critical Fast Path Start ***
-  auto onTickUpdate = [this, init_basket_data_when_ready]
-	  (const TickEvent &tickEvent) {
+void BasketPricer::initBasketPrices(BasketPriceData &basket_price_data, const std::uint64_t &event_timestamp) {
+  WeightedPriceType ask_weighted{0}, bid_weighted{0}, last_weighted{0};
 
-	if (tickEvent.eventType_ == TickEventType::INVALID) [[unlikely]] {
-	  throw std::logic_error("Invalid TickEvent Type encountered!");
+  for (const auto &constituent : basket_price_data.getConstituents()) {
+	if (constituent.weight_ > 0) {
+	  const auto &instrument_price = instrument_prices_[constituent.instrument_id_];
+	  ask_weighted += instrument_price.getAskPrice() * constituent.weight_;
+	  bid_weighted += instrument_price.getBidPrice() * constituent.weight_;
+	  last_weighted += instrument_price.getLastPrice() * constituent.weight_;
 	}
+  }
 
-	// system generated instrument id starting from 0
-	auto instrumentId = basketComposition_.getInstrumentID(tickEvent.instrumentName_);
-	if (instrumentId < 0) [[unlikely]] return;
+  basket_price_data.setAskPrice(ask_weighted);
+  basket_price_data.setBidPrice(bid_weighted);
+  basket_price_data.setLastPrice(last_weighted);
+  basket_price_data.setBasketToReady();
+  publishBasketUpdate(basket_price_data, event_timestamp);
+}
 
-	auto &instrument_price = instrument_prices_[instrumentId];
+void BasketPricer::initBasketReadiness(const std::uint64_t &event_timestamp) {
+  auto &baskets_price_data = basketComposition_.getBasketPriceData();
+  missing_price_fields_.assign(baskets_price_data.size(), 0);
 
-	PriceType instrument_prev_price{0};
+  for (std::size_t basket_id = 0; basket_id < baskets_price_data.size(); basket_id++) {
+	auto &basket_price_data = baskets_price_data[basket_id];
+	const auto missing_price_fields = countMissingPriceFields(basket_price_data);
+	missing_price_fields_[basket_id] = missing_price_fields;
+	if (missing_price_fields == 0 && !basket_price_data.isReady()) initBasketPrices(basket_price_data, event_timestamp);
+  }
+}
 
-	if (tickEvent.eventType_ == TickEventType::ASK) {
-	  instrument_prev_price = instrument_price.getAskPrice();
-	  instrument_price.setAskPrice(tickEvent.price_);
-	} else if (tickEvent.eventType_ == TickEventType::BID) {
-	  instrument_prev_price = instrument_price.getBidPrice();
-	  instrument_price.setBidPrice(tickEvent.price_);
-	} else if (tickEvent.eventType_ == TickEventType::TRADE) {
-	  instrument_prev_price = instrument_price.getLastPrice();
-	  instrument_price.setLastPrice(tickEvent.price_);
-	}
+void BasketPricer::initMarketDataSubscription() {
 
-	// for each basket
+  instrument_prices_.assign(instrument_list_.size(), InstrumentPrice{});
 
+  // nothing is priced yet, so a basket without a positively weighted constituent waits for its first tick
+  missing_price_fields_.clear();
+  for (const auto &basket_price_data : basketComposition_.getBasketPriceData()) {
+	missing_price_fields_.push_back(countMissingPriceFields(basket_price_data));
+  }
 
-	for (auto &basket_price_data : basketComposition_.getBasketPriceData()) {
-	  if (!basket_price_data.isReady()) [[unlikely]] {
-		// Slowness in critical path only happens when market starts
-		init_basket_data_when_ready(basket_price_data);
-		continue;
-	  }
+  if (conflate_same_timestamp_) {
+	conflated_instruments_.assign(instrument_list_.size(), {});
+	touched_basket_positions_.assign(basketComposition_.getBasketPriceData().size(), -1);
+  }
+
+  marketDataProvider_->subscribeBatch([this](const std::span<const TickEvent> &ticks, const bool &endOfBatch) {
+	onTickBatch(ticks, endOfBatch);
+  }, std::vector<std::string>(instrument_list_));
+
+  threshold_printer_ = std::thread([this] { printThresholdEvents(); });
+}
+
+void BasketPricer::prefetchTick(const TickEvent &tickEvent) const {
+  const auto instrumentId = tickEvent.instrumentId_;
+  if (static_cast<std::size_t>(instrumentId) >= instrument_prices_.size()) [[unlikely]] return;
+
+  __builtin_prefetch(&instrument_prices_[instrumentId]);
+  __builtin_prefetch(basketComposition_.getInstrumentBaskets(instrumentId).data());
+}
+
+bool BasketPricer::checkThreshold(const BasketPriceData &basket_price_data,
+								  const TickEventType &eventType,
+								  const WeightedPriceType &prev_price,
+								  const WeightedPriceType &new_price,
+								  const ThresholdType &threshold) {
+  if (!isThresholdBreached(prev_price, new_price, threshold)) return false;
+
+  threshold_events_.push({
+	  basket_price_data.getBasketId(),
+	  eventType,
+	  prev_price,
+	  new_price,
+	  deltaPercentage(prev_price, new_price),
+	  basket_price_data.getBasketName()
+  });
+  return true;
+}
 
-	  const auto &weight = basket_price_data.getInstrumentWeighting(instrumentId);
-	  if (!double_equal(weight, 0)) {
-
-		auto basket_weighted_delta = (tickEvent.price_ - instrument_prev_price) * weight;
-
-		if (tickEvent.eventType_ == TickEventType::TRADE) {
-		  const PriceType prev_last_price = basket_price_data.getLastPrice();
-		  const PriceType new_last_price = prev_last_price + basket_weighted_delta;
-		  basket_price_data.setLastPrice(new_last_price);
-
-		  double delta_pct = (std::fabs(new_last_price - prev_last_price) / prev_last_price) * 100.0;
-		  if (delta_pct > basket_price_data.getBasketConfiguration().lastPriceThreshold_) {
-			std::lock_guard<std::mutex> lg(threshold_message_mutex_);
-			threshold_messages_.push_back({
-											  basket_price_data.getBasketId(),
-											  tickEvent.eventType_,
-											  prev_last_price,
-											  new_last_price,
-											  delta_pct
-										  });
-			threshold_message_cv_.notify_one();
-		  }
+void BasketPricer::conflateTick(const TickEvent &tickEvent) {
+  if (tickEvent.eventType_ == TickEventType::INVALID) [[unlikely]] {
+	throw std::logic_error("Invalid TickEvent Type encountered!");
+  }
+
+  const auto latency_start = tick_latency_.start();
+  bool breached{false};
+
+  if (pending_composition_.load(std::memory_order_relaxed) != nullptr) [[unlikely]] {
+	adoptPendingComposition(tickEvent.event_timestamp_);
+  }
+
+  // the first tick of the next timestamp prices the previous one, its cost is recorded against that tick
+  if (tickEvent.event_timestamp_ != conflated_timestamp_ && !touched_instruments_.empty()) {
+	breached = flushConflatedTicks();
+  }
+  conflated_timestamp_ = tickEvent.event_timestamp_;
+  tick_sequence_++;
+  conflated_ticks_.store(conflated_ticks_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+
+  const auto instrumentId = tickEvent.instrumentId_;
+  if (static_cast<std::size_t>(instrumentId) >= instrument_prices_.size()) [[unlikely]] return;
+
+  auto &instrument_price = instrument_prices_[instrumentId];
+  auto &conflated_instrument = conflated_instruments_[instrumentId];
+  if (!conflated_instrument.touched_) {
+	conflated_instrument.touched_ = true;
+	conflated_instrument.start_price_ = instrument_price;
+	touched_instruments_.push_back(instrumentId);
+  }
+
+  if (tickEvent.eventType_ == TickEventType::ASK) {
+	instrument_price.setAskPrice(tickEvent.price_);
+  } else if (tickEvent.eventType_ == TickEventType::BID) {
+	instrument_price.setBidPrice(tickEvent.price_);
+  } else if (tickEvent.eventType_ == TickEventType::TRADE) {
+	instrument_price.setLastPrice(tickEvent.price_);
+  }
+
+  tick_latency_.record(latency_start, tickEvent.eventType_, breached);
+}
+
+bool BasketPricer::revalueBasket(BasketPriceData &basket_price_data,
+								 const WeightedPriceType &ask_delta,
+								 const WeightedPriceType &bid_delta,
+								 const WeightedPriceType &last_delta) {
+  bool breached{false};
+
+  if (ask_delta != 0 || bid_delta != 0) {
+	const WeightedPriceType prev_mid_price = basket_price_data.getMidPrice();
+	if (ask_delta != 0) basket_price_data.setAskPrice(basket_price_data.getAskPrice() + ask_delta);
+	if (bid_delta != 0) basket_price_data.setBidPrice(basket_price_data.getBidPrice() + bid_delta);
+
+	// reported as a bid event when the bid moved, as an ask event otherwise
+	breached |= checkThreshold(basket_price_data,
+							   bid_delta != 0 ? TickEventType::BID : TickEventType::ASK,
+							   prev_mid_price,
+							   basket_price_data.getMidPrice(),
+							   basket_price_data.getBasketConfiguration().midPriceThreshold_);
+  }
+
+  if (last_delta != 0) {
+	const WeightedPriceType prev_last_price = basket_price_data.getLastPrice();
+	basket_price_data.setLastPrice(prev_last_price + last_delta);
+
+	breached |= checkThreshold(basket_price_data, TickEventType::TRADE, prev_last_price,
+							   basket_price_data.getLastPrice(),
+							   basket_price_data.getBasketConfiguration().lastPriceThreshold_);
+  }
+
+  // the timestamp being flushed
+  publishBasketUpdate(basket_price_data, conflated_timestamp_);
+  return breached;
+}
 
+bool BasketPricer::flushConflatedTicks() {
+  bool breached{false};
+  std::uint64_t instrument_updates{0}, basket_revaluations{0};
+
+  auto &baskets_price_data = basketComposition_.getBasketPriceData();
+
+  // with a single instrument in the timestamp no basket is reached twice, its baskets are revalued straight away
+  const bool single_instrument = touched_instruments_.size() == 1;
+
+  // net change of each touched instrument, accumulated into the baskets holding it
+  for (const auto instrumentId : touched_instruments_) {
+	auto &conflated_instrument = conflated_instruments_[instrumentId];
+	conflated_instrument.touched_ = false;
+
+	const auto &start_price = conflated_instrument.start_price_;
+	const auto &instrument_price = instrument_prices_[instrumentId];
+
+	const PriceType ask_delta = instrument_price.getAskPrice() - start_price.getAskPrice();
+	const PriceType bid_delta = instrument_price.getBidPrice() - start_price.getBidPrice();
+	const PriceType last_delta = instrument_price.getLastPrice() - start_price.getLastPrice();
+	if (ask_delta == 0 && bid_delta == 0 && last_delta == 0) continue;
+	instrument_updates++;
+
+	// as per tick, +1 per field getting its first price, -1 per field cleared by a price of zero
+	const int priced_fields_delta =
+		(start_price.getAskPrice() == 0) - (instrument_price.getAskPrice() == 0) +
+		(start_price.getBidPrice() == 0) - (instrument_price.getBidPrice() == 0) +
+		(start_price.getLastPrice() == 0) - (instrument_price.getLastPrice() == 0);
+
+	for (const auto &[basket_id, weight] : basketComposition_.getInstrumentBaskets(instrumentId)) {
+	  if (single_instrument) {
+		auto &basket_price_data = baskets_price_data[basket_id];
+		if (basket_price_data.isReady()) [[likely]] {
+		  breached |= revalueBasket(basket_price_data, ask_delta * weight, bid_delta * weight, last_delta * weight);
+		  basket_revaluations++;
 		} else {
-		  const PriceType prev_mid_price = basket_price_data.getMidPrice();
-
-		  if (tickEvent.eventType_ == TickEventType::ASK) {
-			basket_price_data.setAskPrice(basket_price_data.getAskPrice() + basket_weighted_delta);
-		  } else if (tickEvent.eventType_ == TickEventType::BID) {
-			basket_price_data.setBidPrice(basket_price_data.getBidPrice() + basket_weighted_delta);
-		  }
-
-		  const auto new_mid_price = basket_price_data.getMidPrice();
-		  double delta_pct = (std::fabs(new_mid_price - prev_mid_price) / prev_mid_price) * 100.0;
-
-		  if (delta_pct > basket_price_data.getBasketConfiguration().midPriceThreshold_) {
-			std::lock_guard<std::mutex> lg(threshold_message_mutex_);
-			threshold_messages_.push_back({
-											  basket_price_data.getBasketId(),
-											  tickEvent.eventType_,
-											  prev_mid_price,
-											  new_mid_price,
-											  delta_pct
-										  });
-			threshold_message_cv_.notify_one();
-		  }
+		  auto &missing_price_fields = missing_price_fields_[basket_id];
+		  if (weight > 0) missing_price_fields -= priced_fields_delta;
+		  if (missing_price_fields == 0) initBasketPrices(basket_price_data, conflated_timestamp_);
 		}
+		continue;
 	  }
-	}
-  };
-  // *** Critical Fast Path Complete ***
 
-  threshold_messages_.reserve(THRESHOLD_MESSAGES_SIZE);
+	  // readiness is settled with the deltas, after every instrument of the timestamp, a ready basket stays ready
+	  if (priced_fields_delta != 0 && weight > 0 && !baskets_price_data[basket_id].isReady()) [[unlikely]] {
+		missing_price_fields_[basket_id] -= priced_fields_delta;
+	  }
 
-  marketDataProvider_->subscribe(onTickUpdate,
-								 std::move(basketComposition_.getInstrumentList()));
+	  auto &touched_position = touched_basket_positions_[basket_id];
+	  if (touched_position < 0) {
+		touched_position = static_cast<int>(touched_baskets_.size());
+		touched_baskets_.push_back({basket_id});
+	  }
+	  auto &touched_basket = touched_baskets_[touched_position];
+	  touched_basket.ask_delta_ += ask_delta * weight;
+	  touched_basket.bid_delta_ += bid_delta * weight;
+	  touched_basket.last_delta_ += last_delta * weight;
+	}
+  }
+  touched_instruments_.clear();
 
-  std::thread threshold_breach_printer([this] {
-	while (true) {
-	  std::vector<ThresholdEvent> outstanding_messages_;
-	  outstanding_messages_.reserve(THRESHOLD_MESSAGES_SIZE);
+  // each affected basket revalued once, each of its thresholds checked once
+  for (const auto &touched_basket : touched_baskets_) {
+	touched_basket_positions_[touched_basket.basket_id_] = -1;
+	auto &basket_price_data = baskets_price_data[touched_basket.basket_id_];
 
-	  {
-		std::unique_lock<std::mutex> ul(threshold_message_mutex_);
-		threshold_message_cv_.wait(ul, [this] { return !threshold_messages_.empty(); });
-		outstanding_messages_.swap(threshold_messages_);
+	if (!basket_price_data.isReady()) [[unlikely]] {
+	  if (missing_price_fields_[touched_basket.basket_id_] == 0) {
+		initBasketPrices(basket_price_data, conflated_timestamp_);
 	  }
+	  continue;
+	}
 
-	  std::ostringstream oss;
+	if (touched_basket.ask_delta_ == 0 && touched_basket.bid_delta_ == 0 && touched_basket.last_delta_ == 0) continue;
+	breached |= revalueBasket(basket_price_data, touched_basket.ask_delta_, touched_basket.bid_delta_,
+							  touched_basket.last_delta_);
+	basket_revaluations++;
+  }
+  touched_baskets_.clear();
+
+  conflated_timestamps_.store(conflated_timestamps_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+  conflated_instrument_updates_.store(conflated_instrument_updates_.load(std::memory_order_relaxed) + instrument_updates,
+									  std::memory_order_relaxed);
+  conflated_basket_revaluations_.store(
+	  conflated_basket_revaluations_.load(std::memory_order_relaxed) + basket_revaluations,
+	  std::memory_order_relaxed);
+
+  return breached;
+}
 
-	  for (decltype(outstanding_messages_.size()) size = 0; size < outstanding_messages_.size(); size++) {
-		const auto &msg = outstanding_messages_[size];
+BasketPriceSnapshot BasketPricer::getBasketSnapshot(const int &basket_id) const {
+  if (!basket_snapshots_) throw std::logic_error("Basket snapshots are not published, see publish_basket_snapshots_");
+  return basket_snapshots_->read(basket_id);
+}
 
-		const auto &basketName = basketComposition_.getBasketPriceData()[msg.basket_id_].getBasketName();
-		oss << basketName;
+std::vector<BasketPriceSnapshot> BasketPricer::getAllSnapshots() const {
+  std::vector<BasketPriceSnapshot> snapshots;
+  getAllSnapshots(snapshots);
+  return snapshots;
+}
 
-		if (msg.event_type_ == TickEventType::TRADE) {
-		  oss << " PrevLastPrice " << msg.prev_price_
-			  << " NewLastPrice " << msg.new_price_;
-		} else {
-		  oss << " PrevMidPrice " << msg.prev_price_
-			  << " NewMidPrice " << msg.new_price_;
-		}
-		oss << " DeltaPct " << msg.delta_pct_ << std::endl;
+void BasketPricer::getAllSnapshots(std::vector<BasketPriceSnapshot> &snapshots) const {
+  if (!basket_snapshots_) throw std::logic_error("Basket snapshots are not published, see publish_basket_snapshots_");
+  basket_snapshots_->readAll(snapshots);
+}
 
-		std::cout << oss.str();
-	  }
+void BasketPricer::stop() {
+  if (!threshold_printer_.joinable()) return;
+
+  // the last timestamp has no successor to price it
+  if (!touched_instruments_.empty()) flushConflatedTicks();
+  if (basket_update_broadcast_) basket_update_broadcast_->close();
+
+  threshold_events_.close();
+  threshold_printer_.join();
+}
+
+void BasketPricer::printThresholdEvents() {
+  std::vector<ThresholdEvent> outstanding_messages;
+  outstanding_messages.reserve(THRESHOLD_MESSAGES_SIZE);
+
+  while (true) {
+	threshold_events_.waitForData();
+
+	outstanding_messages.clear();
+	if (threshold_events_.popBatch(outstanding_messages, THRESHOLD_MESSAGES_SIZE) == 0) {
+	  if (threshold_events_.isClosed() && threshold_events_.isEmpty()) break;
+	  continue;
 	}
-  });
-  threshold_breach_printer.detach();
 
+	threshold_event_sink_->write(outstanding_messages);
+
+	// the names viewed by the batch are no longer needed, the compositions they belong to may go
+	printed_position_.store(threshold_events_.getReadPosition(), std::memory_order_release);
+
+	// bursts go out in large writes, the output is flushed as soon as the printer catches up
+	if (threshold_events_.isEmpty()) threshold_event_sink_->flush();
+  }
+
+  threshold_event_sink_->flush();
+}
 }
-}
\ No newline at end of file
@@ -0,0 +1,215 @@
+#include <algorithm>
+#include <filesystem>
+#include <fstream>
+#include <memory>
+#include <sstream>
+#include <stdexcept>
+#include <vector>
+
+#include "BasketSnapshot.h"
+
+#include "base/mapped_file.h"
+
+namespace basket::pricer {
+namespace {
+std::uint64_t alignSection(const std::uint64_t &offset) {
+  return (offset + BASKET_SNAPSHOT_ALIGNMENT - 1) / BASKET_SNAPSHOT_ALIGNMENT * BASKET_SNAPSHOT_ALIGNMENT;
+}
+
+[[noreturn]] void throwInvalidSnapshot(const std::string &path, const std::string &reason) {
+  std::ostringstream oss;
+  oss << "Invalid composition snapshot " << path << " - " << reason;
+  throw std::runtime_error(oss.str());
+}
+
+// the sections of a mapped snapshot, bounds checked against the file
+struct MappedSnapshot {
+  const std::string &path_;
+  const char *data_;
+  std::size_t size_;
+  const BasketSnapshotHeader &header_;
+
+  template<typename T>
+  [[nodiscard]] std::span<const T> view(const BasketSnapshotSection &section, const std::uint64_t &count) const {
+	const auto &entry = header_.sections_[section];
+	if (entry.offset_ % BASKET_SNAPSHOT_ALIGNMENT != 0 || entry.offset_ > size_ ||
+		entry.size_ > size_ - entry.offset_ || entry.size_ != count * sizeof(T)) {
+	  std::ostringstream oss;
+	  oss << "malformed section " << section;
+	  throwInvalidSnapshot(path_, oss.str());
+	}
+	return {reinterpret_cast<const T *>(data_ + entry.offset_), count};
+  }
+};
+
+// offsets delimiting `count` ranges of an array of `size` elements
+bool isValidOffsets(const std::span<const std::uint64_t> &offsets, const std::uint64_t &size) {
+  if (offsets.front() != 0 || offsets.back() != size) return false;
+  return std::is_sorted(offsets.begin(), offsets.end());
+}
+}
+
+void BasketsComposition::writeSnapshot(const std::string &snapshotPath) const {
+  BasketSnapshotHeader header;
+  std::memcpy(header.magic_, BASKET_SNAPSHOT_MAGIC, sizeof(header.magic_));
+  header.version_ = BASKET_SNAPSHOT_VERSION;
+  header.section_count_ = SECTION_COUNT;
+  header.weight_scale_ = WEIGHT_SCALE;
+  header.threshold_scale_ = THRESHOLD_SCALE;
+  header.instrument_count_ = getInstrumentCount();
+  header.basket_count_ = layout_.basket_configurations_.size();
+  header.constituent_count_ = layout_.basket_constituents_.size();
+
+  const std::size_t section_sizes[SECTION_COUNT] = {
+	  layout_.instrument_name_offsets_.size_bytes(),
+	  layout_.instrument_names_.size_bytes(),
+	  layout_.instruments_by_name_.size_bytes(),
+	  layout_.basket_name_offsets_.size_bytes(),
+	  layout_.basket_names_.size_bytes(),
+	  layout_.basket_configurations_.size_bytes(),
+	  layout_.basket_constituent_offsets_.size_bytes(),
+	  layout_.basket_constituents_.size_bytes(),
+	  layout_.instrument_basket_offsets_.size_bytes(),
+	  layout_.instrument_baskets_.size_bytes()};
+
+  std::uint64_t offset = alignSection(sizeof(BasketSnapshotHeader));
+  for (int section = 0; section < SECTION_COUNT; section++) {
+	header.sections_[section] = {offset, section_sizes[section]};
+	offset = alignSection(offset + section_sizes[section]);
+  }
+  header.file_size_ = offset;
+
+  // zero filled, hence so are the alignment gaps and the padding of the structs, keeping the image deterministic
+  std::vector<char> image(header.file_size_, 0);
+
+  auto copyArray = [&image, &header](const BasketSnapshotSection &section, const auto &values) {
+	std::memcpy(image.data() + header.sections_[section].offset_, values.data(), values.size_bytes());
+  };
+  copyArray(INSTRUMENT_NAME_OFFSETS, layout_.instrument_name_offsets_);
+  copyArray(INSTRUMENT_NAMES, layout_.instrument_names_);
+  copyArray(INSTRUMENTS_BY_NAME, layout_.instruments_by_name_);
+  copyArray(BASKET_NAME_OFFSETS, layout_.basket_name_offsets_);
+  copyArray(BASKET_NAMES, layout_.basket_names_);
+  copyArray(BASKET_CONSTITUENT_OFFSETS, layout_.basket_constituent_offsets_);
+  copyArray(INSTRUMENT_BASKET_OFFSETS, layout_.instrument_basket_offsets_);
+
+  auto *configurations =
+	  reinterpret_cast<BasketConfiguration *>(image.data() + header.sections_[BASKET_CONFIGURATIONS].offset_);
+  for (std::size_t i = 0; i < layout_.basket_configurations_.size(); i++) {
+	configurations[i].lastPriceThreshold_ = layout_.basket_configurations_[i].lastPriceThreshold_;
+	configurations[i].midPriceThreshold_ = layout_.basket_configurations_[i].midPriceThreshold_;
+  }
+
+  auto *constituents =
+	  reinterpret_cast<BasketConstituent *>(image.data() + header.sections_[BASKET_CONSTITUENTS].offset_);
+  for (std::size_t i = 0; i < layout_.basket_constituents_.size(); i++) {
+	constituents[i].instrument_id_ = layout_.basket_constituents_[i].instrument_id_;
+	constituents[i].weight_ = layout_.basket_constituents_[i].weight_;
+  }
+
+  auto *instrument_baskets =
+	  reinterpret_cast<BasketWeight *>(image.data() + header.sections_[INSTRUMENT_BASKETS].offset_);
+  for (std::size_t i = 0; i < layout_.instrument_baskets_.size(); i++) {
+	instrument_baskets[i].basket_id_ = layout_.instrument_baskets_[i].basket_id_;
+	instrument_baskets[i].weight_ = layout_.instrument_baskets_[i].weight_;
+  }
+
+  header.checksum_ = basketSnapshotChecksum(image.data() + sizeof(BasketSnapshotHeader),
+											image.size() - sizeof(BasketSnapshotHeader));
+  std::memcpy(image.data(), &header, sizeof(header));
+
+  // written aside then renamed over, a process mapping the previous snapshot keeps reading it whole
+  const std::string written_path = snapshotPath + ".tmp";
+  std::ofstream snapshot(written_path, std::ios::binary | std::ios::trunc);
+  snapshot.write(image.data(), static_cast<std::streamsize>(image.size()));
+  snapshot.close();
+
+  std::error_code error;
+  if (snapshot) std::filesystem::rename(written_path, snapshotPath, error);
+  if (!snapshot || error) {
+	std::filesystem::remove(written_path, error);
+	std::ostringstream oss;
+	oss << "Failed to write composition snapshot " << snapshotPath;
+	throw std::runtime_error(oss.str());
+  }
+}
+
+[[nodiscard]] bool BasketsComposition::isSnapshot(const std::string &path) {
+  std::ifstream file(path, std::ios::binary);
+  char magic[sizeof(BASKET_SNAPSHOT_MAGIC)]{};
+  if (!file.read(magic, sizeof(magic))) return false;
+  return std::memcmp(magic, BASKET_SNAPSHOT_MAGIC, sizeof(magic)) == 0;
+}
+
+[[nodiscard]] BasketsComposition BasketsComposition::loadSnapshot(const std::string &snapshotPath) {
+  auto mapping = std::make_shared<const MappedFile>(snapshotPath, MADV_WILLNEED);
+  const char *data = mapping->data();
+  const std::size_t size = mapping->size();
+
+  if (size < sizeof(BasketSnapshotHeader)) throwInvalidSnapshot(snapshotPath, "truncated header");
+
+  BasketSnapshotHeader header;
+  std::memcpy(&header, data, sizeof(header));
+
+  if (std::memcmp(header.magic_, BASKET_SNAPSHOT_MAGIC, sizeof(header.magic_)) != 0) {
+	throwInvalidSnapshot(snapshotPath, "not a composition snapshot");
+  }
+  if (header.version_ != BASKET_SNAPSHOT_VERSION || header.section_count_ != SECTION_COUNT) {
+	std::ostringstream oss;
+	oss << "unsupported version " << header.version_ << ", expected " << BASKET_SNAPSHOT_VERSION;
+	throwInvalidSnapshot(snapshotPath, oss.str());
+  }
+  if (header.weight_scale_ != WEIGHT_SCALE || header.threshold_scale_ != THRESHOLD_SCALE) {
+	std::ostringstream oss;
+	oss << "written with weight scale " << header.weight_scale_ << " and threshold scale "
+		<< header.threshold_scale_ << ", expected " << WEIGHT_SCALE << " and " << THRESHOLD_SCALE;
+	throwInvalidSnapshot(snapshotPath, oss.str());
+  }
+  if (header.file_size_ != size) throwInvalidSnapshot(snapshotPath, "file size does not match the header");
+
+  if (header.checksum_ != basketSnapshotChecksum(data + sizeof(header), size - sizeof(header))) {
+	throwInvalidSnapshot(snapshotPath, "checksum mismatch");
+  }
+
+  const auto instrument_count = header.instrument_count_;
+  const auto basket_count = header.basket_count_;
+  const auto constituent_count = header.constituent_count_;
+  const auto instrument_names_size = header.sections_[INSTRUMENT_NAMES].size_;
+  const auto basket_names_size = header.sections_[BASKET_NAMES].size_;
+
+  const MappedSnapshot snapshot{snapshotPath, data, size, header};
+  Layout layout;
+  layout.instrument_name_offsets_ = snapshot.view<std::uint64_t>(INSTRUMENT_NAME_OFFSETS, instrument_count + 1);
+  layout.instrument_names_ = snapshot.view<char>(INSTRUMENT_NAMES, instrument_names_size);
+  layout.instruments_by_name_ = snapshot.view<std::int32_t>(INSTRUMENTS_BY_NAME, instrument_count);
+  layout.basket_name_offsets_ = snapshot.view<std::uint64_t>(BASKET_NAME_OFFSETS, basket_count + 1);
+  layout.basket_names_ = snapshot.view<char>(BASKET_NAMES, basket_names_size);
+  layout.basket_configurations_ = snapshot.view<BasketConfiguration>(BASKET_CONFIGURATIONS, basket_count);
+  layout.basket_constituent_offsets_ = snapshot.view<std::uint64_t>(BASKET_CONSTITUENT_OFFSETS, basket_count + 1);
+  layout.basket_constituents_ = snapshot.view<BasketConstituent>(BASKET_CONSTITUENTS, constituent_count);
+  layout.instrument_basket_offsets_ = snapshot.view<std::uint64_t>(INSTRUMENT_BASKET_OFFSETS, instrument_count + 1);
+  layout.instrument_baskets_ = snapshot.view<BasketWeight>(INSTRUMENT_BASKETS, constituent_count);
+
+  // the structure is trusted no further than the ids and offsets used as indexes
+  if (!isValidOffsets(layout.instrument_name_offsets_, layout.instrument_names_.size()) ||
+	  !isValidOffsets(layout.basket_name_offsets_, layout.basket_names_.size()) ||
+	  !isValidOffsets(layout.basket_constituent_offsets_, constituent_count) ||
+	  !isValidOffsets(layout.instrument_basket_offsets_, constituent_count)) {
+	throwInvalidSnapshot(snapshotPath, "malformed offsets");
+  }
+  auto isInstrumentId = [&instrument_count](const std::int32_t &id) { return id >= 0 && id < instrument_count; };
+  if (!std::all_of(layout.instruments_by_name_.begin(), layout.instruments_by_name_.end(), isInstrumentId) ||
+	  !std::all_of(layout.basket_constituents_.begin(), layout.basket_constituents_.end(),
+				   [&](const BasketConstituent &constituent) { return isInstrumentId(constituent.instrument_id_); }) ||
+	  !std::all_of(layout.instrument_baskets_.begin(), layout.instrument_baskets_.end(),
+				   [&](const BasketWeight &weight) { return weight.basket_id_ >= 0 && weight.basket_id_ < basket_count; })) {
+	throwInvalidSnapshot(snapshotPath, "instrument or basket id out of range");
+  }
+
+  BasketsComposition composition;
+  composition.layout_ = layout;
+  composition.storage_ = std::move(mapping);
+  composition.initBasketPriceData();
+  return composition;
+}
+}
@@ -0,0 +1,130 @@
+#include <bit>
+#include <utility>
+
+#include "BasketUpdateBroadcast.h"
+
+#include "base/seqlock_ring.h"
+
+namespace basket::pricer {
+BasketUpdateBroadcast::BasketUpdateBroadcast(const std::size_t &capacity)
+	: mask_(std::bit_ceil(capacity < 2 ? std::size_t{2} : capacity) - 1),
+	  slots_(std::make_unique<Slot[]>(mask_ + 1)) {
+}
+
+BasketUpdateSubscriber::BasketUpdateSubscriber(std::shared_ptr<const BasketUpdateBroadcast> broadcast,
+											   CallbackFunc &&callback,
+											   const BasketUpdateSubscription &subscription)
+	: broadcast_(std::move(broadcast)), callback_(std::move(callback)), subscription_(subscription) {
+  if (subscription_.ticks_per_window_ == 0) subscription_.ticks_per_window_ = 1;
+
+  position_ = broadcast_->getPublishedCount();
+  batch_.reserve(READ_BATCH_SIZE);
+  next_delivery_ = std::chrono::steady_clock::now() + subscription_.interval_;
+}
+
+bool BasketUpdateSubscriber::tryRead(BasketUpdate &update) {
+  const auto &broadcast = *broadcast_;
+  return tryReadSeqlockSlot(position_, gap_count_, broadcast.getCapacity(),
+							[&broadcast](const std::uint64_t &position) -> const BasketUpdateBroadcast::Slot & {
+							  return broadcast.getSlot(position);
+							},
+							[&update](const BasketUpdateBroadcast::Slot &slot) { update = slot.update_; },
+							[&broadcast] { return broadcast.getPublishedCount(); });
+}
+
+std::size_t BasketUpdateSubscriber::poll() {
+  // loaded before reading, an empty read then means every update of the ticks priced up to it was read
+  const std::uint64_t priced_ticks =
+	  (subscription_.conflation_ == BasketUpdateConflation::LATEST_PER_TICKS) ? broadcast_->getTickSequence() : 0;
+
+  batch_.clear();
+  BasketUpdate update;
+  while (batch_.size() < READ_BATCH_SIZE && tryRead(update)) batch_.push_back(update);
+  const std::size_t read = batch_.size();
+  if (read > 0) read_count_.store(read_count_.load(std::memory_order_relaxed) + read, std::memory_order_relaxed);
+
+  switch (subscription_.conflation_) {
+	case BasketUpdateConflation::EVERY_UPDATE:
+	  if (read > 0) {
+		callback_(batch_);
+		delivered_count_.store(delivered_count_.load(std::memory_order_relaxed) + read, std::memory_order_relaxed);
+	  }
+	  break;
+
+	case BasketUpdateConflation::LATEST_PER_TICKS:
+	  for (const auto &batch_update : batch_) {
+		// the first update of a later window closes the current one
+		const auto tick_window = batch_update.tick_sequence_ / subscription_.ticks_per_window_;
+		if (tick_window != tick_window_) {
+		  flush();
+		  tick_window_ = tick_window;
+		}
+		hold(batch_update);
+	  }
+
+	  // a quiet pricer closes the window too once it priced past it, later updates count more ticks than it priced
+	  if (read == 0 && (priced_ticks + 1) / subscription_.ticks_per_window_ > tick_window_) flush();
+	  break;
+
+	case BasketUpdateConflation::LATEST_PER_INTERVAL:
+	  for (const auto &batch_update : batch_) hold(batch_update);
+
+	  // checked on empty polls too, a quiet pricer still closes the slice
+	  if (const auto now = std::chrono::steady_clock::now(); now >= next_delivery_) {
+		flush();
+		next_delivery_ = now + subscription_.interval_;
+	  }
+	  break;
+  }
+  return read;
+}
+
+void BasketUpdateSubscriber::hold(const BasketUpdate &update) {
+  // basket ids are those of the update's composition, the updates held for the previous one are delivered first
+  if (update.composition_generation_ != held_generation_) {
+	flush();
+	held_generation_ = update.composition_generation_;
+  }
+
+  const auto basket_id = static_cast<std::size_t>(update.basket_id_);
+  if (basket_id >= held_positions_.size()) held_positions_.resize(basket_id + 1, -1);
+
+  auto &held_position = held_positions_[basket_id];
+  if (held_position < 0) {
+	held_position = static_cast<int>(held_.size());
+	held_.push_back(update);
+  } else {
+	held_[held_position] = update;
+  }
+}
+
+void BasketUpdateSubscriber::flush() {
+  if (held_.empty()) return;
+
+  callback_(held_);
+  delivered_count_.store(delivered_count_.load(std::memory_order_relaxed) + held_.size(), std::memory_order_relaxed);
+
+  for (const auto &update : held_) held_positions_[update.basket_id_] = -1;
+  held_.clear();
+}
+
+void BasketUpdateSubscriber::run() {
+  PollBackoff backoff;
+  while (!stopped_.load(std::memory_order_acquire)) {
+	if (poll() > 0) {
+	  backoff.reset();
+	  continue;
+	}
+
+	// closed after the last update was published, nothing read since means every update was
+	if (broadcast_->isClosed()) {
+	  if (poll() == 0) break;
+	  continue;
+	}
+
+	backoff.wait();
+  }
+
+  flush();
+}
+}
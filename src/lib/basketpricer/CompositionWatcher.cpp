@@ -0,0 +1,112 @@
+#include <iostream>
+#include <stdexcept>
+#include <system_error>
+#include <utility>
+
+#include "CompositionWatcher.h"
+
+namespace basket::pricer {
+CompositionWatcher::CompositionWatcher(std::vector<std::string> compositionPaths,
+									   ReloadFunc onReload,
+									   const CompositionWatcherConfiguration &configuration)
+	: composition_paths_(std::move(compositionPaths)), on_reload_(std::move(onReload)),
+	  configuration_(configuration) {
+  if (composition_paths_.empty() || composition_paths_.size() > 2) {
+	throw std::invalid_argument("A composition is made of a basket data and a basket config file, or a snapshot");
+  }
+}
+
+CompositionWatcher::~CompositionWatcher() {
+  stop();
+}
+
+void CompositionWatcher::start() {
+  if (thread_.joinable()) return;
+
+  stopping_ = false;
+  loaded_versions_ = readFileVersions();
+  thread_ = std::thread([this] { run(); });
+}
+
+void CompositionWatcher::stop() {
+  {
+	std::lock_guard<std::mutex> lock(mutex_);
+	stopping_ = true;
+  }
+  wake_up_.notify_one();
+  if (thread_.joinable()) thread_.join();
+}
+
+void CompositionWatcher::trigger() {
+  {
+	std::lock_guard<std::mutex> lock(mutex_);
+	triggered_ = true;
+  }
+  wake_up_.notify_one();
+}
+
+std::uint64_t CompositionWatcher::getReloadCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return reload_count_;
+}
+
+std::uint64_t CompositionWatcher::getFailedReloadCount() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return failed_reload_count_;
+}
+
+std::vector<CompositionWatcher::FileVersion> CompositionWatcher::readFileVersions() const {
+  std::vector<FileVersion> versions;
+  versions.reserve(composition_paths_.size());
+
+  // a file being replaced may be briefly missing, it then reads as a version of its own
+  for (const auto &path : composition_paths_) {
+	std::error_code error;
+	FileVersion version;
+	version.modified_ = std::filesystem::last_write_time(path, error);
+	if (!error) version.size_ = std::filesystem::file_size(path, error);
+	versions.push_back(error ? FileVersion{} : version);
+  }
+  return versions;
+}
+
+void CompositionWatcher::reload() {
+  bool reloaded{false};
+  try {
+	const auto composition = composition_paths_.size() == 1
+		? BasketsComposition::loadSnapshot(composition_paths_[0])
+		: BasketsComposition(composition_paths_[0], composition_paths_[1]);
+	on_reload_(composition);
+	reloaded = true;
+  }
+  catch (const std::exception &e) {
+	std::cerr << "Composition reload failed - " << e.what() << std::endl;
+  }
+
+  std::lock_guard<std::mutex> lock(mutex_);
+  (reloaded ? reload_count_ : failed_reload_count_)++;
+}
+
+void CompositionWatcher::run() {
+  while (true) {
+	bool triggered{false};
+	{
+	  std::unique_lock<std::mutex> lock(mutex_);
+	  wake_up_.wait_for(lock, configuration_.poll_interval_, [this] { return stopping_ || triggered_; });
+	  if (stopping_) return;
+	  std::swap(triggered, triggered_);
+	}
+
+	// a change is reloaded once the files read the same a moment later, so a file still being written is not picked up
+	auto versions = readFileVersions();
+	if (!triggered && versions == loaded_versions_) continue;
+	if (!triggered) {
+	  std::this_thread::sleep_for(configuration_.poll_interval_ / 10);
+	  if (readFileVersions() != versions) continue;
+	}
+
+	loaded_versions_ = std::move(versions);
+	reload();
+  }
+}
+}
@@ -0,0 +1,231 @@
+#include <algorithm>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+#include <thread>
+
+#include "ShardedBasketPricer.h"
+#include "StaticTickPipeline.h"
+#include "ThresholdEventSinks.h"
+
+#include "base/thread_affinity.h"
+
+namespace basket::pricer {
+ShardedBasketPricer::ShardedBasketPricer(const BasketsComposition &basketComposition,
+										 std::shared_ptr<IMarketDataProvider> marketDataProvider,
+										 const ShardedBasketPricerConfiguration &configuration)
+	: configuration_(configuration), marketDataProvider_(marketDataProvider),
+	  instrument_list_(basketComposition.getInstrumentList()) {
+
+  int shard_count = configuration_.shard_count_;
+  if (shard_count <= 0) shard_count = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+  shard_count = std::max(1, std::min(shard_count, static_cast<int>(basketComposition.getBasketPriceData().size())));
+
+  if (configuration_.shard_pricer_configuration_.threshold_event_sink_) {
+	throw std::invalid_argument("A threshold event sink serves a single pricer, use threshold_event_sink_factory_");
+  }
+  if (configuration_.shard_pricer_configuration_.basket_update_broadcast_) {
+	throw std::invalid_argument("A basket update broadcast has a single writer, it cannot be shared by the shards");
+  }
+
+  // without a factory every shard prints to the same standard output
+  std::shared_ptr<IThresholdEventSink> standard_output_sink{};
+  if (!configuration_.threshold_event_sink_factory_) {
+	standard_output_sink =
+		std::make_shared<SynchronizedThresholdEventSink>(std::make_shared<TextThresholdEventSink>());
+  }
+
+  for (auto &basket_ids : partitionBaskets(basketComposition, shard_count)) {
+	auto shard_pricer_configuration = configuration_.shard_pricer_configuration_;
+	shard_pricer_configuration.threshold_event_sink_ =
+		configuration_.threshold_event_sink_factory_
+		? configuration_.threshold_event_sink_factory_(static_cast<int>(shards_.size()))
+		: standard_output_sink;
+
+	auto shard = std::make_unique<Shard>();
+	shard->basket_ids_ = std::move(basket_ids);
+	shard->tick_queue_ = std::make_shared<QueuedMarketDataProvider>(configuration_.tick_queue_capacity_,
+																	configuration_.tick_queue_wait_policy_);
+	shard->pricer_ = std::make_unique<BasketPricer>(basketComposition.selectBaskets(shard->basket_ids_),
+													shard->tick_queue_,
+													shard_pricer_configuration);
+	shards_.push_back(std::move(shard));
+  }
+
+  buildInstrumentShardIndex(basketComposition);
+}
+
+std::vector<std::vector<int>> ShardedBasketPricer::partitionBaskets(const BasketsComposition &basketComposition,
+																	const int &shard_count) {
+  const auto &baskets_price_data = basketComposition.getBasketPriceData();
+
+  std::vector<std::size_t> constituents(baskets_price_data.size(), 0);
+  for (int basket_id = 0; basket_id < baskets_price_data.size(); basket_id++) {
+	constituents[basket_id] = baskets_price_data[basket_id].getConstituents().size();
+  }
+
+  std::vector<int> order(baskets_price_data.size());
+  std::iota(order.begin(), order.end(), 0);
+  std::stable_sort(order.begin(), order.end(), [&constituents](const int &lhs, const int &rhs) {
+	return constituents[lhs] > constituents[rhs];
+  });
+
+  std::vector<std::vector<int>> partitions(shard_count);
+  std::vector<std::size_t> load(shard_count, 0);
+  for (const auto &basket_id : order) {
+	const auto shard = std::min_element(load.begin(), load.end()) - load.begin();
+	partitions[shard].push_back(basket_id);
+	load[shard] += std::max<std::size_t>(constituents[basket_id], 1);
+  }
+
+  // shard baskets keep the composition order, so does their threshold event order
+  for (auto &partition : partitions) std::sort(partition.begin(), partition.end());
+  return partitions;
+}
+
+void ShardedBasketPricer::buildInstrumentShardIndex(const BasketsComposition &basketComposition) {
+  const auto instrument_count = basketComposition.getInstrumentCount();
+
+  instrument_shard_offsets_.assign(instrument_count + 1, 0);
+  instrument_shards_.clear();
+
+  std::vector<int> basket_shard(basketComposition.getBasketPriceData().size(), 0);
+  basket_locations_.assign(basket_shard.size(), {0, 0});
+  for (int shard = 0; shard < shards_.size(); shard++) {
+	const auto &basket_ids = shards_[shard]->basket_ids_;
+	for (int shard_basket_id = 0; shard_basket_id < basket_ids.size(); shard_basket_id++) {
+	  basket_shard[basket_ids[shard_basket_id]] = shard;
+	  basket_locations_[basket_ids[shard_basket_id]] = {shard, shard_basket_id};
+	}
+  }
+
+  std::vector<bool> holds_instrument(shards_.size());
+  for (int instrumentId = 0; instrumentId < instrument_count; instrumentId++) {
+	std::fill(holds_instrument.begin(), holds_instrument.end(), false);
+	for (const auto &basket_weight : basketComposition.getInstrumentBaskets(instrumentId)) {
+	  holds_instrument[basket_shard[basket_weight.basket_id_]] = true;
+	}
+
+	for (int shard = 0; shard < shards_.size(); shard++) {
+	  if (holds_instrument[shard]) instrument_shards_.push_back(shard);
+	}
+	instrument_shard_offsets_[instrumentId + 1] = instrument_shards_.size();
+  }
+}
+
+void ShardedBasketPricer::initMarketDataSubscription() {
+  const auto hardware_threads = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+
+  for (int shard = 0; shard < shards_.size(); shard++) {
+	shards_[shard]->pricer_->initMarketDataSubscription();
+
+	const int cpu = (configuration_.first_cpu_ + shard) % hardware_threads;
+	shards_[shard]->thread_ = std::thread([tick_queue = shards_[shard]->tick_queue_,
+										   pricer = shards_[shard]->pricer_.get(), cpu,
+										   pin = configuration_.pin_shard_threads_] {
+	  if (pin) pinCurrentThreadToCpu(cpu);
+	  runTickPipeline(*tick_queue, *pricer);
+	});
+  }
+
+  shard_batches_.assign(shards_.size(), {});
+
+  // *** OnTickUpdate - Critical Fast Path Start ***
+  auto onTickBatch = [this](const std::span<const TickEvent> &ticks, const bool &endOfBatch) {
+	// the ticks of each shard are gathered, then queued at once
+	for (const auto &tickEvent : ticks) {
+	  if (tickEvent.eventType_ == TickEventType::INVALID) [[unlikely]] {
+		throw std::logic_error("Invalid TickEvent Type encountered!");
+	  }
+
+	  const auto instrumentId = tickEvent.instrumentId_;
+	  if (static_cast<std::size_t>(instrumentId) + 1 >= instrument_shard_offsets_.size()) [[unlikely]] continue;
+
+	  for (auto i = instrument_shard_offsets_[instrumentId]; i < instrument_shard_offsets_[instrumentId + 1]; i++) {
+		shard_batches_[instrument_shards_[i]].push_back(tickEvent);
+	  }
+	}
+
+	// every shard learns the batch ended, a conflating one may hold ticks of an earlier batch
+	for (int shard = 0; shard < shards_.size(); shard++) {
+	  auto &shard_batch = shard_batches_[shard];
+	  if (shard_batch.empty() && !endOfBatch) continue;
+
+	  shards_[shard]->tick_queue_->publishBatch(shard_batch, endOfBatch);
+	  shard_batch.clear();
+	}
+  };
+  // *** Critical Fast Path Complete ***
+
+  marketDataProvider_->subscribeBatch(std::move(onTickBatch), std::vector<std::string>(instrument_list_));
+}
+
+void ShardedBasketPricer::stop() {
+  for (const auto &shard : shards_) {
+	if (!shard->thread_.joinable()) continue;
+
+	shard->tick_queue_->close();
+	shard->thread_.join();
+  }
+  for (const auto &shard : shards_) shard->pricer_->stop();
+}
+
+ShardedBasketPricer::~ShardedBasketPricer() {
+  stop();
+}
+
+void ShardedBasketPricer::waitUntilPriced() const {
+  for (const auto &shard : shards_) shard->tick_queue_->waitUntilDrained();
+}
+
+BasketPriceSnapshot ShardedBasketPricer::getBasketSnapshot(const int &basket_id) const {
+  if (basket_id < 0 || static_cast<std::size_t>(basket_id) >= basket_locations_.size()) {
+	throw std::out_of_range("No basket price snapshot for basket id " + std::to_string(basket_id));
+  }
+
+  const auto &[shard, shard_basket_id] = basket_locations_[basket_id];
+  auto snapshot = shards_[shard]->pricer_->getBasketSnapshot(shard_basket_id);
+  snapshot.basket_id_ = basket_id;
+  return snapshot;
+}
+
+std::vector<BasketPriceSnapshot> ShardedBasketPricer::getAllSnapshots() const {
+  std::vector<BasketPriceSnapshot> snapshots(basket_locations_.size());
+  std::vector<BasketPriceSnapshot> shard_snapshots;
+
+  for (int shard = 0; shard < shards_.size(); shard++) {
+	shards_[shard]->pricer_->getAllSnapshots(shard_snapshots);
+	const auto &basket_ids = shards_[shard]->basket_ids_;
+	for (const auto &snapshot : shard_snapshots) {
+	  const int basket_id = basket_ids[snapshot.basket_id_];
+	  snapshots[basket_id] = snapshot;
+	  snapshots[basket_id].basket_id_ = basket_id;
+	}
+  }
+  return snapshots;
+}
+
+std::uint64_t ShardedBasketPricer::getDroppedThresholdEventCount() const {
+  std::uint64_t dropped{0};
+  for (const auto &shard : shards_) dropped += shard->pricer_->getDroppedThresholdEventCount();
+  return dropped;
+}
+
+ConflationCounters ShardedBasketPricer::getConflationCounters() const {
+  ConflationCounters counters;
+  for (const auto &shard : shards_) {
+	const auto shard_counters = shard->pricer_->getConflationCounters();
+	counters.ticks_ += shard_counters.ticks_;
+	counters.timestamps_ += shard_counters.timestamps_;
+	counters.instrument_updates_ += shard_counters.instrument_updates_;
+	counters.basket_revaluations_ += shard_counters.basket_revaluations_;
+  }
+  return counters;
+}
+
+void ShardedBasketPricer::dumpTickLatency(std::ostream &os) const {
+  TickLatencyRecorder merged;
+  for (const auto &shard : shards_) merged.merge(shard->pricer_->getTickLatency());
+  merged.dump(os);
+}
+}
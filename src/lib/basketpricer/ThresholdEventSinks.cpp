@@ -0,0 +1,77 @@
+#include <charconv>
+#include <cstring>
+#include <string_view>
+
+#include <unistd.h>
+
+#include "ThresholdEventSinks.h"
+
+#include "base/fixed_point.h"
+
+namespace basket::pricer {
+namespace {
+// room for the fixed text and three numbers of a line, the basket name aside
+constexpr std::size_t MAX_LINE_SIZE_WITHOUT_NAME = 160;
+
+inline char *appendText(char *out, const std::string_view &text) {
+  std::memcpy(out, text.data(), text.size());
+  return out + text.size();
+}
+
+// what std::ostream prints with its default precision, %g with 6 significant digits
+inline char *appendNumber(char *out, const double &value) {
+  return std::to_chars(out, out + 32, value, std::chars_format::general, 6).ptr;
+}
+}
+
+TextThresholdEventSink::TextThresholdEventSink() : writer_(STDOUT_FILENO) {
+}
+
+TextThresholdEventSink::TextThresholdEventSink(const std::string &path) : writer_(path) {
+}
+
+void TextThresholdEventSink::write(const std::span<const ThresholdEvent> &events) {
+  for (const auto &event : events) {
+	char *const line = writer_.prepare(event.basket_name_.size() + MAX_LINE_SIZE_WITHOUT_NAME);
+	char *out = appendText(line, event.basket_name_);
+
+	if (event.event_type_ == TickEventType::TRADE) {
+	  out = appendText(out, " PrevLastPrice ");
+	  out = appendNumber(out, weightedPriceToDouble(event.prev_price_));
+	  out = appendText(out, " NewLastPrice ");
+	} else {
+	  out = appendText(out, " PrevMidPrice ");
+	  out = appendNumber(out, weightedPriceToDouble(event.prev_price_));
+	  out = appendText(out, " NewMidPrice ");
+	}
+	out = appendNumber(out, weightedPriceToDouble(event.new_price_));
+	out = appendText(out, " DeltaPct ");
+	out = appendNumber(out, event.delta_pct_);
+	*out++ = '\n';
+
+	writer_.commit(out - line);
+  }
+}
+
+void TextThresholdEventSink::flush() {
+  writer_.flush();
+}
+
+BinaryThresholdEventSink::BinaryThresholdEventSink(const std::string &path) : writer_(path) {
+  ThresholdEventLogHeader header;
+  std::memcpy(header.magic_, ThresholdEventLogHeader::MAGIC, sizeof(header.magic_));
+  header.record_size_ = sizeof(ThresholdEventRecord);
+  writer_.append(&header, sizeof(header));
+}
+
+void BinaryThresholdEventSink::write(const std::span<const ThresholdEvent> &events) {
+  for (const auto &event : events) {
+	const ThresholdEventRecord record{event.prev_price_, event.new_price_, event.basket_id_, event.event_type_};
+	writer_.append(&record, sizeof(record));
+  }
+}
+
+void BinaryThresholdEventSink::flush() {
+  writer_.flush();
+}
+}
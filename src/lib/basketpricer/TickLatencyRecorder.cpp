@@ -0,0 +1,66 @@
+#include <iomanip>
+
+#include "TickLatencyRecorder.h"
+
+namespace basket::pricer {
+namespace {
+#if BASKET_LATENCY_HISTOGRAM
+const char *eventTypeName(const int &eventType) {
+  switch (static_cast<TickEventType>(eventType)) {
+	case TickEventType::BID: return "BID";
+	case TickEventType::ASK: return "ASK";
+	case TickEventType::TRADE: return "TRADE";
+	default: return "INVALID";
+  }
+}
+#endif
+}
+
+TickLatencyRecorder::TickLatencyRecorder()
+#if BASKET_LATENCY_HISTOGRAM
+	: histograms_(std::make_unique<LatencyHistogram[]>(EVENT_TYPE_COUNT * 2))
+#endif
+{
+}
+
+void TickLatencyRecorder::merge([[maybe_unused]] const TickLatencyRecorder &other) {
+#if BASKET_LATENCY_HISTOGRAM
+  for (int i = 0; i < EVENT_TYPE_COUNT * 2; i++) histograms_[i].merge(other.histograms_[i]);
+#endif
+}
+
+void TickLatencyRecorder::dump(std::ostream &os) const {
+#if BASKET_LATENCY_HISTOGRAM
+  const double nanoseconds_per_tick = LatencyClock::nanosecondsPerTick();
+  auto nanoseconds = [nanoseconds_per_tick](const std::uint64_t &clock_ticks) {
+	return clock_ticks * nanoseconds_per_tick;
+  };
+
+  const auto flags = os.flags();
+  const auto precision = os.precision();
+
+  os << "onTickUpdate latency (ns)" << std::endl
+	 << std::left << std::setw(8) << "event" << std::setw(10) << "breach"
+	 << std::right << std::setw(14) << "count" << std::setw(12) << "p50" << std::setw(12) << "p99"
+	 << std::setw(12) << "p99.9" << std::setw(12) << "max" << std::endl
+	 << std::fixed << std::setprecision(0);
+
+  for (int eventType = 0; eventType < EVENT_TYPE_COUNT; eventType++) {
+	for (const bool breached : {false, true}) {
+	  const auto &histogram = histograms_[eventType * 2 + breached];
+	  os << std::left << std::setw(8) << eventTypeName(eventType) << std::setw(10) << (breached ? "yes" : "no")
+		 << std::right << std::setw(14) << histogram.getCount()
+		 << std::setw(12) << nanoseconds(histogram.getValueAtPercentile(50))
+		 << std::setw(12) << nanoseconds(histogram.getValueAtPercentile(99))
+		 << std::setw(12) << nanoseconds(histogram.getValueAtPercentile(99.9))
+		 << std::setw(12) << nanoseconds(histogram.getMax()) << std::endl;
+	}
+  }
+
+  os.flags(flags);
+  os.precision(precision);
+#else
+  os << "onTickUpdate latency histogram disabled, configure with -DBASKET_LATENCY_HISTOGRAM=ON" << std::endl;
+#endif
+}
+}
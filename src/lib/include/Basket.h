@@ -1,7 +1,10 @@
 #pragma once
 
-#include <unordered_map>
+#include <cstdint>
+#include <memory>
+#include <span>
 #include <string>
+#include <string_view>
 #include <vector>
 
 #include "base/types.h"
@@ -10,11 +13,21 @@ namespace basket::pricer {
 
 struct BasketConfiguration {
   BasketConfiguration() {}
-  BasketConfiguration(const double &lastPriceThreshold, const double &midPriceThreshold)
+  BasketConfiguration(const ThresholdType &lastPriceThreshold, const ThresholdType &midPriceThreshold)
 	  : lastPriceThreshold_(lastPriceThreshold), midPriceThreshold_(midPriceThreshold) {}
 
-  double lastPriceThreshold_{0};
-  double midPriceThreshold_{0};
+  ThresholdType lastPriceThreshold_{0};
+  ThresholdType midPriceThreshold_{0};
+};
+
+struct BasketWeight {
+  int basket_id_{};
+  WeightType weight_{0};
+};
+
+struct BasketConstituent {
+  int instrument_id_{};
+  WeightType weight_{0};
 };
 
 class BasketPriceData {
@@ -22,12 +35,17 @@ class BasketPriceData {
 
   BasketPriceData() = default;
 
-  BasketPriceData(const std::string &basket_name, const int &basket_id, const BasketConfiguration &basketConfiguration)
-	  : basket_name_(basket_name), basket_id_(basket_id), basket_configuration_(basketConfiguration) {}
+  // name and constituents view the storage of the owning BasketsComposition
+  BasketPriceData(const std::string_view &basket_name,
+				  const int &basket_id,
+				  const BasketConfiguration &basketConfiguration,
+				  const std::span<const BasketConstituent> &constituents)
+	  : basket_configuration_(basketConfiguration), basket_id_(basket_id), basket_name_(basket_name),
+		constituents_(constituents) {}
 
   BasketPriceData(const BasketPriceData &) = default;
 
-  BasketPriceData &operator=(BasketPriceData &) = default;
+  BasketPriceData &operator=(const BasketPriceData &) = default;
 
   BasketPriceData(BasketPriceData &&) noexcept = default;
 
@@ -35,47 +53,46 @@ class BasketPriceData {
 
   ~BasketPriceData() = default;
 
-  [[nodiscard]] const std::string &getBasketName() {
+  [[nodiscard]] std::string_view getBasketName() const {
 	return basket_name_;
   }
 
-  [[nodiscard]] const int getBasketId() {
+  [[nodiscard]] int getBasketId() const {
 	return basket_id_;
   }
 
-  void setInstrumentWeight(const int &symbol_id, const double &weight);
-
   void setBasketToReady();
 
-  [[nodiscard]] double getInstrumentWeighting(const int &symbol_id) const;
+  [[nodiscard]] WeightType getInstrumentWeighting(const int &symbol_id) const;
 
   [[nodiscard]] bool isReady() const {
 	return is_ready_;
   };
 
-  [[nodiscard]] const std::vector<double> &getAllWeights() const {
-	return weighting_;
+  // instruments of the basket with a non-zero weight, ordered by instrument id
+  [[nodiscard]] std::span<const BasketConstituent> getConstituents() const {
+	return constituents_;
   };
 
-  void setBidPrice(const PriceType &price);
+  void setBidPrice(const WeightedPriceType &price);
 
-  void setAskPrice(const PriceType &price);
+  void setAskPrice(const WeightedPriceType &price);
 
-  void setLastPrice(const PriceType &price);
+  void setLastPrice(const WeightedPriceType &price);
 
-  [[nodiscard]] PriceType getAskPrice() const {
+  [[nodiscard]] WeightedPriceType getAskPrice() const {
 	return ask_price_;
   }
 
-  [[nodiscard]] PriceType getBidPrice() const {
+  [[nodiscard]] WeightedPriceType getBidPrice() const {
 	return bid_price_;
   }
 
-  [[nodiscard]] PriceType getMidPrice() const {
+  [[nodiscard]] WeightedPriceType getMidPrice() const {
 	return mid_price_;
   }
 
-  [[nodiscard]] PriceType getLastPrice() const {
+  [[nodiscard]] WeightedPriceType getLastPrice() const {
 	return last_price_;
   }
 
@@ -86,20 +103,23 @@ class BasketPriceData {
  private:
   void updateMidPrice();
 
-  PriceType bid_price_{0};
-  PriceType ask_price_{0};
-  PriceType mid_price_{0};
-  PriceType last_price_{0};
+  WeightedPriceType bid_price_{0};
+  WeightedPriceType ask_price_{0};
+  WeightedPriceType mid_price_{0};
+  WeightedPriceType last_price_{0};
 
   BasketConfiguration basket_configuration_;
 
   int basket_id_{};
   bool is_ready_{false};
 
-  const std::string basket_name_{};
-  std::vector<double> weighting_{};
+  std::string_view basket_name_{};
+  std::span<const BasketConstituent> constituents_{};
 };
 
+// Baskets and the instruments they hold. The composition itself - names, thresholds, weights and the instrument
+// to basket index - is immutable and shared by every copy, either built from the csv files or mapped from a
+// snapshot (see BasketSnapshot.h); only the basket prices are per copy.
 class BasketsComposition {
  public:
 
@@ -119,18 +139,92 @@ class BasketsComposition {
 
   ~BasketsComposition() = default;
 
-  [[nodiscard]] int getInstrumentID(const std::string &instrumentName) const;
+  // maps a snapshot written by writeSnapshot and uses it in place, no parsing nor per basket allocation
+  [[nodiscard]] static BasketsComposition loadSnapshot(const std::string &snapshotPath);
+
+  // whether the file starts as a composition snapshot
+  [[nodiscard]] static bool isSnapshot(const std::string &path);
 
+  void writeSnapshot(const std::string &snapshotPath) const;
+
+  [[nodiscard]] int getInstrumentID(const std::string_view &instrumentName) const;
+
+  [[nodiscard]] std::string_view getInstrumentName(const int &instrumentId) const {
+	return nameAt(layout_.instrument_name_offsets_, layout_.instrument_names_, instrumentId);
+  }
+
+  // instrument names ordered by instrument id
   [[nodiscard]] std::vector<std::string> getInstrumentList() const;
 
+  [[nodiscard]] int getInstrumentCount() const {
+	return static_cast<int>(layout_.instruments_by_name_.size());
+  }
+
   [[nodiscard]] std::vector<BasketPriceData> &getBasketPriceData() {
 	return baskets_price_data_;
   }
 
+  [[nodiscard]] const std::vector<BasketPriceData> &getBasketPriceData() const {
+	return baskets_price_data_;
+  }
+
+  // Copy holding only the given baskets, renumbered 0..n-1 in the given order.
+  // Instrument ids are kept, hence ticks interned against this composition apply to the copy as is.
+  [[nodiscard]] BasketsComposition selectBaskets(const std::vector<int> &basketIds) const;
+
+  // Copy whose instrument ids are the positions in instrumentList, as interned by a market data subscription to it,
+  // e.g. to reload a composition into a running pricer. Throws std::invalid_argument when a basket holds an
+  // instrument missing from the list.
+  [[nodiscard]] BasketsComposition renumberInstruments(const std::vector<std::string> &instrumentList) const;
+
+  // baskets holding the instrument with a non-zero weight, ordered by basket id
+  [[nodiscard]] std::span<const BasketWeight> getInstrumentBaskets(const int &instrumentId) const {
+	return layout_.instrument_baskets_.subspan(
+		layout_.instrument_basket_offsets_[instrumentId],
+		layout_.instrument_basket_offsets_[instrumentId + 1] - layout_.instrument_basket_offsets_[instrumentId]);
+  }
+
  private:
+  // Views of the immutable composition, names are concatenated and delimited by offsets (count + 1 entries),
+  // weights are in compressed sparse row form both ways: basket -> constituents and instrument -> baskets
+  struct Layout {
+	std::span<const std::uint64_t> instrument_name_offsets_{};
+	std::span<const char> instrument_names_{};
+	// instrument ids ordered by name, for getInstrumentID
+	std::span<const std::int32_t> instruments_by_name_{};
+
+	std::span<const std::uint64_t> basket_name_offsets_{};
+	std::span<const char> basket_names_{};
+	std::span<const BasketConfiguration> basket_configurations_{};
+
+	std::span<const std::uint64_t> basket_constituent_offsets_{};
+	std::span<const BasketConstituent> basket_constituents_{};
+
+	std::span<const std::uint64_t> instrument_basket_offsets_{};
+	std::span<const BasketWeight> instrument_baskets_{};
+  };
+
+  struct OwnedLayout;
+
+  // builds an owned layout, constituents given per basket by constituent_offsets, sorted by instrument id
+  static BasketsComposition build(const std::vector<std::string_view> &instrumentNames,
+								  const std::vector<std::string_view> &basketNames,
+								  const std::vector<BasketConfiguration> &basketConfigurations,
+								  const std::vector<std::uint64_t> &constituentOffsets,
+								  const std::vector<BasketConstituent> &constituents);
+
+  static std::string_view nameAt(const std::span<const std::uint64_t> &offsets,
+								 const std::span<const char> &names,
+								 const int &index) {
+	return {names.data() + offsets[index], offsets[index + 1] - offsets[index]};
+  }
+
+  void initBasketPriceData();
+
+  Layout layout_{};
+  std::shared_ptr<const void> storage_{};
+
   std::vector<BasketPriceData> baskets_price_data_{};
-  std::unordered_map<std::string, int> instrumentName_to_id_map_{};
-  std::unordered_map<std::string, BasketConfiguration> basket_configs_;
 };
 
-}
\ No newline at end of file
+}
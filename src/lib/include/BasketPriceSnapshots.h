@@ -0,0 +1,150 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "base/types.h"
+#include "Basket.h"
+
+namespace basket::pricer {
+
+// Prices of a basket as last published by the pricing thread
+struct BasketPriceSnapshot {
+  int basket_id_{-1};
+  // false until every positively weighted constituent is priced, the prices are zero until then
+  bool is_ready_{false};
+  WeightedPriceType bid_price_{0};
+  WeightedPriceType ask_price_{0};
+  WeightedPriceType mid_price_{0};
+  WeightedPriceType last_price_{0};
+  // timestamp of the tick which last moved the basket
+  std::uint64_t event_timestamp_{0};
+  // updates published for the basket since its composition was adopted, 0 before the first
+  std::uint64_t version_{0};
+  // generation of the composition the basket id refers to, see BasketPricer::getCompositionGeneration
+  std::uint64_t composition_generation_{0};
+};
+
+// Per basket price records written by the pricing thread after every basket update and read from any thread.
+// Each record sits on a cache line of its own behind a sequence lock: the writer never waits for a reader, a reader
+// retries the few nanoseconds a write takes when it catches one in progress. Adopting a composition publishes a
+// table of its own. A reader counts itself in one of two reader counters while it holds a table, the counter being
+// picked by the parity of an epoch the writer moves on at every table published: a table replaced is freed once
+// each counter was seen at zero since, readers arriving meanwhile count on the other one. The writer only waits for
+// the readers when more than MAX_RETIRED_TABLES tables are left to free.
+class BasketPriceSnapshots {
+ public:
+  BasketPriceSnapshots() = default;
+
+  BasketPriceSnapshots(const BasketPriceSnapshots &) = delete;
+
+  BasketPriceSnapshots &operator=(const BasketPriceSnapshots &) = delete;
+
+  BasketPriceSnapshots(BasketPriceSnapshots &&) noexcept = delete;
+
+  BasketPriceSnapshots &operator=(BasketPriceSnapshots &&) noexcept = delete;
+
+  ~BasketPriceSnapshots() = default;
+
+  // pricing thread, publishes a table of basket_count records, none published yet, and frees the tables replaced
+  // earlier which no reader can hold anymore
+  void reset(const std::size_t &basket_count, const std::uint64_t &composition_generation);
+
+  // pricing thread, after the basket prices changed
+  inline void publish(const BasketPriceData &basket_price_data, const std::uint64_t &event_timestamp) {
+	Record &record = records_[basket_price_data.getBasketId()];
+
+	// odd while written, the fence keeps the price stores after it
+	const std::uint64_t sequence = record.sequence_.load(std::memory_order_relaxed);
+	record.sequence_.store(sequence + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+
+	record.bid_price_.store(basket_price_data.getBidPrice(), std::memory_order_relaxed);
+	record.ask_price_.store(basket_price_data.getAskPrice(), std::memory_order_relaxed);
+	record.mid_price_.store(basket_price_data.getMidPrice(), std::memory_order_relaxed);
+	record.last_price_.store(basket_price_data.getLastPrice(), std::memory_order_relaxed);
+	record.event_timestamp_.store(event_timestamp, std::memory_order_relaxed);
+	record.is_ready_.store(basket_price_data.isReady(), std::memory_order_relaxed);
+
+	record.sequence_.store(sequence + 2, std::memory_order_release);
+  }
+
+  // any thread, baskets of the composition last adopted
+  [[nodiscard]] std::size_t getBasketCount() const;
+
+  // Any thread, lock free. std::out_of_range when the composition last adopted has no such basket.
+  [[nodiscard]] BasketPriceSnapshot read(const int &basket_id) const;
+
+  // Any thread, lock free, every basket of the composition last adopted in basket id order. Each snapshot is
+  // consistent on its own, not with the others: the pricing thread goes on while they are read.
+  void readAll(std::vector<BasketPriceSnapshot> &snapshots) const;
+
+ private:
+  struct alignas(CACHE_LINE_SIZE) Record {
+	// odd while an update is written, twice the updates published otherwise
+	std::atomic<std::uint64_t> sequence_{0};
+	std::atomic<WeightedPriceType> bid_price_{0};
+	std::atomic<WeightedPriceType> ask_price_{0};
+	std::atomic<WeightedPriceType> mid_price_{0};
+	std::atomic<WeightedPriceType> last_price_{0};
+	std::atomic<std::uint64_t> event_timestamp_{0};
+	std::atomic<bool> is_ready_{false};
+  };
+  static_assert(sizeof(Record) == CACHE_LINE_SIZE, "a basket price record takes a single cache line");
+
+  struct Table {
+	std::uint64_t composition_generation_{0};
+	std::size_t basket_count_{0};
+	std::unique_ptr<Record[]> records_{};
+  };
+
+  // a table replaced, and whether each reader counter was seen at zero since
+  struct RetiredTable {
+	std::unique_ptr<Table> table_{};
+	bool quiescent_[2]{false, false};
+  };
+
+  // the retired tables beyond which reset() waits for the readers
+  constexpr static std::size_t MAX_RETIRED_TABLES = 4;
+
+  // counts the calling reader while it holds the current table
+  class ReadGuard {
+   public:
+	explicit ReadGuard(const BasketPriceSnapshots &snapshots);
+
+	ReadGuard(const ReadGuard &) = delete;
+
+	ReadGuard &operator=(const ReadGuard &) = delete;
+
+	~ReadGuard();
+
+	[[nodiscard]] const Table *getTable() const {
+	  return table_;
+	}
+
+   private:
+	std::atomic<std::uint64_t> &readers_;
+	const Table *table_;
+  };
+
+  static BasketPriceSnapshot readRecord(const Table &table, const int &basket_id);
+
+  // pricing thread, marks the retired tables quiescent on the counter when no reader is counted on it, spinning until
+  // none is when wait is set
+  void markQuiescent(const std::size_t &parity, const bool &wait);
+
+  // the table readers load, the writer's is records_
+  std::atomic<const Table *> current_{nullptr};
+  std::unique_ptr<Table> current_table_{};
+  std::vector<RetiredTable> retired_tables_{};
+
+  Record *records_{nullptr};
+
+  // readers count themselves on the counter of the epoch's parity
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> reader_epoch_{0};
+  alignas(CACHE_LINE_SIZE) mutable std::atomic<std::uint64_t> readers_[2]{};
+};
+
+}
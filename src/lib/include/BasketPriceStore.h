@@ -0,0 +1,144 @@
+#pragma once
+
+#include <cstdint>
+#include <span>
+#include <vector>
+
+#include "base/types.h"
+#include "Basket.h"
+#include "InstrumentPrice.h"
+
+namespace basket::pricer {
+
+// Net change of one instrument's prices over a batch of ticks
+struct InstrumentPriceDelta {
+  InstrumentIdType instrumentId_{-1};
+  PriceType bid_delta_{0};
+  PriceType ask_delta_{0};
+  PriceType last_delta_{0};
+};
+
+struct BasketBreach {
+  int basket_id_{};
+  bool is_last_price_{false}; // otherwise the mid price breached
+  WeightedPriceType prev_price_{0};
+  WeightedPriceType new_price_{0};
+};
+
+// Structure of arrays basket state for batch workloads - end of tick batches, replays - where thousands of
+// instrument deltas are applied at once. Hot columns are contiguous per field, so revaluing every affected basket
+// and evaluating both thresholds is a single streaming pass, vectorised with AVX2 or AVX-512 when available.
+// Basket ids and weights are those of the BasketsComposition it is built from. Prices follow the scalar pricer: a
+// basket takes no delta until every positively weighted constituent has its bid, ask and last prices, then is summed
+// from them without breaching, and its mid price only moves while both sides are positive. A batch breaches on the net
+// move of the basket over the batch. Not used by the pricers, the basket_price_store benchmark drives it.
+class BasketPriceStore {
+ public:
+  enum class SimdLevel : std::uint8_t {
+	SCALAR,
+	AVX2,
+	AVX512
+  };
+
+  explicit BasketPriceStore(const BasketsComposition &basketComposition);
+
+  BasketPriceStore(const BasketPriceStore &) = default;
+
+  BasketPriceStore(BasketPriceStore &&) noexcept = default;
+
+  BasketPriceStore &operator=(const BasketPriceStore &) = default;
+
+  BasketPriceStore &operator=(BasketPriceStore &&) noexcept = default;
+
+  ~BasketPriceStore() = default;
+
+  // full revaluation of every basket, and its readiness, from instrument prices indexed by instrument id
+  void revalue(const std::vector<InstrumentPrice> &instrument_prices);
+
+  // applies the deltas to every basket holding the instruments, appends breaches ordered by basket id
+  void applyDeltas(std::span<const InstrumentPriceDelta> deltas, std::vector<BasketBreach> &breaches);
+
+  [[nodiscard]] static SimdLevel getSupportedSimdLevel();
+
+  [[nodiscard]] SimdLevel getSimdLevel() const {
+	return simd_level_;
+  }
+
+  // capped to what the cpu supports
+  void setSimdLevel(const SimdLevel &simdLevel);
+
+  [[nodiscard]] int getBasketCount() const {
+	return static_cast<int>(bid_price_.size());
+  }
+
+  [[nodiscard]] WeightedPriceType getBidPrice(const int &basket_id) const {
+	return bid_price_[basket_id];
+  }
+
+  [[nodiscard]] WeightedPriceType getAskPrice(const int &basket_id) const {
+	return ask_price_[basket_id];
+  }
+
+  [[nodiscard]] WeightedPriceType getMidPrice(const int &basket_id) const {
+	return mid_price_[basket_id];
+  }
+
+  [[nodiscard]] WeightedPriceType getLastPrice(const int &basket_id) const {
+	return last_price_[basket_id];
+  }
+
+  [[nodiscard]] bool isReady(const int &basket_id) const {
+	return is_ready_[basket_id];
+  }
+
+ private:
+  // bid, ask and last prices of the positively weighted constituents still zero
+  [[nodiscard]] std::uint32_t countMissingPriceFields(const int &basket_id) const;
+
+  // sums the positively weighted constituent prices of a basket turning ready
+  void initBasketPrices(const int &basket_id);
+
+  // hot columns, indexed by basket id
+  std::vector<WeightedPriceType> bid_price_{};
+  std::vector<WeightedPriceType> ask_price_{};
+  std::vector<WeightedPriceType> mid_price_{};
+  std::vector<WeightedPriceType> last_price_{};
+  std::vector<ThresholdType> last_price_threshold_{};
+  std::vector<ThresholdType> mid_price_threshold_{};
+
+  // per basket deltas accumulated from a batch, all zero in between batches
+  std::vector<WeightedPriceType> bid_delta_{};
+  std::vector<WeightedPriceType> ask_delta_{};
+  std::vector<WeightedPriceType> last_delta_{};
+
+  // instrument -> (basket id, weight), split in columns, walked to scatter sparse batches
+  std::vector<std::size_t> instrument_offsets_{};
+  std::vector<int> basket_ids_{};
+  std::vector<WeightType> weights_{};
+
+  // basket -> (instrument id, weight), split in columns, walked to gather dense batches
+  std::vector<std::size_t> basket_offsets_{};
+  std::vector<InstrumentIdType> constituent_ids_{};
+  std::vector<WeightType> constituent_weights_{};
+
+  // per instrument net deltas of a dense batch, all zero in between batches
+  std::vector<PriceType> instrument_bid_delta_{};
+  std::vector<PriceType> instrument_ask_delta_{};
+  std::vector<PriceType> instrument_last_delta_{};
+
+  // instrument prices as of the last batch, indexed by instrument id
+  std::vector<InstrumentPrice> instrument_prices_{};
+
+  // readiness by basket id, and the count of price fields the baskets not ready are missing
+  std::vector<std::uint8_t> is_ready_{};
+  std::vector<std::uint32_t> missing_price_fields_{};
+  int not_ready_count_{0};
+  std::vector<int> becoming_ready_{};
+
+  // configured threshold range, bounds the basket prices the vector kernels evaluate exactly
+  ThresholdType min_threshold_{0};
+  ThresholdType max_threshold_{0};
+  SimdLevel simd_level_{SimdLevel::SCALAR};
+};
+
+}
@@ -1,61 +1,406 @@
 #pragma once
 
-#include <queue>
+#include <atomic>
 #include <memory>
-#include <condition_variable>
+#include <ostream>
+#include <span>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
 
+#include "base/fixed_point.h"
 #include "base/types.h"
 #include "Basket.h"
+#include "BasketPriceSnapshots.h"
+#include "BasketUpdateBroadcast.h"
 #include "IMarketDataProvider.h"
+#include "InstrumentPrice.h"
+#include "IThresholdEventSink.h"
+#include "SpscRingBuffer.h"
+#include "ThresholdEvent.h"
 #include "TickEvent.h"
+#include "TickLatencyRecorder.h"
 
 namespace basket::pricer {
 
-class InstrumentPrice;
+struct BasketPricerConfiguration {
+  // threshold events in flight between the pricing thread and the printer thread, rounded up to a power of 2
+  std::size_t threshold_queue_capacity_{1 << 14};
+  OverflowPolicy threshold_queue_overflow_policy_{OverflowPolicy::SPIN};
+  ConsumerWaitPolicy threshold_queue_wait_policy_{ConsumerWaitPolicy::PARK};
 
-struct ThresholdEvent {
-	int basket_id_;
-	TickEventType event_type_;
-	PriceType prev_price_;
-	PriceType new_price_;
-	double delta_pct_;
+  // where the printer thread writes the threshold events, text on standard output when not set
+  std::shared_ptr<IThresholdEventSink> threshold_event_sink_{};
+
+  // Prices the ticks sharing a timestamp together: they are held until a tick with another timestamp arrives, a batch
+  // marked as ending its timestamp, or stop(), then each instrument's net price change is applied, each affected
+  // basket is revalued once and each of its thresholds is checked once. Ticks must be delivered in timestamp order,
+  // as the market data providers do.
+  bool conflate_same_timestamp_{false};
+
+  // Publishes every basket's prices after each update for getBasketSnapshot and getAllSnapshots to read from other
+  // threads, at the cost of a cache line written per basket update.
+  bool publish_basket_snapshots_{false};
+
+  // Publishes every basket update to the broadcast's subscribers, see BasketUpdateSubscriber. The pricer is the
+  // broadcast's only writer and closes it in stop().
+  std::shared_ptr<BasketUpdateBroadcast> basket_update_broadcast_{};
+};
+
+// What same timestamp conflation saved so far, see BasketPricerConfiguration::conflate_same_timestamp_
+struct ConflationCounters {
+  std::uint64_t ticks_{0};
+  // distinct timestamps priced
+  std::uint64_t timestamps_{0};
+  // net instrument price changes applied, at most one per instrument and timestamp
+  std::uint64_t instrument_updates_{0};
+  std::uint64_t basket_revaluations_{0};
+
+  // ticks per net instrument price change, 1 when nothing was conflated
+  [[nodiscard]] double getConflationRatio() const {
+	return instrument_updates_ == 0 ? 0.0 : static_cast<double>(ticks_) / static_cast<double>(instrument_updates_);
+  }
 };
 
 class BasketPricer {
  public:
 
   BasketPricer(const BasketsComposition &basketComposition,
-			   std::shared_ptr<IMarketDataProvider> marketDataProvider);
+			   std::shared_ptr<IMarketDataProvider> marketDataProvider,
+			   const BasketPricerConfiguration &configuration = {});
 
   BasketPricer() = delete;
 
   BasketPricer(const BasketPricer &) = delete;
 
-  BasketPricer(BasketPricer &&) noexcept = default;
+  // the printer thread refers to the pricer, the pricer stays where it was built
+  BasketPricer(BasketPricer &&) noexcept = delete;
 
   BasketPricer &operator=(const BasketPricer &) = delete;
 
-  BasketPricer &operator=(BasketPricer &&) noexcept = default;
+  BasketPricer &operator=(BasketPricer &&) noexcept = delete;
 
-  ~BasketPricer() = default;
+  // stops the printer thread, see stop()
+  ~BasketPricer();
 
+  // subscribes to the batches of the market data provider and starts the printer thread
   void initMarketDataSubscription();
 
+  // Pricing thread, prices a batch of ticks as delivered by the subscription. A provider bound to the pricer at
+  // compile time, see StaticTickPipeline.h, calls it straight, the pricing loop then inlining into the provider's.
+  void onTickBatch(const std::span<const TickEvent> &ticks, const bool &endOfBatch);
+
+  // Once no more ticks are delivered, hands the threshold events still queued to the sink, flushes it and joins the
+  // printer thread. Idempotent.
+  void stop();
+
+  // Callable from any thread, typically the one which built the composition. Hands the composition over to the
+  // pricing thread, which adopts it on its next tick without taking a lock: instrument prices carry over and every
+  // basket is revalued from them, without emitting threshold events for the switch. Instrument ids are renumbered
+  // to the subscription, std::invalid_argument is thrown when a basket holds an instrument not subscribed.
+  // A composition still pending is superseded.
+  void reloadComposition(const BasketsComposition &basketComposition);
+
+  // compositions adopted by the pricing thread so far, callable from any thread
+  [[nodiscard]] std::uint64_t getCompositionGeneration() const {
+	return composition_generation_.load(std::memory_order_acquire);
+  }
+
+  // threshold events lost to the configured overflow policy
+  [[nodiscard]] std::uint64_t getDroppedThresholdEventCount() const {
+	return threshold_events_.getDroppedCount();
+  }
+
+  // callable from any thread, all zeros unless conflating
+  [[nodiscard]] ConflationCounters getConflationCounters() const {
+	return {conflated_ticks_.load(std::memory_order_relaxed),
+			conflated_timestamps_.load(std::memory_order_relaxed),
+			conflated_instrument_updates_.load(std::memory_order_relaxed),
+			conflated_basket_revaluations_.load(std::memory_order_relaxed)};
+  }
+
+  // Any thread, lock free, the prices last published for the basket of the composition last adopted.
+  // std::logic_error unless publish_basket_snapshots_ is set, std::out_of_range for an unknown basket id.
+  [[nodiscard]] BasketPriceSnapshot getBasketSnapshot(const int &basket_id) const;
+
+  // any thread, lock free, every basket in basket id order, see BasketPriceSnapshots::readAll
+  [[nodiscard]] std::vector<BasketPriceSnapshot> getAllSnapshots() const;
+
+  // as above into the caller's vector, which allocates nothing once it has the capacity
+  void getAllSnapshots(std::vector<BasketPriceSnapshot> &snapshots) const;
+
+  [[nodiscard]] const TickLatencyRecorder &getTickLatency() const {
+	return tick_latency_;
+  }
+
+  // onTickUpdate latency percentiles so far, callable from any thread
+  void dumpTickLatency(std::ostream &os) const {
+	tick_latency_.dump(os);
+  }
+
  private:
 
-  // We may want to make it configurable?
-  constexpr static int THRESHOLD_MESSAGES_SIZE = 30;
+  // threshold events handed to the sink per write
+  constexpr static int THRESHOLD_MESSAGES_SIZE = 256;
+
+  // ticks ahead of the one priced whose instrument state is prefetched, within a batch
+  constexpr static std::size_t TICK_PREFETCH_DISTANCE = 4;
+
+  // instrument prices before the first tick of the timestamp being conflated
+  struct ConflatedInstrument {
+	InstrumentPrice start_price_{};
+	bool touched_{false};
+  };
+
+  // weighted net changes of a basket over the timestamp being conflated
+  struct ConflatedBasket {
+	int basket_id_{0};
+	WeightedPriceType ask_delta_{0};
+	WeightedPriceType bid_delta_{0};
+	WeightedPriceType last_delta_{0};
+  };
+
+  struct RetiredComposition {
+	BasketsComposition composition_;
+	// threshold queue write position when it was replaced
+	std::uint64_t retired_at_{0};
+  };
+
+  // bid, ask and last prices of the positively weighted constituents still at zero
+  [[nodiscard]] std::uint32_t countMissingPriceFields(const BasketPriceData &basket_price_data) const;
+
+  // sets the basket prices from the instrument prices, once every constituent is priced
+  void initBasketPrices(BasketPriceData &basket_price_data, const std::uint64_t &event_timestamp);
+
+  // recounts the missing prices of every basket of the composition, readying those with none missing
+  void initBasketReadiness(const std::uint64_t &event_timestamp);
+
+  // pricing thread, after the basket prices moved on a tick of event_timestamp
+  void publishBasketUpdate(const BasketPriceData &basket_price_data, const std::uint64_t &event_timestamp) {
+	if (basket_snapshots_) basket_snapshots_->publish(basket_price_data, event_timestamp);
+	if (basket_update_broadcast_) broadcastBasketUpdate(*basket_update_broadcast_, basket_price_data, event_timestamp);
+  }
+
+  void broadcastBasketUpdate(BasketUpdateBroadcast &broadcast,
+							 const BasketPriceData &basket_price_data,
+							 const std::uint64_t &event_timestamp) const {
+	broadcast.publish({basket_price_data.getBasketId(),
+					   static_cast<std::uint32_t>(composition_generation_.load(std::memory_order_relaxed)),
+					   event_timestamp,
+					   tick_sequence_,
+					   basket_price_data.getBidPrice(),
+					   basket_price_data.getAskPrice(),
+					   basket_price_data.getMidPrice(),
+					   basket_price_data.getLastPrice()});
+  }
+
+  // pricing thread, prices the tick as it arrives
+  void onTickUpdate(const TickEvent &tickEvent);
+
+  // pricing thread, brings the instrument price and the basket index entries of the tick towards the cache
+  void prefetchTick(const TickEvent &tickEvent) const;
+
+  // pricing thread, when conflating, holds the tick until its timestamp is over
+  void conflateTick(const TickEvent &tickEvent);
+
+  // pricing thread, prices the ticks held so far, true when a threshold was breached
+  bool flushConflatedTicks();
+
+  // applies the weighted net changes of a ready basket and checks the thresholds of the prices which moved, true
+  // when one was breached
+  bool revalueBasket(BasketPriceData &basket_price_data,
+					 const WeightedPriceType &ask_delta,
+					 const WeightedPriceType &bid_delta,
+					 const WeightedPriceType &last_delta);
+
+  // pushes the threshold event when the basket price moved past the threshold, true if so
+  bool checkThreshold(const BasketPriceData &basket_price_data,
+					  const TickEventType &eventType,
+					  const WeightedPriceType &prev_price,
+					  const WeightedPriceType &new_price,
+					  const ThresholdType &threshold);
+
+  // pricing thread, swaps in the pending composition and frees the retired ones the printer is done with
+  void adoptPendingComposition(const std::uint64_t &event_timestamp);
+
+  // printer thread, until stop()
+  void printThresholdEvents();
 
   BasketsComposition basketComposition_;
 
+  // instrument ids interned by the subscription are the positions in this list
+  std::vector<std::string> instrument_list_{};
+
+  // written by reloadComposition, taken by the pricing thread
+  std::atomic<BasketsComposition *> pending_composition_{nullptr};
+  std::atomic<std::uint64_t> composition_generation_{0};
+
+  // pricing thread only, replaced compositions whose basket names queued threshold events may still view
+  std::vector<RetiredComposition> retired_compositions_{};
+
   std::shared_ptr<IMarketDataProvider> marketDataProvider_{};
   std::vector<InstrumentPrice> instrument_prices_{};
 
+  // pricing thread only, by basket id, the basket turns ready when its count reaches zero
+  std::vector<std::uint32_t> missing_price_fields_{};
+
+  // pricing thread only, the instruments and the baskets touched since the last flush, the basket positions in
+  // touched_baskets_ by basket id, -1 when untouched
+  bool conflate_same_timestamp_{false};
+  std::uint64_t conflated_timestamp_{0};
+  std::vector<ConflatedInstrument> conflated_instruments_{};
+  std::vector<int> touched_instruments_{};
+  std::vector<int> touched_basket_positions_{};
+  std::vector<ConflatedBasket> touched_baskets_{};
+
+  // written by the pricing thread, read from any thread, null unless publish_basket_snapshots_ is set
+  std::unique_ptr<BasketPriceSnapshots> basket_snapshots_{};
+
+  // written by the pricing thread, null unless configured, and the ticks priced so far
+  std::shared_ptr<BasketUpdateBroadcast> basket_update_broadcast_{};
+  std::uint64_t tick_sequence_{0};
+
+  // written by the pricing thread only
+  std::atomic<std::uint64_t> conflated_ticks_{0};
+  std::atomic<std::uint64_t> conflated_timestamps_{0};
+  std::atomic<std::uint64_t> conflated_instrument_updates_{0};
+  std::atomic<std::uint64_t> conflated_basket_revaluations_{0};
 
-  std::mutex threshold_message_mutex_{};
-  std::condition_variable threshold_message_cv_{};
-  std::vector<ThresholdEvent> threshold_messages_{};
+  // written by the pricing thread only, read by the printer thread only
+  SpscRingBuffer<ThresholdEvent> threshold_events_;
 
+  // threshold queue read position the printer thread is done with, every event before it was printed or dropped
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> printed_position_{0};
+
+  std::shared_ptr<IThresholdEventSink> threshold_event_sink_{};
+  std::thread threshold_printer_{};
+
+  // recorded by the pricing thread, compiled out unless BASKET_LATENCY_HISTOGRAM is set
+  TickLatencyRecorder tick_latency_{};
 };
 
-}
\ No newline at end of file
+// *** OnTickUpdate - Critical Fast Path Start ***
+inline void BasketPricer::onTickUpdate(const TickEvent &tickEvent) {
+  if (tickEvent.eventType_ == TickEventType::INVALID) [[unlikely]] {
+	throw std::logic_error("Invalid TickEvent Type encountered!");
+  }
+
+  const auto latency_start = tick_latency_.start();
+  bool breached{false};
+
+  // a relaxed load of a pointer which is null unless a reload is pending
+  if (pending_composition_.load(std::memory_order_relaxed) != nullptr) [[unlikely]] {
+	adoptPendingComposition(tickEvent.event_timestamp_);
+  }
+  tick_sequence_++;
+
+  // instrument id interned at subscription, identical to the basket composition instrument id
+  const auto instrumentId = tickEvent.instrumentId_;
+  if (static_cast<std::size_t>(instrumentId) >= instrument_prices_.size()) [[unlikely]] return;
+
+  auto &instrument_price = instrument_prices_[instrumentId];
+
+  PriceType instrument_prev_price{0};
+
+  if (tickEvent.eventType_ == TickEventType::ASK) {
+	instrument_prev_price = instrument_price.getAskPrice();
+	instrument_price.setAskPrice(tickEvent.price_);
+  } else if (tickEvent.eventType_ == TickEventType::BID) {
+	instrument_prev_price = instrument_price.getBidPrice();
+	instrument_price.setBidPrice(tickEvent.price_);
+  } else if (tickEvent.eventType_ == TickEventType::TRADE) {
+	instrument_prev_price = instrument_price.getLastPrice();
+	instrument_price.setLastPrice(tickEvent.price_);
+  }
+
+  // +1 when the field gets its first price, -1 when a price of zero clears it
+  const int priced_fields_delta = (instrument_prev_price == 0) - (tickEvent.price_ == 0);
+
+  auto &baskets_price_data = basketComposition_.getBasketPriceData();
+
+  // for each basket holding this instrument
+  for (const auto &[basket_id, weight] : basketComposition_.getInstrumentBaskets(instrumentId)) {
+	auto &basket_price_data = baskets_price_data[basket_id];
+
+	if (!basket_price_data.isReady()) [[unlikely]] {
+	  // only until the market opens, each tick updates a count and the basket is summed once when it reaches zero
+	  auto &missing_price_fields = missing_price_fields_[basket_id];
+	  if (weight > 0) missing_price_fields -= priced_fields_delta;
+	  if (missing_price_fields == 0) initBasketPrices(basket_price_data, tickEvent.event_timestamp_);
+	  continue;
+	}
+
+	const WeightedPriceType basket_weighted_delta = (tickEvent.price_ - instrument_prev_price) * weight;
+
+	if (tickEvent.eventType_ == TickEventType::TRADE) {
+	  const WeightedPriceType prev_last_price = basket_price_data.getLastPrice();
+	  const WeightedPriceType new_last_price = prev_last_price + basket_weighted_delta;
+	  basket_price_data.setLastPrice(new_last_price);
+
+	  if (isThresholdBreached(prev_last_price, new_last_price,
+							  basket_price_data.getBasketConfiguration().lastPriceThreshold_)) {
+		breached = true;
+		threshold_events_.push({
+			basket_price_data.getBasketId(),
+			tickEvent.eventType_,
+			prev_last_price,
+			new_last_price,
+			deltaPercentage(prev_last_price, new_last_price),
+			basket_price_data.getBasketName()
+		});
+	  }
+
+	} else {
+	  const WeightedPriceType prev_mid_price = basket_price_data.getMidPrice();
+
+	  if (tickEvent.eventType_ == TickEventType::ASK) {
+		basket_price_data.setAskPrice(basket_price_data.getAskPrice() + basket_weighted_delta);
+	  } else if (tickEvent.eventType_ == TickEventType::BID) {
+		basket_price_data.setBidPrice(basket_price_data.getBidPrice() + basket_weighted_delta);
+	  }
+
+	  const auto new_mid_price = basket_price_data.getMidPrice();
+
+	  if (isThresholdBreached(prev_mid_price, new_mid_price,
+							  basket_price_data.getBasketConfiguration().midPriceThreshold_)) {
+		breached = true;
+		threshold_events_.push({
+			basket_price_data.getBasketId(),
+			tickEvent.eventType_,
+			prev_mid_price,
+			new_mid_price,
+			deltaPercentage(prev_mid_price, new_mid_price),
+			basket_price_data.getBasketName()
+		});
+	  }
+	}
+
+	publishBasketUpdate(basket_price_data, tickEvent.event_timestamp_);
+  }
+
+  tick_latency_.record(latency_start, tickEvent.eventType_, breached);
+}
+// *** Critical Fast Path Complete ***
+
+inline void BasketPricer::onTickBatch(const std::span<const TickEvent> &ticks, const bool &endOfBatch) {
+  if (conflate_same_timestamp_) {
+	for (const auto &tickEvent : ticks) conflateTick(tickEvent);
+	// the end of a batch ends the timestamp, no need to wait for the next one
+	if (endOfBatch && !touched_instruments_.empty()) flushConflatedTicks();
+  } else {
+	// while a tick is priced, the instrument price and the basket index entries of a later one are fetched
+	for (std::size_t i = 0; i < ticks.size(); i++) {
+	  if (i + TICK_PREFETCH_DISTANCE < ticks.size()) prefetchTick(ticks[i + TICK_PREFETCH_DISTANCE]);
+	  onTickUpdate(ticks[i]);
+	}
+  }
+
+  // the updates of a timestamp still conflated come later, counting at least the ticks priced so far
+  if (basket_update_broadcast_) {
+	basket_update_broadcast_->publishTickSequence(tick_sequence_ - !touched_instruments_.empty());
+  }
+}
+
+}
@@ -0,0 +1,88 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+#include "Basket.h"
+
+namespace basket::pricer {
+
+// Binary image of a BasketsComposition, written by CompileBasketSnapshot and mapped as is by
+// BasketsComposition::loadSnapshot. A header followed by the composition arrays, each a section starting on a
+// cache line so the mapping can be viewed in place. Numbers are in the native byte order, the weights and
+// thresholds in the fixed point scales recorded in the header, which must match the ones the pricer is built with.
+constexpr char BASKET_SNAPSHOT_MAGIC[8] = {'B', 'K', 'C', 'O', 'M', 'P', '0', '1'};
+constexpr std::uint32_t BASKET_SNAPSHOT_VERSION = 1;
+constexpr std::size_t BASKET_SNAPSHOT_ALIGNMENT = CACHE_LINE_SIZE;
+
+enum BasketSnapshotSection : std::uint32_t {
+  INSTRUMENT_NAME_OFFSETS,     // uint64_t, instrument count + 1
+  INSTRUMENT_NAMES,            // char, concatenated
+  INSTRUMENTS_BY_NAME,         // int32_t, instrument ids ordered by name
+  BASKET_NAME_OFFSETS,         // uint64_t, basket count + 1
+  BASKET_NAMES,                // char, concatenated
+  BASKET_CONFIGURATIONS,       // BasketConfiguration, per basket
+  BASKET_CONSTITUENT_OFFSETS,  // uint64_t, basket count + 1
+  BASKET_CONSTITUENTS,         // BasketConstituent, per basket ordered by instrument id
+  INSTRUMENT_BASKET_OFFSETS,   // uint64_t, instrument count + 1
+  INSTRUMENT_BASKETS,          // BasketWeight, per instrument ordered by basket id
+  SECTION_COUNT
+};
+
+struct BasketSnapshotSectionEntry {
+  std::uint64_t offset_{0};  // bytes from the start of the file
+  std::uint64_t size_{0};    // bytes
+};
+
+struct BasketSnapshotHeader {
+  char magic_[8]{};
+  std::uint32_t version_{0};
+  std::uint32_t section_count_{0};
+  std::int64_t weight_scale_{0};
+  std::int64_t threshold_scale_{0};
+  std::uint64_t instrument_count_{0};
+  std::uint64_t basket_count_{0};
+  std::uint64_t constituent_count_{0};
+  std::uint64_t file_size_{0};
+  // basketSnapshotChecksum of everything after the header
+  std::uint64_t checksum_{0};
+  BasketSnapshotSectionEntry sections_[SECTION_COUNT]{};
+};
+
+static_assert(std::is_trivially_copyable_v<BasketSnapshotHeader>);
+static_assert(std::is_trivially_copyable_v<BasketConfiguration> && sizeof(BasketConfiguration) == 16);
+static_assert(std::is_trivially_copyable_v<BasketConstituent> && sizeof(BasketConstituent) == 16);
+static_assert(std::is_trivially_copyable_v<BasketWeight> && sizeof(BasketWeight) == 16);
+
+// 64 bit checksum, four independent multiply-rotate lanes over 32 byte strides so it runs near memory bandwidth.
+// Guards against truncated or corrupted files, not against tampering.
+inline std::uint64_t basketSnapshotChecksum(const char *data, const std::size_t &size) {
+  constexpr std::uint64_t PRIME_1 = 0x9e3779b185ebca87ULL;
+  constexpr std::uint64_t PRIME_2 = 0xc2b2ae3d27d4eb4fULL;
+
+  std::uint64_t lanes[4] = {PRIME_1, PRIME_2, ~PRIME_1, ~PRIME_2};
+  auto mix = [](std::uint64_t lane, const std::uint64_t &word) {
+	lane += word * PRIME_2;
+	lane = (lane << 31) | (lane >> 33);
+	return lane * PRIME_1;
+  };
+
+  std::size_t position = 0;
+  for (; position + 32 <= size; position += 32) {
+	std::uint64_t words[4];
+	std::memcpy(words, data + position, sizeof(words));
+	for (int lane = 0; lane < 4; lane++) lanes[lane] = mix(lanes[lane], words[lane]);
+  }
+
+  std::uint64_t tail[4]{};
+  std::memcpy(tail, data + position, size - position);
+  for (int lane = 0; lane < 4; lane++) lanes[lane] = mix(lanes[lane], tail[lane]);
+
+  std::uint64_t checksum = size * PRIME_1;
+  for (const auto &lane : lanes) checksum = mix(checksum ^ lane, lane);
+  return checksum ^ (checksum >> 29);
+}
+
+}
@@ -0,0 +1,220 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <functional>
+#include <memory>
+#include <span>
+#include <vector>
+
+#include "base/types.h"
+
+namespace basket::pricer {
+
+// A basket's prices after an update by the pricing thread
+struct BasketUpdate {
+  int basket_id_{-1};
+  // generation of the composition the basket id refers to, see BasketPricer::getCompositionGeneration
+  std::uint32_t composition_generation_{0};
+  // timestamp of the tick which moved the basket
+  std::uint64_t event_timestamp_{0};
+  // ticks priced by the pricer up to the one which moved the basket, a conflated timestamp counts all of its ticks
+  std::uint64_t tick_sequence_{0};
+  WeightedPriceType bid_price_{0};
+  WeightedPriceType ask_price_{0};
+  WeightedPriceType mid_price_{0};
+  WeightedPriceType last_price_{0};
+};
+
+// Broadcast ring of basket updates, written by one pricing thread and read by any number of BasketUpdateSubscriber.
+// The writer never looks at the readers: it overwrites the oldest update once the ring is full, a subscriber lapped
+// by it skips to the oldest update still there and counts the ones it lost. Each slot is guarded by a sequence
+// number, a reader rejects the copy the writer overwrote meanwhile.
+class BasketUpdateBroadcast {
+ public:
+  // capacity is rounded up to a power of 2
+  explicit BasketUpdateBroadcast(const std::size_t &capacity);
+
+  BasketUpdateBroadcast() = delete;
+
+  BasketUpdateBroadcast(const BasketUpdateBroadcast &) = delete;
+
+  BasketUpdateBroadcast &operator=(const BasketUpdateBroadcast &) = delete;
+
+  BasketUpdateBroadcast(BasketUpdateBroadcast &&) noexcept = delete;
+
+  BasketUpdateBroadcast &operator=(BasketUpdateBroadcast &&) noexcept = delete;
+
+  ~BasketUpdateBroadcast() = default;
+
+  // Writer side
+  inline void publish(const BasketUpdate &update) {
+	Slot &slot = slots_[head_ & mask_];
+
+	// odd while written, the fence keeps the update stores after it
+	slot.sequence_.store(2 * head_ + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.update_ = update;
+	slot.sequence_.store(2 * head_ + 2, std::memory_order_release);
+
+	head_++;
+	published_.store(head_, std::memory_order_release);
+  }
+
+  // Writer side, once every update of the first tick_sequence ticks priced was published: a subscriber conflating per
+  // window of ticks closes the window the pricer moved past without waiting for an update of a later one
+  inline void publishTickSequence(const std::uint64_t &tick_sequence) {
+	tick_sequence_.store(tick_sequence, std::memory_order_release);
+  }
+
+  // Writer side, after the last update, subscribers running run() return once they read everything before it
+  void close() {
+	closed_.store(true, std::memory_order_release);
+  }
+
+  [[nodiscard]] bool isClosed() const {
+	return closed_.load(std::memory_order_acquire);
+  }
+
+  // updates published so far
+  [[nodiscard]] std::uint64_t getPublishedCount() const {
+	return published_.load(std::memory_order_acquire);
+  }
+
+  // ticks whose updates were all published, see publishTickSequence
+  [[nodiscard]] std::uint64_t getTickSequence() const {
+	return tick_sequence_.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] std::size_t getCapacity() const {
+	return mask_ + 1;
+  }
+
+ private:
+  friend class BasketUpdateSubscriber;
+
+  struct Slot {
+	// 2 * n + 1 while update n is written, 2 * n + 2 once it can be read
+	std::atomic<std::uint64_t> sequence_{0};
+	BasketUpdate update_{};
+  };
+
+  // reader side, the slot update position is written to
+  [[nodiscard]] const Slot &getSlot(const std::uint64_t &position) const {
+	return slots_[position & mask_];
+  }
+
+  std::uint64_t mask_;
+  std::unique_ptr<Slot[]> slots_;
+
+  // written by the writer only
+  std::uint64_t head_{0};
+
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> published_{0};
+  std::atomic<std::uint64_t> tick_sequence_{0};
+  std::atomic<bool> closed_{false};
+};
+
+enum class BasketUpdateConflation : std::uint8_t {
+  // every update as read
+  EVERY_UPDATE,
+  // the latest update of each basket moved within a window of ticks_per_window_ ticks, once an update of a later
+  // window arrives or, on an empty poll, once the pricer priced past the window
+  LATEST_PER_TICKS,
+  // the latest update of each basket moved within a slice of interval_, once the slice is over
+  LATEST_PER_INTERVAL
+};
+
+struct BasketUpdateSubscription {
+  BasketUpdateConflation conflation_{BasketUpdateConflation::EVERY_UPDATE};
+  std::uint64_t ticks_per_window_{64};
+  std::chrono::nanoseconds interval_{std::chrono::milliseconds(100)};
+};
+
+// Reads a BasketUpdateBroadcast from the next update published on, conflated as subscribed, on the thread calling
+// poll() or run(). Conflated updates come in the order their baskets first moved within the window or slice.
+// A subscriber slower than the pricer loses the updates overwritten before it read them, conflating ones included.
+class BasketUpdateSubscriber {
+ public:
+  using CallbackFunc = std::function<void(const std::span<const BasketUpdate> &updates)>;
+
+  BasketUpdateSubscriber(std::shared_ptr<const BasketUpdateBroadcast> broadcast,
+						 CallbackFunc &&callback,
+						 const BasketUpdateSubscription &subscription = {});
+
+  BasketUpdateSubscriber() = delete;
+
+  BasketUpdateSubscriber(const BasketUpdateSubscriber &) = delete;
+
+  BasketUpdateSubscriber &operator=(const BasketUpdateSubscriber &) = delete;
+
+  BasketUpdateSubscriber(BasketUpdateSubscriber &&) noexcept = delete;
+
+  BasketUpdateSubscriber &operator=(BasketUpdateSubscriber &&) noexcept = delete;
+
+  ~BasketUpdateSubscriber() = default;
+
+  // Reads up to READ_BATCH_SIZE updates and hands the callback those due, returns how many were read
+  std::size_t poll();
+
+  // hands the callback the conflated updates held so far
+  void flush();
+
+  // Polls until stop() is called or the broadcast is closed and read to the end, then flushes. Spins, then yields,
+  // then sleeps between empty polls, see PollBackoff.
+  void run();
+
+  // any thread, run() returns after its current poll
+  void stop() {
+	stopped_.store(true, std::memory_order_release);
+  }
+
+  // any thread, updates read, lost to the writer lapping the subscriber and handed to the callback
+  [[nodiscard]] std::uint64_t getReadCount() const {
+	return read_count_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] std::uint64_t getGapCount() const {
+	return gap_count_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] std::uint64_t getDeliveredCount() const {
+	return delivered_count_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  constexpr static std::size_t READ_BATCH_SIZE = 256;
+
+  // copies the update at position_ into update, skipping what was overwritten, false when none is published yet
+  bool tryRead(BasketUpdate &update);
+
+  // keeps the update as the latest of its basket, after delivering those held for another composition generation
+  void hold(const BasketUpdate &update);
+
+  std::shared_ptr<const BasketUpdateBroadcast> broadcast_;
+  CallbackFunc callback_;
+  BasketUpdateSubscription subscription_;
+
+  // next update read
+  std::uint64_t position_{0};
+
+  std::vector<BasketUpdate> batch_{};
+
+  // conflated updates held, all of one composition generation, in the order their baskets first moved, and their
+  // positions by basket id, -1 when none
+  std::vector<BasketUpdate> held_{};
+  std::vector<int> held_positions_{};
+  std::uint32_t held_generation_{0};
+  std::uint64_t tick_window_{0};
+  std::chrono::steady_clock::time_point next_delivery_{};
+
+  std::atomic<bool> stopped_{false};
+
+  // written by the polling thread only
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> read_count_{0};
+  std::atomic<std::uint64_t> gap_count_{0};
+  std::atomic<std::uint64_t> delivered_count_{0};
+};
+
+}
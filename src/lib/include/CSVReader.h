@@ -1,18 +1,75 @@
 #pragma once
 
+#include <charconv>
+#include <cstring>
+#include <span>
 #include <string>
+#include <string_view>
+#include <system_error>
+#include <type_traits>
 #include <vector>
 
+#include "base/mapped_file.h"
+
 namespace basket::pricer {
 struct CSVReader {
   using RowData = std::vector<std::vector<std::string>>;
 
+  // fields of one line, viewing the mapped file - valid during the row callback only
+  using RowView = std::span<const std::string_view>;
+
   explicit CSVReader(const std::string &filename) : csv_path_(filename) {
   };
 
+  // whole file as strings, a copy of every field - prefer forEachRow for large files
   const RowData getData() const;
 
+  // Maps the file and calls f(RowView) for each line, in file order, without copying any field.
+  // Lines split on ',' only, a trailing '\r' is dropped, an empty line is a single empty field.
+  template<typename F>
+  void forEachRow(F &&f) const {
+	MappedFile file(csv_path_);
+	const std::string_view content = file.view();
+
+	std::vector<std::string_view> fields;
+	std::size_t line_start = 0;
+	while (line_start < content.size()) {
+	  const auto *line_end_ptr = static_cast<const char *>(
+		  std::memchr(content.data() + line_start, '\n', content.size() - line_start));
+	  const std::size_t line_end = line_end_ptr ? line_end_ptr - content.data() : content.size();
+
+	  std::string_view line = content.substr(line_start, line_end - line_start);
+	  if (!line.empty() && line.back() == '\r') line.remove_suffix(1);
+
+	  fields.clear();
+	  std::size_t field_start = 0;
+	  for (std::size_t comma = line.find(','); comma != std::string_view::npos; comma = line.find(',', field_start)) {
+		fields.push_back(line.substr(field_start, comma - field_start));
+		field_start = comma + 1;
+	  }
+	  fields.push_back(line.substr(field_start));
+
+	  f(RowView{fields});
+	  line_start = line_end + 1;
+	}
+  }
+
+  // Parses a whole field, surrounding blanks and a leading '+' allowed, leaving value untouched on failure
+  template<typename T>
+  static bool parseField(std::string_view field, T &value) {
+	while (!field.empty() && (field.front() == ' ' || field.front() == '\t')) field.remove_prefix(1);
+	while (!field.empty() && (field.back() == ' ' || field.back() == '\t')) field.remove_suffix(1);
+	if (field.size() > 1 && field.front() == '+') field.remove_prefix(1);
+
+	T parsed{};
+	const auto [end, error] = std::from_chars(field.data(), field.data() + field.size(), parsed);
+	if (error != std::errc{} || end != field.data() + field.size()) return false;
+
+	value = parsed;
+	return true;
+  }
+
  private:
   const std::string csv_path_{""};
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,90 @@
+#pragma once
+
+#include <chrono>
+#include <condition_variable>
+#include <cstdint>
+#include <filesystem>
+#include <functional>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "Basket.h"
+
+namespace basket::pricer {
+
+struct CompositionWatcherConfiguration {
+  // how often the composition files are checked for changes
+  std::chrono::milliseconds poll_interval_{1000};
+};
+
+// Rebuilds the basket composition on a background thread whenever its files change, or on demand, and hands it to
+// a callback such as BasketPricer::reloadComposition. The files are either the basket data and basket config csv
+// files or a single composition snapshot. A composition which fails to load or is rejected by the callback is
+// reported on standard error and the previous one stays in use.
+class CompositionWatcher {
+ public:
+  using ReloadFunc = std::function<void(const BasketsComposition &)>;
+
+  CompositionWatcher(std::vector<std::string> compositionPaths,
+					 ReloadFunc onReload,
+					 const CompositionWatcherConfiguration &configuration = {});
+
+  CompositionWatcher() = delete;
+
+  CompositionWatcher(const CompositionWatcher &) = delete;
+
+  CompositionWatcher &operator=(const CompositionWatcher &) = delete;
+
+  CompositionWatcher(CompositionWatcher &&) noexcept = delete;
+
+  CompositionWatcher &operator=(CompositionWatcher &&) noexcept = delete;
+
+  // stops the watcher thread
+  ~CompositionWatcher();
+
+  // starts watching, changes made from now on are reloaded
+  void start();
+
+  void stop();
+
+  // reloads on the watcher thread as soon as possible, whether the files changed or not
+  void trigger();
+
+  [[nodiscard]] std::uint64_t getReloadCount() const;
+
+  [[nodiscard]] std::uint64_t getFailedReloadCount() const;
+
+ private:
+  struct FileVersion {
+	std::filesystem::file_time_type modified_{};
+	std::uintmax_t size_{0};
+
+	bool operator==(const FileVersion &) const = default;
+  };
+
+  [[nodiscard]] std::vector<FileVersion> readFileVersions() const;
+
+  void reload();
+
+  void run();
+
+  const std::vector<std::string> composition_paths_;
+  const ReloadFunc on_reload_;
+  const CompositionWatcherConfiguration configuration_;
+
+  // versions of the files last loaded, watcher thread only
+  std::vector<FileVersion> loaded_versions_{};
+
+  mutable std::mutex mutex_{};
+  std::condition_variable wake_up_{};
+  bool stopping_{false};
+  bool triggered_{false};
+  std::uint64_t reload_count_{0};
+  std::uint64_t failed_reload_count_{0};
+
+  std::thread thread_{};
+};
+
+}
@@ -0,0 +1,152 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <exception>
+#include <memory>
+#include <ostream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "IMarketDataProvider.h"
+#include "LatencyHistogram.h"
+#include "SpscRingBuffer.h"
+#include "TickEvent.h"
+
+namespace basket::pricer {
+
+struct MarketDataSource {
+  // names the source in the counters
+  std::string name_{};
+  std::shared_ptr<IMarketDataProvider> provider_{};
+  // instruments subscribed from this source, empty takes every instrument of the subscriber
+  std::vector<std::string> instrument_list_{};
+};
+
+struct FanInConfiguration {
+  // ticks queued per source, a source publishing into a full queue spins
+  std::size_t queue_capacity_{1 << 14};
+  ConsumerWaitPolicy wait_policy_{ConsumerWaitPolicy::PARK};
+};
+
+struct FanInSourceCounters {
+  std::string name_{};
+  std::uint64_t ticks_{0};
+  // publications which found the queue full
+  std::uint64_t full_{0};
+  // ticks queued when the source was last polled, and the most ever seen queued
+  std::uint64_t queue_depth_{0};
+  std::uint64_t max_queue_depth_{0};
+};
+
+// Merges the ticks of several providers, e.g. one per venue, onto the thread calling run().
+// Every source runs on its own thread and publishes into its own SPSC tick queue, which run() polls round robin,
+// delivering each source's ticks in the order it published them - no lock is taken on either side. Sources
+// subscribe their subset of the subscriber's instruments and their ticks carry the subscriber's instrument ids;
+// an instrument taken from two sources is priced from whichever ticked last. A delivered batch ends a timestamp
+// where its source ended one, and once every source is quiet an empty batch ends the timestamp delivered last.
+class FanInMarketDataProvider : public IMarketDataProvider {
+ public:
+  explicit FanInMarketDataProvider(std::vector<MarketDataSource> &&sources, const FanInConfiguration &configuration = {});
+
+  FanInMarketDataProvider() = delete;
+
+  FanInMarketDataProvider(const FanInMarketDataProvider &) = delete;
+
+  FanInMarketDataProvider &operator=(const FanInMarketDataProvider &) = delete;
+
+  FanInMarketDataProvider(FanInMarketDataProvider &&) noexcept = delete;
+
+  FanInMarketDataProvider &operator=(FanInMarketDataProvider &&) noexcept = delete;
+
+  ~FanInMarketDataProvider();
+
+  // subscribes every source to its instruments
+  void subscribeBatch(BatchCallbackFunc &&callback, std::vector<std::string> &&instrumentList) override;
+
+  // Runs every source on a thread of its own and delivers their ticks, up to DELIVERY_BATCH_SIZE of a source per
+  // batch. Returns once every source returned and its ticks were delivered, rethrowing what a source threw. When the
+  // subscriber throws, the sources are stopped at their next tick and joined before the exception is rethrown.
+  void run() override;
+
+  // any thread, a snapshot per source in source order
+  [[nodiscard]] std::vector<FanInSourceCounters> getSourceCounters() const;
+
+  // LatencyClock ticks from a source publishing a tick to the subscriber being done with it
+  [[nodiscard]] const LatencyHistogram &getSourceLatency(const std::size_t &source) const {
+	return sources_[source]->latency_;
+  }
+
+  // per source tick and queue counters and latency percentiles in nanoseconds
+  void dumpSourceCounters(std::ostream &os) const;
+
+ private:
+  constexpr static std::size_t DELIVERY_BATCH_SIZE = 64;
+  constexpr static int SPINS_BEFORE_PARKING = 1024;
+
+  struct QueuedTick {
+	TickEvent tick_event_{};
+	std::uint64_t published_at_{0};
+	// the last tick of a batch the source published with endOfBatch
+	bool end_of_batch_{false};
+  };
+
+  struct Source {
+	Source(MarketDataSource &&source, const FanInConfiguration &configuration)
+		: source_(std::move(source)),
+		  ticks_(configuration.queue_capacity_, OverflowPolicy::SPIN, ConsumerWaitPolicy::BUSY_POLL) {
+	}
+
+	MarketDataSource source_;
+	// source instrument id -> subscriber instrument id
+	std::vector<InstrumentIdType> instrument_remap_{};
+	SpscRingBuffer<QueuedTick> ticks_;
+	std::thread thread_{};
+	std::exception_ptr error_{};
+
+	// written by the run() thread only
+	bool drained_{false};
+	alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> delivered_{0};
+	std::atomic<std::uint64_t> queue_depth_{0};
+	std::atomic<std::uint64_t> max_queue_depth_{0};
+	LatencyHistogram latency_{};
+  };
+
+  // source side, wakes run() up when parked
+  void wakeUp();
+
+  // delivers up to DELIVERY_BATCH_SIZE ticks of the source, no further than the end of one of its batches, returns
+  // how many
+  std::size_t deliver(Source &source);
+
+  // an empty end of batch, unless the last batch delivered ended one already
+  void deliverEndOfBatch();
+
+  // true when a source not drained yet has ticks queued or is done
+  [[nodiscard]] bool isAnySourceReady() const;
+
+  // run() thread, returns once a source is ready or after a spurious wake up
+  void waitForSources(int &idle_sweeps);
+
+  // run() thread, makes every source's callback throw, frees room in the queues and joins the sources
+  void stopSources();
+
+  void joinSources();
+
+  FanInConfiguration configuration_;
+  std::atomic<bool> stopping_{false};
+  std::vector<std::unique_ptr<Source>> sources_{};
+
+  std::vector<TickEvent> batch_{};
+  std::vector<std::uint64_t> published_at_{};
+  bool end_of_batch_due_{false};
+
+  struct alignas(CACHE_LINE_SIZE) ParkingState {
+	std::atomic<bool> parked_{false};
+	std::atomic<std::uint32_t> wake_ups_{0};
+  };
+  ParkingState parking_{};
+};
+
+}
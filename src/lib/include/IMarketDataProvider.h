@@ -1,20 +1,39 @@
 #pragma once
 
 #include <functional>
-#include <set>
+#include <span>
 #include <string>
+#include <vector>
+
+#include "TickEvent.h"
 
 namespace basket::pricer {
-class TickEvent;
 
 class IMarketDataProvider {
  public:
   using CallbackFunc = std::function<void(const TickEvent &tickEvent)>;
 
-  virtual void subscribe(CallbackFunc &&callback, std::vector<std::string> &&instrumentList) = 0;
+  // Ticks in delivery order, contiguous in memory and only valid for the duration of the call. endOfBatch tells no
+  // tick delivered later carries the timestamp of the last tick of the span, hence whatever the subscriber groups
+  // per timestamp can be completed right away.
+  using BatchCallbackFunc = std::function<void(const std::span<const TickEvent> &ticks, const bool &endOfBatch)>;
+
+  virtual ~IMarketDataProvider() = default;
+
+  // Interns the instrument symbols - the position of an instrument in instrumentList is the
+  // instrument id carried by every TickEvent published for it
+  virtual void subscribeBatch(BatchCallbackFunc &&callback, std::vector<std::string> &&instrumentList) = 0;
+
+  // one call per tick, over subscribeBatch
+  virtual void subscribe(CallbackFunc &&callback, std::vector<std::string> &&instrumentList) {
+	subscribeBatch([callback = std::move(callback)](const std::span<const TickEvent> &ticks, const bool &) {
+	  for (const auto &tickEvent : ticks) callback(tickEvent);
+	}, std::move(instrumentList));
+  }
+
   virtual void run() = 0;
 
  protected:
-  CallbackFunc callback_{};
+  BatchCallbackFunc callback_{};
 };
-}
\ No newline at end of file
+}
@@ -0,0 +1,20 @@
+#pragma once
+
+#include <span>
+
+#include "ThresholdEvent.h"
+
+namespace basket::pricer {
+
+// Output of the threshold events of a pricer, called from its printer thread only: write() with each batch of events
+// in the order they were emitted, flush() whenever the pricer has caught up and once more when it stops.
+// Basket names are views which are only valid during write().
+class IThresholdEventSink {
+ public:
+  virtual ~IThresholdEventSink() = default;
+
+  virtual void write(const std::span<const ThresholdEvent> &events) = 0;
+
+  virtual void flush() = 0;
+};
+}
@@ -1,12 +1,18 @@
 #pragma once
 
+#include <array>
+#include <cstdint>
+#include <cstdlib>
 #include <memory>
+#include <random>
 #include <string>
 #include <vector>
 #include <utility>
 
-#include "base/types.h"
+#include "base/fixed_point.h"
+#include "base/xoshiro.h"
 
+#include "InstrumentPrice.h"
 #include "RandomDistributionGeneratorFactory.h"
 
 namespace basket::pricer {
@@ -15,84 +21,212 @@ enum class Side : uint16_t {
   ASK
 };
 
-struct InstrumentSimulationModel {
+using SideGenerator = BlockDistributionGenerator<UniformRealDistribution>;
+
+// Shape of a model - the distribution types of its draws in the price shape loop (next event time, direction and
+// tick move). Models of one shape share an instantiation of the loop with every draw inlined.
+constexpr static std::size_t MODEL_SHAPE_COUNT = DISTRIBUTION_TYPE_COUNT * DISTRIBUTION_TYPE_COUNT * DISTRIBUTION_TYPE_COUNT;
+
+constexpr std::size_t modelShape(const DistributionType &next_event_time,
+								 const DistributionType &direction,
+								 const DistributionType &tick_move) {
+  return (static_cast<std::size_t>(next_event_time) * DISTRIBUTION_TYPE_COUNT + static_cast<std::size_t>(direction))
+	  * DISTRIBUTION_TYPE_COUNT + static_cast<std::size_t>(tick_move);
+}
+
+// Simulation model of an instrument, drawing from generators of any distribution (RandomDistributionGenerator)
+// or of the distribution its shape fixes at compile time (BlockDistributionGenerator<D>)
+template<typename NextEventTimeRg, typename DirectionRg, typename TickMoveRg>
+class BasicInstrumentSimulationModel {
  public:
 
-  InstrumentSimulationModel() = delete;
+  BasicInstrumentSimulationModel() = delete;
 
-  InstrumentSimulationModel(std::unique_ptr<IRandomDistributionGenerator> next_event_time_rg,
-							std::unique_ptr<IRandomDistributionGenerator> initial_price_rg,
-							std::unique_ptr<IRandomDistributionGenerator> direction_rg,
-							std::unique_ptr<IRandomDistributionGenerator> tick_move_rg,
-							std::unique_ptr<IRandomDistributionGenerator> side_rg,
-							const int &max_tick_diff)
+  BasicInstrumentSimulationModel(NextEventTimeRg next_event_time_rg,
+								 RandomDistributionGenerator initial_price_rg,
+								 DirectionRg direction_rg,
+								 TickMoveRg tick_move_rg,
+								 SideGenerator side_rg,
+								 const int &max_tick_diff)
 	  : next_event_time_rg_(std::move(next_event_time_rg)), initial_price_rg_(std::move(initial_price_rg)),
 		direction_rg_(std::move(direction_rg)), tick_move_rg_(std::move(tick_move_rg)),
 		side_rg_(std::move(side_rg)), max_tick_diff_(max_tick_diff) {
   }
 
-  InstrumentSimulationModel(const InstrumentSimulationModel &) = delete;
+  BasicInstrumentSimulationModel(const BasicInstrumentSimulationModel &) = delete;
 
-  InstrumentSimulationModel &operator=(const InstrumentSimulationModel &) = delete;
+  BasicInstrumentSimulationModel &operator=(const BasicInstrumentSimulationModel &) = delete;
 
-  InstrumentSimulationModel(InstrumentSimulationModel &&) noexcept = default;
+  BasicInstrumentSimulationModel(BasicInstrumentSimulationModel &&) noexcept = default;
 
-  InstrumentSimulationModel &operator=(InstrumentSimulationModel &&) noexcept = default;
+  BasicInstrumentSimulationModel &operator=(BasicInstrumentSimulationModel &&) noexcept = default;
 
-  ~InstrumentSimulationModel() = default;
+  ~BasicInstrumentSimulationModel() = default;
 
-  inline std::uint64_t getNextEventTime() const {
-	int value = static_cast<int>(next_event_time_rg_->getNextValue());
+  inline std::uint64_t getNextEventTime() {
+	int value = static_cast<int>(next_event_time_rg_.getNextValue());
 	return (value < 1) ? 1 : value;
   }
 
-  inline PriceType getInitialPrice() const {
-	return static_cast<PriceType>(initial_price_rg_->getNextValue());
+  inline PriceType getInitialPrice() {
+	return toPrice(initial_price_rg_.getNextValue());
   }
 
-  inline int getDirection() const {
-	return (direction_rg_->getNextValue() < 0.5) ? -1 : 1;
+  inline int getDirection() {
+	return (direction_rg_.getNextValue() < 0.5) ? -1 : 1;
   }
 
-  inline Side getSide() const {
-	return (side_rg_->getNextValue() < 0.5) ? Side::BID : Side::ASK;
+  inline Side getSide() {
+	return (side_rg_.getNextValue() < 0.5) ? Side::BID : Side::ASK;
   }
 
-  inline int getTickMove() const {
-	return static_cast<int>(tick_move_rg_->getNextValue());
+  inline int getTickMove() {
+	return static_cast<int>(tick_move_rg_.getNextValue());
   }
 
   inline int getMaxTickDiff() const {
 	return max_tick_diff_;
   }
 
+  // runtime dispatched models only
+  [[nodiscard]] std::size_t getShape() const {
+	return modelShape(next_event_time_rg_.getType(), direction_rg_.getType(), tick_move_rg_.getType());
+  }
+
+  // the same model drawing the same sequences, its generators fixed to the distributions of its shape
+  template<typename NextEventTime, typename Direction, typename TickMove>
+  BasicInstrumentSimulationModel<BlockDistributionGenerator<NextEventTime>,
+								 BlockDistributionGenerator<Direction>,
+								 BlockDistributionGenerator<TickMove>> specialize() && {
+	return {std::move(next_event_time_rg_).template release<NextEventTime>(),
+			std::move(initial_price_rg_),
+			std::move(direction_rg_).template release<Direction>(),
+			std::move(tick_move_rg_).template release<TickMove>(),
+			std::move(side_rg_),
+			max_tick_diff_};
+  }
+
  private:
-  std::unique_ptr<IRandomDistributionGenerator> next_event_time_rg_{};
-  std::unique_ptr<IRandomDistributionGenerator> initial_price_rg_{};
-  std::unique_ptr<IRandomDistributionGenerator> direction_rg_{};
-  std::unique_ptr<IRandomDistributionGenerator> tick_move_rg_{};
-  std::unique_ptr<IRandomDistributionGenerator> side_rg_{};
+  NextEventTimeRg next_event_time_rg_;
+  RandomDistributionGenerator initial_price_rg_;
+  DirectionRg direction_rg_;
+  TickMoveRg tick_move_rg_;
+  SideGenerator side_rg_;
   int max_tick_diff_{};
 };
 
+using InstrumentSimulationModel =
+	BasicInstrumentSimulationModel<RandomDistributionGenerator, RandomDistributionGenerator, RandomDistributionGenerator>;
+
+// next bid / ask shape of an instrument as per its simulation model
+template<typename Model>
+InstrumentPrice produceNewPriceShape(Model &model, const InstrumentPrice &currentInstrumentPrice) {
+  static_assert(PRICE_SCALE % 100 == 0, "price scale must represent a 0.01 tick exactly");
+  static constexpr PriceType ticksize = PRICE_SCALE / 100;
+
+  auto newInstrumentPrice = currentInstrumentPrice;
+
+  const PriceType &currBidPrice = currentInstrumentPrice.getBidPrice();
+  const PriceType &currAskPrice = currentInstrumentPrice.getAskPrice();
+
+  if (currBidPrice != 0 && currAskPrice != 0) {
+
+	int maxTickMove = model.getMaxTickDiff();
+	int newTickDiff{0};
+
+	do {
+	  newInstrumentPrice = currentInstrumentPrice;
+
+	  int tickMove = model.getTickMove();
+	  int direction = model.getDirection();
+	  auto side = model.getSide();
+	  PriceType delta = ticksize * tickMove * direction;
+
+	  if (side == Side::BID) {
+		PriceType newPrice = currBidPrice + delta;
+		newInstrumentPrice.setBidPrice(newPrice);
+
+		if (newPrice > 0 && newInstrumentPrice.getBidPrice() >= newInstrumentPrice.getAskPrice()) {
+		  // bid crossed ask -> traded up and move price up
+		  newInstrumentPrice.setAskPrice(newPrice + (model.getTickMove() * ticksize));
+		}
+	  } else if (side == Side::ASK) {
+		PriceType newPrice = currAskPrice + delta;
+		newInstrumentPrice.setAskPrice(newPrice);
+
+		if (newPrice > 0 && newInstrumentPrice.getBidPrice() >= newInstrumentPrice.getAskPrice()) {
+		  // ask crossed bid -> traded down and move price down
+		  newInstrumentPrice.setBidPrice(newPrice - (model.getTickMove() * ticksize));
+		}
+	  }
+
+	  newTickDiff =
+		  static_cast<int>(std::abs(newInstrumentPrice.getAskPrice() - newInstrumentPrice.getBidPrice()) / ticksize);
+
+	} while (newTickDiff == 0 ||
+		newInstrumentPrice.getAskPrice() <= ticksize ||
+		newInstrumentPrice.getBidPrice() <= ticksize ||
+		maxTickMove < newTickDiff);
+  } else if (currAskPrice == 0)  [[unlikely]] {
+
+	PriceType newPrice{0};
+	if (currBidPrice == 0)
+	  newPrice = model.getInitialPrice();
+	else
+	  newPrice = currBidPrice + (model.getTickMove() * ticksize);
+
+	newInstrumentPrice.setAskPrice(newPrice);
+
+  } else if (currBidPrice == 0) [[unlikely]] {
+
+	PriceType newPrice{0};
+	if (currAskPrice == 0)
+	  newPrice = model.getInitialPrice();
+	else
+	  newPrice = currAskPrice - (model.getTickMove() * ticksize);
+
+	newInstrumentPrice.setBidPrice(newPrice);
+
+  }
+
+  return newInstrumentPrice;
+}
+
 struct InstrumentSimulationFactory {
+  // seeded from std::random_device
   static std::unique_ptr<InstrumentSimulationModel> create(
 	  const std::vector<std::string> &next_event_time_cfg,
 	  const std::vector<std::string> &initial_price_cfg,
 	  const std::vector<std::string> &direction_cfg,
 	  const std::vector<std::string> &tick_move_cfg,
 	  const int &max_tick_diff) {
+	std::random_device rd;
+	return create(next_event_time_cfg, initial_price_cfg, direction_cfg, tick_move_cfg, max_tick_diff,
+				  (static_cast<std::uint64_t>(rd()) << 32) | rd());
+  }
 
-	// a fair chance either to move bid/ask hardcoded
-	std::vector<std::string> side_cfg{"uniform_real_distribution", "0", "1"};
-
-	return std::unique_ptr<InstrumentSimulationModel>(new InstrumentSimulationModel(
-		std::move(RandomDistributionGeneratorFactory::create(next_event_time_cfg)),
-		std::move(RandomDistributionGeneratorFactory::create((initial_price_cfg))),
-		std::move(RandomDistributionGeneratorFactory::create((direction_cfg))),
-		std::move(RandomDistributionGeneratorFactory::create((tick_move_cfg))),
-		std::move(RandomDistributionGeneratorFactory::create((side_cfg))),
-		max_tick_diff));
+  // every generator of the model draws from its own stream, seeded from seed through splitmix64;
+  // the same seed always simulates the same way
+  static std::unique_ptr<InstrumentSimulationModel> create(
+	  const std::vector<std::string> &next_event_time_cfg,
+	  const std::vector<std::string> &initial_price_cfg,
+	  const std::vector<std::string> &direction_cfg,
+	  const std::vector<std::string> &tick_move_cfg,
+	  const int &max_tick_diff,
+	  const std::uint64_t &seed) {
+
+	SplitMix64 seeder(seed);
+	std::array<std::uint64_t, 5> seeds{};
+	for (auto &generator_seed : seeds) generator_seed = seeder.next();
+
+	return std::make_unique<InstrumentSimulationModel>(
+		RandomDistributionGeneratorFactory::create(next_event_time_cfg, seeds[0]),
+		RandomDistributionGeneratorFactory::create(initial_price_cfg, seeds[1]),
+		RandomDistributionGeneratorFactory::create(direction_cfg, seeds[2]),
+		RandomDistributionGeneratorFactory::create(tick_move_cfg, seeds[3]),
+		// a fair chance either to move bid/ask hardcoded
+		SideGenerator(UniformRealDistribution(0, 1), seeds[4]),
+		max_tick_diff);
   }
 };
-}
\ No newline at end of file
+}
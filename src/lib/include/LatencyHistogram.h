@@ -0,0 +1,106 @@
+#pragma once
+
+#include <algorithm>
+#include <array>
+#include <atomic>
+#include <bit>
+#include <cmath>
+#include <cstdint>
+
+namespace basket::pricer {
+
+// Fixed memory log-linear histogram, in the spirit of HdrHistogram.
+// Values below 2^SUB_BUCKET_BITS are counted exactly, larger values land in one of 2^(SUB_BUCKET_BITS - 1) linear
+// sub-buckets of their power of 2, i.e. within 1 / 2^(SUB_BUCKET_BITS - 1) of their true value.
+// Values from 2^MAX_VALUE_BITS up are counted in the last bucket.
+// record() never allocates; a single thread records, any thread may read while it does.
+class LatencyHistogram {
+ public:
+  constexpr static int SUB_BUCKET_BITS = 7;
+  constexpr static int MAX_VALUE_BITS = 40;
+
+  constexpr static std::uint64_t SUB_BUCKET_COUNT = std::uint64_t{1} << SUB_BUCKET_BITS;
+  constexpr static std::uint64_t SUB_BUCKET_HALF_COUNT = SUB_BUCKET_COUNT / 2;
+  constexpr static std::size_t BUCKET_COUNT = SUB_BUCKET_COUNT + (MAX_VALUE_BITS - SUB_BUCKET_BITS) * SUB_BUCKET_HALF_COUNT;
+
+  LatencyHistogram() = default;
+
+  LatencyHistogram(const LatencyHistogram &) = delete;
+
+  LatencyHistogram &operator=(const LatencyHistogram &) = delete;
+
+  ~LatencyHistogram() = default;
+
+  // recording thread only
+  inline void record(const std::uint64_t &value) {
+	increment(counts_[bucketIndex(value)], 1);
+	increment(total_count_, 1);
+	if (value > max_.load(std::memory_order_relaxed)) max_.store(value, std::memory_order_relaxed);
+  }
+
+  // adds the counts of other, the recording thread of this histogram only
+  void merge(const LatencyHistogram &other) {
+	for (std::size_t i = 0; i < BUCKET_COUNT; i++) {
+	  increment(counts_[i], other.counts_[i].load(std::memory_order_relaxed));
+	}
+	increment(total_count_, other.total_count_.load(std::memory_order_relaxed));
+	max_.store(std::max(getMax(), other.getMax()), std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] std::uint64_t getCount() const {
+	return total_count_.load(std::memory_order_relaxed);
+  }
+
+  [[nodiscard]] std::uint64_t getMax() const {
+	return max_.load(std::memory_order_relaxed);
+  }
+
+  // highest value equivalent to the value at the percentile, 0 when nothing was recorded
+  [[nodiscard]] std::uint64_t getValueAtPercentile(const double &percentile) const {
+	std::uint64_t total{0};
+	std::array<std::uint64_t, BUCKET_COUNT> counts;
+	for (std::size_t i = 0; i < BUCKET_COUNT; i++) {
+	  counts[i] = counts_[i].load(std::memory_order_relaxed);
+	  total += counts[i];
+	}
+	if (total == 0) return 0;
+
+	const auto rank = std::max<std::uint64_t>(1, static_cast<std::uint64_t>(std::ceil(percentile / 100.0 * total)));
+
+	std::uint64_t cumulative{0};
+	for (std::size_t i = 0; i < BUCKET_COUNT; i++) {
+	  cumulative += counts[i];
+	  if (cumulative >= rank) return std::min(highestEquivalentValue(i), getMax());
+	}
+	return getMax();
+  }
+
+ private:
+  [[nodiscard]] static inline std::size_t bucketIndex(const std::uint64_t &value) {
+	if (value < SUB_BUCKET_COUNT) return value;
+	if (value >> MAX_VALUE_BITS) return BUCKET_COUNT - 1;
+
+	const int shift = std::bit_width(value) - SUB_BUCKET_BITS;
+	return SUB_BUCKET_COUNT + (shift - 1) * SUB_BUCKET_HALF_COUNT + ((value >> shift) - SUB_BUCKET_HALF_COUNT);
+  }
+
+  [[nodiscard]] static std::uint64_t highestEquivalentValue(const std::size_t &index) {
+	if (index < SUB_BUCKET_COUNT) return index;
+
+	const auto offset = index - SUB_BUCKET_COUNT;
+	const auto shift = offset / SUB_BUCKET_HALF_COUNT + 1;
+	const auto sub_bucket = offset % SUB_BUCKET_HALF_COUNT + SUB_BUCKET_HALF_COUNT;
+	return ((sub_bucket + 1) << shift) - 1;
+  }
+
+  // single writer, a plain load and store rather than a locked read-modify-write
+  static inline void increment(std::atomic<std::uint64_t> &counter, const std::uint64_t &amount) {
+	counter.store(counter.load(std::memory_order_relaxed) + amount, std::memory_order_relaxed);
+  }
+
+  std::array<std::atomic<std::uint64_t>, BUCKET_COUNT> counts_{};
+  std::atomic<std::uint64_t> total_count_{0};
+  std::atomic<std::uint64_t> max_{0};
+};
+
+}
@@ -0,0 +1,148 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "IMarketDataProvider.h"
+#include "SpscRingBuffer.h"
+#include "StaticTickPipeline.h"
+#include "TickEvent.h"
+
+namespace basket::pricer {
+
+// Hands ticks published on one thread to the subscriber on the thread calling run().
+// Ticks are delivered in publication order and never dropped, publish spins while the queue is full.
+class QueuedMarketDataProvider : public IMarketDataProvider {
+ public:
+  explicit QueuedMarketDataProvider(const std::size_t &capacity,
+									const ConsumerWaitPolicy &waitPolicy = ConsumerWaitPolicy::PARK);
+
+  QueuedMarketDataProvider() = delete;
+
+  QueuedMarketDataProvider(const QueuedMarketDataProvider &) = delete;
+
+  QueuedMarketDataProvider &operator=(const QueuedMarketDataProvider &) = delete;
+
+  QueuedMarketDataProvider(QueuedMarketDataProvider &&) noexcept = delete;
+
+  QueuedMarketDataProvider &operator=(QueuedMarketDataProvider &&) noexcept = delete;
+
+  ~QueuedMarketDataProvider() = default;
+
+  void subscribeBatch(BatchCallbackFunc &&callback, std::vector<std::string> &&instrumentList) override;
+
+  // delivers queued ticks, as many as were queued at once up to DELIVERY_BATCH_SIZE per batch, until close() is
+  // called and the queue is drained. A batch published with endOfBatch is delivered with it on its last tick.
+  void run() override;
+
+  // run() delivering straight to the subscriber, see StaticTickPipeline.h
+  template<TickBatchSubscriber Subscriber>
+  void runInto(Subscriber &subscriber);
+
+  // Publisher side
+  inline void publish(const TickEvent &tickEvent) {
+	ticks_.push(tickEvent);
+	published_++;
+  }
+
+  // Publisher side, queues the ticks at once, endOfBatch is handed to the subscriber even with no tick
+  inline void publishBatch(const std::span<const TickEvent> &ticks, const bool &endOfBatch) {
+	// set before the ticks are published, so the subscriber seeing them sees where the batch ends
+	if (endOfBatch) end_of_batch_.store(ticks_.getWritePosition() + ticks.size(), std::memory_order_release);
+
+	if (!ticks.empty()) {
+	  ticks_.pushBatch(ticks);
+	  published_ += ticks.size();
+	} else if (endOfBatch) {
+	  ticks_.notify();
+	}
+  }
+
+  // Publisher side, returns once every tick published so far went through the subscriber callback
+  void waitUntilDrained() const;
+
+  // Publisher side, run() returns after delivering what was published before
+  void close();
+
+  [[nodiscard]] const std::vector<std::string> &getInstrumentList() const {
+	return instrument_list_;
+  }
+
+  // publications which found the queue full
+  [[nodiscard]] std::uint64_t getFullCount() const {
+	return ticks_.getFullCount();
+  }
+
+ private:
+  // ticks delivered between two updates of the processed count
+  constexpr static std::size_t DELIVERY_BATCH_SIZE = 64;
+
+  template<typename Deliver>
+  void runWith(Deliver &deliver);
+
+  SpscRingBuffer<TickEvent> ticks_;
+  std::vector<std::string> instrument_list_{};
+
+  // written by the publisher only
+  std::uint64_t published_{0};
+
+  // queue position the last batch published with endOfBatch ends at
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> end_of_batch_{0};
+
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> processed_{0};
+};
+
+template<TickBatchSubscriber Subscriber>
+void QueuedMarketDataProvider::runInto(Subscriber &subscriber) {
+  auto deliver = [&subscriber](const std::span<const TickEvent> &ticks, const bool &endOfBatch) {
+	subscriber.onTickBatch(ticks, endOfBatch);
+  };
+  runWith(deliver);
+}
+
+template<typename Deliver>
+void QueuedMarketDataProvider::runWith(Deliver &deliver) {
+  std::vector<TickEvent> batch;
+  batch.reserve(DELIVERY_BATCH_SIZE);
+
+  // queue position of the last end of batch handed to the subscriber
+  std::uint64_t delivered_end_of_batch{0};
+
+  while (true) {
+	ticks_.waitForData([this, &delivered_end_of_batch] {
+	  return end_of_batch_.load(std::memory_order_acquire) != delivered_end_of_batch;
+	});
+
+	// pops no further than the end of a batch still ahead
+	const std::uint64_t end_of_batch = end_of_batch_.load(std::memory_order_acquire);
+	const std::uint64_t read_position = ticks_.getReadPosition();
+	const std::size_t max_count = (end_of_batch > read_position)
+								  ? std::min<std::uint64_t>(DELIVERY_BATCH_SIZE, end_of_batch - read_position)
+								  : DELIVERY_BATCH_SIZE;
+
+	batch.clear();
+	const std::size_t count = ticks_.popBatch(batch, max_count);
+
+	bool endOfBatch{false};
+	if (end_of_batch != delivered_end_of_batch && end_of_batch <= ticks_.getReadPosition()) {
+	  // an end of batch published while ticks past it were popped is skipped, the next one will end a batch
+	  endOfBatch = end_of_batch == ticks_.getReadPosition();
+	  delivered_end_of_batch = end_of_batch;
+	}
+
+	if (count == 0 && !endOfBatch) {
+	  // close() is published after the last tick, an empty queue seen after it stays empty
+	  if (ticks_.isClosed() && ticks_.isEmpty()) return;
+	  continue;
+	}
+
+	deliver(std::span<const TickEvent>(batch), endOfBatch);
+
+	processed_.store(processed_.load(std::memory_order_relaxed) + batch.size(), std::memory_order_release);
+  }
+}
+
+}
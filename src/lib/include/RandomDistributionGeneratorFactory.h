@@ -1,34 +1,227 @@
 #pragma once
 
+#include <algorithm>
+#include <array>
+#include <cstddef>
+#include <cstdint>
 #include <random>
-#include <memory>
+#include <string>
+#include <variant>
 #include <vector>
 
+#include "base/xoshiro.h"
+
 namespace basket::pricer {
-class IRandomDistributionGenerator {
+// The closed set of distributions a simulation model draws from, in RandomDistributionGenerator alternative order
+enum class DistributionType : std::uint8_t {
+  POISSON,
+  UNIFORM_REAL,
+  UNIFORM_INT,
+  NORMAL
+};
+
+constexpr static std::size_t DISTRIBUTION_TYPE_COUNT = 4;
+
+namespace detail {
+constexpr static std::size_t DRAW_CHUNK = 64;
+}
+
+// Distribution policies, each generates count values from the engine
+
+// poisson draws of a smaller mean invert a precomputed cumulative distribution, larger means use std
+class PoissonDistribution {
+ public:
+  constexpr static DistributionType TYPE = DistributionType::POISSON;
+  constexpr static double INVERSION_MAX_MEAN = 32;
+
+  explicit PoissonDistribution(const double &mean);
+
+  inline void generate(Xoshiro256PlusPlus &engine, double *out, const std::size_t &count) {
+	if (cdf_.empty()) {
+	  for (std::size_t i = 0; i < count; i++) out[i] = poisson_(engine);
+	  return;
+	}
+
+	std::uint64_t bits[detail::DRAW_CHUNK];
+	for (std::size_t offset = 0; offset < count; offset += detail::DRAW_CHUNK) {
+	  const std::size_t n = std::min(detail::DRAW_CHUNK, count - offset);
+	  engine.fill(bits, n);
+	  for (std::size_t i = 0; i < n; i++) {
+		// smallest k with u < P(X <= k), most draws stop within a few entries of the mean
+		const double u = toUnitInterval(bits[i]);
+		std::size_t k = 0;
+		while (k < cdf_.size() && u >= cdf_[k]) k++;
+		out[offset + i] = static_cast<double>(k);
+	  }
+	}
+  }
+
+ private:
+  std::poisson_distribution<> poisson_{};
+  std::vector<double> cdf_{};
+};
+
+class UniformRealDistribution {
+ public:
+  constexpr static DistributionType TYPE = DistributionType::UNIFORM_REAL;
+
+  UniformRealDistribution(const double &lower, const double &upper) : lower_(lower), width_(upper - lower) {
+  }
+
+  inline void generate(Xoshiro256PlusPlus &engine, double *out, const std::size_t &count) const {
+	std::uint64_t bits[detail::DRAW_CHUNK];
+	for (std::size_t offset = 0; offset < count; offset += detail::DRAW_CHUNK) {
+	  const std::size_t n = std::min(detail::DRAW_CHUNK, count - offset);
+	  engine.fill(bits, n);
+	  for (std::size_t i = 0; i < n; i++) out[offset + i] = lower_ + width_ * toUnitInterval(bits[i]);
+	}
+  }
+
+ private:
+  double lower_{0};
+  double width_{0};
+};
+
+// inclusive bounds as std::uniform_int_distribution
+class UniformIntDistribution {
+ public:
+  constexpr static DistributionType TYPE = DistributionType::UNIFORM_INT;
+
+  UniformIntDistribution(const double &lower, const double &upper);
+
+  inline void generate(Xoshiro256PlusPlus &engine, double *out, const std::size_t &count) const {
+	// top 32 bits scaled to the range by a multiply and shift, with a bias below range / 2^32
+	std::uint64_t bits[detail::DRAW_CHUNK];
+	for (std::size_t offset = 0; offset < count; offset += detail::DRAW_CHUNK) {
+	  const std::size_t n = std::min(detail::DRAW_CHUNK, count - offset);
+	  engine.fill(bits, n);
+	  for (std::size_t i = 0; i < n; i++) {
+		out[offset + i] = static_cast<double>(lower_ + static_cast<std::int64_t>(((bits[i] >> 32) * range_) >> 32));
+	  }
+	}
+  }
+
+ private:
+  std::int64_t lower_{0};
+  std::uint64_t range_{0};
+};
+
+class NormalDistribution {
  public:
-  virtual double getNextValue() = 0;
+  constexpr static DistributionType TYPE = DistributionType::NORMAL;
+
+  NormalDistribution(const double &mean, const double &stddev) : normal_(mean, stddev) {
+  }
+
+  inline void generate(Xoshiro256PlusPlus &engine, double *out, const std::size_t &count) {
+	for (std::size_t i = 0; i < count; i++) out[i] = normal_(engine);
+  }
+
+ private:
+  std::normal_distribution<> normal_;
 };
 
+// Draws of distribution D from its own xoshiro256++ stream. Values are generated BLOCK_SIZE at a time, so
+// getNextValue mostly reads the next buffered value and inlines into the caller.
+// The same seed and parameters always draw the same sequence, whether read by getNextValue, fill or both.
 template<typename D>
-class DistributionGenerator : public IRandomDistributionGenerator {
+class BlockDistributionGenerator {
+ public:
+  using distribution_type = D;
+
+  constexpr static std::size_t BLOCK_SIZE = 8;
+
+  BlockDistributionGenerator(D distribution, const std::uint64_t &seed)
+	  : engine_(seed), distribution_(std::move(distribution)) {
+  }
+
+  BlockDistributionGenerator(const BlockDistributionGenerator &) = default;
+
+  BlockDistributionGenerator &operator=(const BlockDistributionGenerator &) = default;
+
+  BlockDistributionGenerator(BlockDistributionGenerator &&) noexcept = default;
+
+  BlockDistributionGenerator &operator=(BlockDistributionGenerator &&) noexcept = default;
+
+  ~BlockDistributionGenerator() = default;
+
+  inline double getNextValue() {
+	if (position_ == BLOCK_SIZE) [[unlikely]] {
+	  distribution_.generate(engine_, block_.data(), BLOCK_SIZE);
+	  position_ = 0;
+	}
+	return block_[position_++];
+  }
+
+  // next count values of the sequence into out
+  inline void fill(double *out, std::size_t count) {
+	while (count > 0 && position_ < BLOCK_SIZE) {
+	  *out++ = block_[position_++];
+	  count--;
+	}
+	distribution_.generate(engine_, out, count);
+  }
+
+ private:
+  Xoshiro256PlusPlus engine_;
+  D distribution_;
+  std::array<double, BLOCK_SIZE> block_{};
+  std::size_t position_{BLOCK_SIZE};
+};
+
+// Any distribution of the closed set, dispatched at runtime. Models grouped by shape hold the alternative itself.
+class RandomDistributionGenerator {
  public:
-  template<typename... Args>
-  DistributionGenerator(Args &&... args)
-	  : rd(), generator(rd()), distribution(std::forward<Args>(args)...) {
+  using Alternatives = std::variant<BlockDistributionGenerator<PoissonDistribution>,
+									BlockDistributionGenerator<UniformRealDistribution>,
+									BlockDistributionGenerator<UniformIntDistribution>,
+									BlockDistributionGenerator<NormalDistribution>>;
+
+  template<typename D>
+  RandomDistributionGenerator(BlockDistributionGenerator<D> generator) : generator_(std::move(generator)) {
+  }
+
+  RandomDistributionGenerator(const RandomDistributionGenerator &) = default;
+
+  RandomDistributionGenerator &operator=(const RandomDistributionGenerator &) = default;
+
+  RandomDistributionGenerator(RandomDistributionGenerator &&) noexcept = default;
+
+  RandomDistributionGenerator &operator=(RandomDistributionGenerator &&) noexcept = default;
+
+  ~RandomDistributionGenerator() = default;
+
+  inline double getNextValue() {
+	return std::visit([](auto &generator) { return generator.getNextValue(); }, generator_);
+  }
+
+  // next count values of the sequence into out
+  void fill(double *out, const std::size_t &count) {
+	std::visit([out, &count](auto &generator) { generator.fill(out, count); }, generator_);
   }
 
-  double getNextValue() {
-	return distribution(generator);
+  [[nodiscard]] DistributionType getType() const {
+	return static_cast<DistributionType>(generator_.index());
   }
 
- protected:
-  std::random_device rd;
-  std::mt19937 generator;
-  D distribution;
+  // the generator of distribution D, which must be getType()
+  template<typename D>
+  BlockDistributionGenerator<D> release() && {
+	return std::get<BlockDistributionGenerator<D>>(std::move(generator_));
+  }
+
+ private:
+  Alternatives generator_;
 };
 
+template<std::size_t I>
+using DistributionOf = typename std::variant_alternative_t<I, RandomDistributionGenerator::Alternatives>::distribution_type;
+
 struct RandomDistributionGeneratorFactory {
-  static std::unique_ptr<IRandomDistributionGenerator> create(const std::vector<std::string> &params);
+  // seeded from std::random_device
+  static RandomDistributionGenerator create(const std::vector<std::string> &params);
+
+  // the same seed and params always draw the same values
+  static RandomDistributionGenerator create(const std::vector<std::string> &params, const std::uint64_t &seed);
 };
-}
\ No newline at end of file
+}
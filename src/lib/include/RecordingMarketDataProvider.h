@@ -0,0 +1,52 @@
+#pragma once
+
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "IMarketDataProvider.h"
+#include "TickCapture.h"
+
+namespace basket::pricer {
+
+// Captures every tick of another provider into a tick capture file on its way to the subscriber.
+// The capture is completed when the source provider's run() returns, or by close().
+class RecordingMarketDataProvider : public IMarketDataProvider {
+ public:
+  RecordingMarketDataProvider(std::shared_ptr<IMarketDataProvider> source,
+							  const std::string &capture_path,
+							  const TickCaptureConfiguration &configuration = {});
+
+  RecordingMarketDataProvider() = delete;
+
+  RecordingMarketDataProvider(const RecordingMarketDataProvider &) = delete;
+
+  RecordingMarketDataProvider &operator=(const RecordingMarketDataProvider &) = delete;
+
+  RecordingMarketDataProvider(RecordingMarketDataProvider &&) noexcept = delete;
+
+  RecordingMarketDataProvider &operator=(RecordingMarketDataProvider &&) noexcept = delete;
+
+  ~RecordingMarketDataProvider() = default;
+
+  // the batches of the source provider are captured then passed on as they are
+  void subscribeBatch(BatchCallbackFunc &&callback, std::vector<std::string> &&instrumentList) override;
+
+  void run() override;
+
+  // publishing thread only, completes the capture
+  void close();
+
+  [[nodiscard]] std::uint64_t getRecordCount() const {
+	return capture_ ? capture_->getRecordCount() : 0;
+  }
+
+ private:
+  std::shared_ptr<IMarketDataProvider> source_{};
+  std::string capture_path_{};
+  TickCaptureConfiguration configuration_{};
+
+  std::unique_ptr<TickCaptureWriter> capture_{};
+};
+
+}
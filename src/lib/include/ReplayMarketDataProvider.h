@@ -0,0 +1,167 @@
+#pragma once
+
+#include <algorithm>
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "IMarketDataProvider.h"
+#include "StaticTickPipeline.h"
+#include "TickCapture.h"
+#include "TickEvent.h"
+
+#include "base/spin_wait.h"
+
+namespace basket::pricer {
+
+struct ReplayConfiguration {
+  // 0 replays as fast as possible, otherwise one timestamp unit of the capture lasts this many nanoseconds
+  std::uint64_t nanoseconds_per_timestamp_{0};
+};
+
+// Publishes the ticks of a capture file written by TickCaptureWriter.
+// The file is memory mapped and its records are handed to the subscriber in place, with no parsing nor copy,
+// as long as the subscriber interns the instruments the way the capture did. Otherwise each tick is copied to
+// carry the subscriber's instrument id, and ticks of instruments it did not subscribe are skipped.
+class ReplayMarketDataProvider : public IMarketDataProvider {
+ public:
+  explicit ReplayMarketDataProvider(const std::string &capture_path, const ReplayConfiguration &configuration = {});
+
+  ReplayMarketDataProvider() = delete;
+
+  ReplayMarketDataProvider(const ReplayMarketDataProvider &) = delete;
+
+  ReplayMarketDataProvider &operator=(const ReplayMarketDataProvider &) = delete;
+
+  ReplayMarketDataProvider(ReplayMarketDataProvider &&) noexcept = delete;
+
+  ReplayMarketDataProvider &operator=(ReplayMarketDataProvider &&) noexcept = delete;
+
+  ~ReplayMarketDataProvider();
+
+  void subscribeBatch(BatchCallbackFunc &&callback, std::vector<std::string> &&instrumentList) override;
+
+  // Publishes the remaining ticks, returns at the end of the capture. Batches are up to REPLAY_BATCH_SIZE records
+  // long as fast as possible, or the ticks sharing a timestamp when paced.
+  void run() override;
+
+  // run() publishing straight to the subscriber, see StaticTickPipeline.h
+  template<TickBatchSubscriber Subscriber>
+  void runInto(Subscriber &subscriber);
+
+  // the next run() starts with the first tick at or after event_timestamp
+  void seekToTimestamp(const std::uint64_t &event_timestamp);
+
+  // captured instruments, in capture instrument id order
+  [[nodiscard]] const std::vector<std::string> &getInstrumentList() const {
+	return instrument_list_;
+  }
+
+  [[nodiscard]] std::uint64_t getRecordCount() const {
+	return record_count_;
+  }
+
+ private:
+  // records per batch of an unpaced replay
+  constexpr static std::uint64_t REPLAY_BATCH_SIZE = 256;
+
+  template<typename Deliver>
+  void runWith(Deliver &deliver);
+
+  template<bool PACED, bool REMAPPED, typename Deliver>
+  void replay(Deliver &deliver);
+
+  ReplayConfiguration configuration_;
+
+  void *mapping_{nullptr};
+  std::size_t mapping_size_{0};
+
+  const TickEvent *records_{nullptr};
+  std::uint64_t record_count_{0};
+  std::uint64_t next_record_{0};
+
+  const TickCaptureIndexEntry *index_{nullptr};
+  std::uint64_t index_entry_count_{0};
+
+  std::vector<std::string> instrument_list_{};
+
+  // capture instrument id -> subscriber instrument id, -1 when not subscribed, empty when both agree
+  std::vector<InstrumentIdType> instrument_remap_{};
+
+  // the remapped ticks of a batch
+  std::vector<TickEvent> remapped_batch_{};
+};
+
+template<TickBatchSubscriber Subscriber>
+void ReplayMarketDataProvider::runInto(Subscriber &subscriber) {
+  auto deliver = [&subscriber](const std::span<const TickEvent> &ticks, const bool &endOfBatch) {
+	subscriber.onTickBatch(ticks, endOfBatch);
+  };
+  runWith(deliver);
+}
+
+template<typename Deliver>
+void ReplayMarketDataProvider::runWith(Deliver &deliver) {
+  const bool paced = configuration_.nanoseconds_per_timestamp_ > 0;
+  const bool remapped = !instrument_remap_.empty();
+
+  if (paced) {
+	remapped ? replay<true, true>(deliver) : replay<true, false>(deliver);
+  } else {
+	remapped ? replay<false, true>(deliver) : replay<false, false>(deliver);
+  }
+}
+
+template<bool PACED, bool REMAPPED, typename Deliver>
+void ReplayMarketDataProvider::replay(Deliver &deliver) {
+  // a paced replay sleeps until shortly before a tick is due and spins for the rest
+  constexpr static auto SPIN_WINDOW = std::chrono::microseconds(50);
+
+  const auto start_time = std::chrono::steady_clock::now();
+  const auto first_timestamp = (next_record_ < record_count_) ? records_[next_record_].event_timestamp_ : 0;
+
+  while (next_record_ < record_count_) {
+	const TickEvent &first = records_[next_record_];
+
+	// paced, the ticks due together, otherwise a fixed count of records
+	std::uint64_t end_record = std::min(next_record_ + REPLAY_BATCH_SIZE, record_count_);
+	if constexpr (PACED) {
+	  end_record = next_record_ + 1;
+	  while (end_record < record_count_ && records_[end_record].event_timestamp_ == first.event_timestamp_) {
+		end_record++;
+	  }
+
+	  const auto due = start_time + std::chrono::nanoseconds(
+		  (first.event_timestamp_ - first_timestamp) * configuration_.nanoseconds_per_timestamp_);
+	  if (due - std::chrono::steady_clock::now() > SPIN_WINDOW) std::this_thread::sleep_until(due - SPIN_WINDOW);
+	  while (std::chrono::steady_clock::now() < due) cpuRelax();
+	}
+
+	const bool end_of_batch = end_record == record_count_ ||
+		records_[end_record].event_timestamp_ != records_[end_record - 1].event_timestamp_;
+
+	if constexpr (REMAPPED) {
+	  remapped_batch_.clear();
+	  for (auto record = next_record_; record < end_record; record++) {
+		const TickEvent &tickEvent = records_[record];
+		if (static_cast<std::size_t>(tickEvent.instrumentId_) >= instrument_remap_.size()) continue;
+		const auto instrumentId = instrument_remap_[tickEvent.instrumentId_];
+		if (instrumentId < 0) continue;
+
+		remapped_batch_.push_back(tickEvent);
+		remapped_batch_.back().instrumentId_ = instrumentId;
+	  }
+	  next_record_ = end_record;
+	  // the end of a batch whose ticks were all filtered out is still delivered, on its own
+	  if (!remapped_batch_.empty() || end_of_batch) deliver(std::span<const TickEvent>(remapped_batch_), end_of_batch);
+	} else {
+	  const std::span<const TickEvent> batch(records_ + next_record_, end_record - next_record_);
+	  next_record_ = end_record;
+	  deliver(batch, end_of_batch);
+	}
+  }
+}
+
+}
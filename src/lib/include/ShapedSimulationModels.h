@@ -0,0 +1,79 @@
+#pragma once
+
+#include <array>
+#include <cstdint>
+#include <memory>
+#include <vector>
+
+#include "base/types.h"
+
+#include "InstrumentPrice.h"
+#include "InstrumentSimulationModel.h"
+
+namespace basket::pricer {
+// Subscribed instrument models grouped by shape. Each group keeps its models contiguously, specialized to the
+// distributions of its shape, and simulates them in its own instantiation of the price shape loop, so no draw
+// goes through a variant dispatch nor a virtual call - only the group is picked at runtime.
+class ShapedSimulationModels {
+ public:
+  ShapedSimulationModels();
+
+  ShapedSimulationModels(const ShapedSimulationModels &) = delete;
+
+  ShapedSimulationModels &operator=(const ShapedSimulationModels &) = delete;
+
+  ShapedSimulationModels(ShapedSimulationModels &&) noexcept = default;
+
+  ShapedSimulationModels &operator=(ShapedSimulationModels &&) noexcept = default;
+
+  ~ShapedSimulationModels();
+
+  // adds the model of the next instrument id
+  void add(InstrumentSimulationModel &&model);
+
+  void clear();
+
+  // Draws the next price shape and event interval of the instruments, from prices into next_prices and
+  // next_event_intervals, all indexed by instrument id. pending is scratch space of the calling thread.
+  void simulate(const std::vector<InstrumentIdType> &instruments,
+				const InstrumentPrice *prices,
+				InstrumentPrice *next_prices,
+				std::uint64_t *next_event_intervals,
+				std::vector<std::vector<InstrumentIdType>> &pending);
+
+  [[nodiscard]] std::size_t getInstrumentCount() const {
+	return model_group_.size();
+  }
+
+  [[nodiscard]] std::size_t getGroupCount() const {
+	return groups_.size();
+  }
+
+ private:
+  class IModelGroup {
+   public:
+	virtual ~IModelGroup() = default;
+
+	virtual std::uint32_t add(InstrumentSimulationModel &&model) = 0;
+
+	virtual void simulate(const std::vector<InstrumentIdType> &instruments,
+						  const std::uint32_t *model_index,
+						  const InstrumentPrice *prices,
+						  InstrumentPrice *next_prices,
+						  std::uint64_t *next_event_intervals) = 0;
+  };
+
+  template<typename NextEventTime, typename Direction, typename TickMove>
+  class ModelGroup;
+
+  template<std::size_t Shape>
+  static std::unique_ptr<IModelGroup> makeGroup();
+
+  std::array<int, MODEL_SHAPE_COUNT> group_of_shape_{};
+  std::vector<std::unique_ptr<IModelGroup>> groups_{};
+
+  // by instrument id, the group of its model and its index there
+  std::vector<std::uint32_t> model_group_{};
+  std::vector<std::uint32_t> model_index_{};
+};
+}
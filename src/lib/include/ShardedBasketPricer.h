@@ -0,0 +1,132 @@
+#pragma once
+
+#include <functional>
+#include <memory>
+#include <ostream>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "base/types.h"
+#include "Basket.h"
+#include "BasketPricer.h"
+#include "IMarketDataProvider.h"
+#include "QueuedMarketDataProvider.h"
+
+namespace basket::pricer {
+
+struct ShardedBasketPricerConfiguration {
+  // 0 runs one shard per hardware thread, never more shards than baskets
+  int shard_count_{0};
+
+  // ticks in flight between the market data thread and each shard, rounded up to a power of 2
+  std::size_t tick_queue_capacity_{1 << 16};
+  ConsumerWaitPolicy tick_queue_wait_policy_{ConsumerWaitPolicy::PARK};
+
+  // shard i runs on cpu (first_cpu_ + i) modulo the hardware threads
+  bool pin_shard_threads_{true};
+  int first_cpu_{0};
+
+  // applied to the pricer of every shard, but for its threshold event sink
+  BasketPricerConfiguration shard_pricer_configuration_{};
+
+  // called once per shard for the threshold event sink of its pricer, when not set the shards share one text sink
+  // on standard output
+  std::function<std::shared_ptr<IThresholdEventSink>(const int &shard)> threshold_event_sink_factory_{};
+};
+
+// Prices the baskets on several worker threads.
+// Baskets are partitioned across shards, each shard owns a BasketPricer over its own baskets - instrument prices,
+// basket state and threshold event queue included - and prices them on its own, optionally pinned, thread.
+// The market data thread only forwards each tick to the shards holding the instrument, every shard sees its ticks
+// in market data order, hence the threshold events of a shard come out in the order an unsharded pricer emits them.
+class ShardedBasketPricer {
+ public:
+
+  ShardedBasketPricer(const BasketsComposition &basketComposition,
+					  std::shared_ptr<IMarketDataProvider> marketDataProvider,
+					  const ShardedBasketPricerConfiguration &configuration = {});
+
+  ShardedBasketPricer() = delete;
+
+  ShardedBasketPricer(const ShardedBasketPricer &) = delete;
+
+  // shard threads refer to the shards, the pricer stays where it was built
+  ShardedBasketPricer(ShardedBasketPricer &&) noexcept = delete;
+
+  ShardedBasketPricer &operator=(const ShardedBasketPricer &) = delete;
+
+  ShardedBasketPricer &operator=(ShardedBasketPricer &&) noexcept = delete;
+
+  // stops the shard threads, see stop()
+  ~ShardedBasketPricer();
+
+  // subscribes every shard and starts the shard threads
+  void initMarketDataSubscription();
+
+  // Once no more ticks are delivered, lets the shards price the ticks still queued, joins their threads and stops
+  // their pricers, which flush the threshold events. Idempotent.
+  void stop();
+
+  // Market data thread, returns once every tick received so far has been priced by the shards
+  void waitUntilPriced() const;
+
+  [[nodiscard]] int getShardCount() const {
+	return static_cast<int>(shards_.size());
+  }
+
+  // basket ids of the composition priced by the shard, in shard basket id order
+  [[nodiscard]] const std::vector<int> &getShardBasketIds(const int &shard) const {
+	return shards_[shard]->basket_ids_;
+  }
+
+  // Any thread, lock free, by basket id of the composition priced, see BasketPricer::getBasketSnapshot. Requires
+  // shard_pricer_configuration_.publish_basket_snapshots_.
+  [[nodiscard]] BasketPriceSnapshot getBasketSnapshot(const int &basket_id) const;
+
+  // any thread, lock free, every basket in basket id order
+  [[nodiscard]] std::vector<BasketPriceSnapshot> getAllSnapshots() const;
+
+  [[nodiscard]] std::uint64_t getDroppedThresholdEventCount() const;
+
+  // summed over the shards, each conflating the ticks it receives
+  [[nodiscard]] ConflationCounters getConflationCounters() const;
+
+  // onTickUpdate latency percentiles so far over all shards, callable from any thread
+  void dumpTickLatency(std::ostream &os) const;
+
+ private:
+
+  struct Shard {
+	std::vector<int> basket_ids_{};
+	std::shared_ptr<QueuedMarketDataProvider> tick_queue_{};
+	std::unique_ptr<BasketPricer> pricer_{};
+	std::thread thread_{};
+  };
+
+  // longest processing time first: heaviest basket to the least loaded shard, load counted in constituents
+  [[nodiscard]] static std::vector<std::vector<int>> partitionBaskets(const BasketsComposition &basketComposition,
+																	  const int &shard_count);
+
+  void buildInstrumentShardIndex(const BasketsComposition &basketComposition);
+
+  ShardedBasketPricerConfiguration configuration_;
+
+  std::shared_ptr<IMarketDataProvider> marketDataProvider_{};
+  std::vector<std::string> instrument_list_{};
+
+  std::vector<std::unique_ptr<Shard>> shards_{};
+
+  // instrument -> shards holding it, entries of instrument i are
+  // [instrument_shard_offsets_[i], instrument_shard_offsets_[i + 1])
+  std::vector<std::size_t> instrument_shard_offsets_{0};
+  std::vector<int> instrument_shards_{};
+
+  // market data thread only, ticks of the batch being received by shard
+  std::vector<std::vector<TickEvent>> shard_batches_{};
+
+  // basket id -> shard pricing it and basket id within the shard
+  std::vector<std::pair<int, int>> basket_locations_{};
+};
+
+}
@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "IMarketDataProvider.h"
+#include "LatencyHistogram.h"
+#include "SharedMemoryTickRing.h"
+#include "TickEvent.h"
+
+namespace basket::pricer {
+
+// How the reader waits for the writer process - std::atomic::wait only wakes threads of its own process
+enum class FeedWaitPolicy : std::uint8_t {
+  BUSY_POLL,    // spin on the ring, lowest latency, burns a core
+  ADAPTIVE_SPIN // spin, then yield, then sleep in short steps until a tick arrives
+};
+
+struct SharedMemoryFeedConfiguration {
+  FeedWaitPolicy wait_policy_{FeedWaitPolicy::ADAPTIVE_SPIN};
+  // true reads the ticks still in the ring when attaching, otherwise only those written afterwards
+  bool from_oldest_{false};
+};
+
+// Publishes the ticks another process writes into a SharedMemoryTickWriter ring.
+// Each provider attaches as one of the ring's readers. Ticks are copied out of the ring, a slot the writer laps
+// mid-copy is detected by its sequence number and skipped along with the rest of what was overwritten, counted as
+// a gap. Ticks of instruments the subscriber did not subscribe are skipped, the others carry its instrument id.
+class SharedMemoryMarketDataProvider : public IMarketDataProvider {
+ public:
+  explicit SharedMemoryMarketDataProvider(const std::string &name, const SharedMemoryFeedConfiguration &configuration = {});
+
+  SharedMemoryMarketDataProvider() = delete;
+
+  SharedMemoryMarketDataProvider(const SharedMemoryMarketDataProvider &) = delete;
+
+  SharedMemoryMarketDataProvider &operator=(const SharedMemoryMarketDataProvider &) = delete;
+
+  SharedMemoryMarketDataProvider(SharedMemoryMarketDataProvider &&) noexcept = delete;
+
+  SharedMemoryMarketDataProvider &operator=(SharedMemoryMarketDataProvider &&) noexcept = delete;
+
+  // detaches from the ring
+  ~SharedMemoryMarketDataProvider();
+
+  void subscribeBatch(BatchCallbackFunc &&callback, std::vector<std::string> &&instrumentList) override;
+
+  // Publishes ticks as they are written, returns once the writer closed the ring and every tick was read,
+  // or once stop() was called
+  void run() override;
+
+  // Publishes the ticks readable right now, up to FEED_BATCH_SIZE, and returns how many were read
+  std::size_t poll();
+
+  // makes run() return, from any thread
+  void stop() {
+	stopped_.store(true, std::memory_order_release);
+  }
+
+  // instruments of the ring, in writer instrument id order
+  [[nodiscard]] const std::vector<std::string> &getInstrumentList() const {
+	return instrument_list_;
+  }
+
+  [[nodiscard]] std::uint64_t getReadCount() const {
+	return read_count_.load(std::memory_order_relaxed);
+  }
+
+  // ticks overwritten by the writer before this reader could read them
+  [[nodiscard]] std::uint64_t getGapCount() const {
+	return gap_count_.load(std::memory_order_relaxed);
+  }
+
+  // nanoseconds from the writer writing a tick to the subscriber returning from the batch delivering it
+  [[nodiscard]] const LatencyHistogram &getTickToPriceLatency() const {
+	return tick_to_price_latency_;
+  }
+
+ private:
+  constexpr static std::size_t FEED_BATCH_SIZE = 256;
+
+  // copies the tick at position_ out of the ring, false when it is not written yet; skips overwritten ticks
+  bool tryRead(TickEvent &tickEvent, std::uint64_t &written_at, std::uint32_t &flags);
+
+  SharedMemoryFeedConfiguration configuration_;
+  std::string name_;
+
+  void *mapping_{nullptr};
+  std::size_t mapping_size_{0};
+
+  SharedMemoryTickRingHeader *header_{nullptr};
+  const SharedMemoryTickSlot *slots_{nullptr};
+  std::uint64_t mask_{0};
+
+  SharedMemoryTickReaderCursor *cursor_{nullptr};
+  std::uint64_t position_{0};
+
+  std::vector<std::string> instrument_list_{};
+
+  // writer instrument id -> subscriber instrument id, -1 when not subscribed, empty when both agree
+  std::vector<InstrumentIdType> instrument_remap_{};
+
+  std::vector<TickEvent> batch_{};
+  std::vector<std::uint64_t> written_at_{};
+
+  std::atomic<bool> stopped_{false};
+  std::atomic<std::uint64_t> read_count_{0};
+  std::atomic<std::uint64_t> gap_count_{0};
+  LatencyHistogram tick_to_price_latency_{};
+};
+
+}
@@ -0,0 +1,174 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <chrono>
+#include <cstdint>
+#include <span>
+#include <string>
+#include <type_traits>
+#include <vector>
+
+#include "base/types.h"
+#include "SpscRingBuffer.h"
+#include "TickEvent.h"
+
+namespace basket::pricer {
+
+// steady_clock nanoseconds, unlike the time stamp counter of LatencyClock comparable between processes as is
+inline std::uint64_t ringClockNow() {
+  return std::chrono::duration_cast<std::chrono::nanoseconds>(
+	  std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+// POSIX shared memory tick ring layout, native byte order, written by one process and read by up to MAX_READERS:
+//   SharedMemoryTickRingHeader
+//   symbol table - per instrument id a std::uint32_t length followed by the symbol, no terminator
+//   padding up to slot_offset_, a multiple of CACHE_LINE_SIZE
+//   capacity_ SharedMemoryTickSlot, tick n in slot n % capacity_
+// The atomics are lock free, hence address free, and work across the processes mapping the ring.
+struct SharedMemoryTickSlot {
+  constexpr static std::uint32_t END_OF_BATCH = 1;
+  // no tick, the slot carries the END_OF_BATCH of a batch whose ticks were all dropped or which had none
+  constexpr static std::uint32_t NO_TICK = 2;
+
+  // 2 * n + 1 while tick n is written, 2 * n + 2 once it can be read
+  std::atomic<std::uint64_t> sequence_{0};
+  // ringClockNow() when the tick was written
+  std::uint64_t written_at_{0};
+  TickEvent tick_event_{};
+  // END_OF_BATCH on the last tick of a batch ending its timestamp, see IMarketDataProvider::BatchCallbackFunc
+  std::uint32_t flags_{0};
+};
+
+// a reader process's place in the ring
+struct SharedMemoryTickReaderCursor {
+  constexpr static std::uint32_t FREE = 0;
+  constexpr static std::uint32_t ATTACHING = 1;
+  constexpr static std::uint32_t ATTACHED = 2;
+
+  // claimed with a compare exchange from FREE, ATTACHED once position_ is set
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint32_t> state_{FREE};
+  // next tick the reader reads, every tick before it was read or skipped
+  std::atomic<std::uint64_t> position_{0};
+};
+
+struct SharedMemoryTickRingHeader {
+  constexpr static char MAGIC[8] = {'B', 'K', 'S', 'H', 'M', 'R', '0', '1'};
+  constexpr static std::uint64_t MAGIC_WORD = std::bit_cast<std::uint64_t>(MAGIC);
+  constexpr static std::uint32_t VERSION = 2;
+  constexpr static int MAX_READERS = 8;
+
+  // MAGIC_WORD, written last, a reader finding it knows the rest of the header and the symbol table are set
+  std::atomic<std::uint64_t> magic_{0};
+  std::uint32_t version_{VERSION};
+  std::uint32_t slot_size_{sizeof(SharedMemoryTickSlot)};
+  // prices count units of 1 / price_scale_, only read by a build of the same scale
+  std::int64_t price_scale_{PRICE_SCALE};
+  std::uint64_t capacity_{0};
+  std::uint64_t symbol_count_{0};
+  std::uint64_t slot_offset_{0};
+
+  // next tick written
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head_{0};
+  // set once the writer is done, after its last tick
+  std::atomic<std::uint32_t> closed_{0};
+
+  SharedMemoryTickReaderCursor readers_[MAX_READERS]{};
+};
+
+static_assert(std::atomic<std::uint64_t>::is_always_lock_free && std::atomic<std::uint32_t>::is_always_lock_free,
+			  "the ring synchronizes processes through its atomics, which must not hide a lock");
+static_assert(std::is_trivially_copyable_v<TickEvent>, "ticks are copied in and out of the ring verbatim");
+
+struct SharedMemoryTickRingConfiguration {
+  // slots, rounded up to a power of 2
+  std::size_t capacity_{1 << 16};
+
+  // What the writer does when the slowest attached reader is a ring behind: DROP_OLDEST overwrites, the reader
+  // skips to the oldest tick left and counts the gap; DROP_NEWEST discards the tick written; SPIN waits, which a
+  // reader dying without detaching would make last forever.
+  OverflowPolicy overflow_policy_{OverflowPolicy::DROP_OLDEST};
+};
+
+// Creates the shared memory ring /name, replacing a stale one, and writes ticks into it.
+// The ring is unlinked on destruction, readers still mapping it keep reading what was written.
+class SharedMemoryTickWriter {
+ public:
+  SharedMemoryTickWriter(const std::string &name,
+						 const std::vector<std::string> &instrumentList,
+						 const SharedMemoryTickRingConfiguration &configuration = {});
+
+  SharedMemoryTickWriter() = delete;
+
+  SharedMemoryTickWriter(const SharedMemoryTickWriter &) = delete;
+
+  SharedMemoryTickWriter &operator=(const SharedMemoryTickWriter &) = delete;
+
+  SharedMemoryTickWriter(SharedMemoryTickWriter &&) noexcept = delete;
+
+  SharedMemoryTickWriter &operator=(SharedMemoryTickWriter &&) noexcept = delete;
+
+  // closes the ring and unlinks it
+  ~SharedMemoryTickWriter();
+
+  // Writes the ticks, stamped with the current time, and flags the last one written as ending its timestamp when
+  // endOfBatch. Returns how many were written, less than the span only under DROP_NEWEST. The end of a batch none
+  // of whose ticks were written takes a slot of its own, once DROP_NEWEST leaves room for it.
+  std::size_t write(const std::span<const TickEvent> &ticks, const bool &endOfBatch);
+
+  // tells the readers no more ticks come, idempotent
+  void close();
+
+  [[nodiscard]] int getAttachedReaderCount() const;
+
+  // ticks written so far
+  [[nodiscard]] std::uint64_t getWriteCount() const {
+	return head_ - end_of_batch_slots_;
+  }
+
+  // ticks discarded under DROP_NEWEST
+  [[nodiscard]] std::uint64_t getDroppedCount() const {
+	return dropped_;
+  }
+
+  // writes which found the slowest reader a ring behind
+  [[nodiscard]] std::uint64_t getFullCount() const {
+	return full_;
+  }
+
+ private:
+  constexpr static int SPINS_BEFORE_YIELDING = 256;
+
+  // position of the slowest attached reader, head_ when none is attached
+  [[nodiscard]] std::uint64_t getSlowestReaderPosition() const;
+
+  // under SPIN, until the slowest reader is less than a ring behind head
+  void waitForSlowestReader(const std::uint64_t &head);
+
+  // writes a NO_TICK slot ending the batch, false when DROP_NEWEST leaves no room for it
+  bool tryWriteEndOfBatch(const std::uint64_t &written_at);
+
+  std::string name_;
+  OverflowPolicy overflow_policy_;
+
+  void *mapping_{nullptr};
+  std::size_t mapping_size_{0};
+
+  SharedMemoryTickRingHeader *header_{nullptr};
+  SharedMemoryTickSlot *slots_{nullptr};
+  std::uint64_t mask_{0};
+
+  // writer copies of the header head_ and of the slowest reader position last seen
+  std::uint64_t head_{0};
+  std::uint64_t slowest_reader_{0};
+
+  std::uint64_t dropped_{0};
+  std::uint64_t full_{0};
+
+  // NO_TICK slots written, and whether one is due once there is room for it
+  std::uint64_t end_of_batch_slots_{0};
+  bool end_of_batch_pending_{false};
+};
+
+}
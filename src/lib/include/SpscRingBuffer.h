@@ -0,0 +1,270 @@
+#pragma once
+
+#include <atomic>
+#include <bit>
+#include <cstdint>
+#include <memory>
+#include <span>
+#include <thread>
+#include <type_traits>
+#include <vector>
+
+#include "base/seqlock_ring.h"
+#include "base/spin_wait.h"
+#include "base/types.h"
+
+namespace basket::pricer {
+
+// What the producer does when the consumer is a full ring behind
+enum class OverflowPolicy : std::uint8_t {
+  DROP_OLDEST, // overwrite the oldest unread element, never waits
+  DROP_NEWEST, // discard the element being pushed, never waits
+  SPIN         // count the event and spin until the consumer frees a slot, lossless
+};
+
+// How the consumer waits for the producer
+enum class ConsumerWaitPolicy : std::uint8_t {
+  BUSY_POLL, // spin on the ring, lowest latency, burns a core
+  PARK       // spin briefly, then sleep until the producer publishes
+};
+
+// Bounded single producer / single consumer ring.
+// The producer never takes a lock nor makes a system call - except waking a parked consumer, and only while it is
+// parked. Each slot carries a sequence number so the consumer can detect slots overwritten under DROP_OLDEST.
+template<typename T>
+class SpscRingBuffer {
+  static_assert(std::is_trivially_copyable_v<T>, "elements are copied without synchronisation, see tryPop");
+
+ public:
+  explicit SpscRingBuffer(const std::size_t &capacity,
+						  const OverflowPolicy &overflowPolicy = OverflowPolicy::SPIN,
+						  const ConsumerWaitPolicy &waitPolicy = ConsumerWaitPolicy::PARK)
+	  : capacity_(std::bit_ceil(capacity < 2 ? 2 : capacity)), mask_(capacity_ - 1),
+		overflow_policy_(overflowPolicy), wait_policy_(waitPolicy),
+		slots_(std::make_unique<Slot[]>(capacity_)) {
+  }
+
+  SpscRingBuffer(const SpscRingBuffer &) = delete;
+
+  SpscRingBuffer &operator=(const SpscRingBuffer &) = delete;
+
+  ~SpscRingBuffer() = default;
+
+  // Producer side, returns false when the element was dropped
+  bool push(const T &value) {
+	if (!write(value)) return false;
+	publish();
+	return true;
+  }
+
+  // Producer side, pushes the values in order and publishes them at once, so under PARK the check for a parked
+  // consumer is paid once per call rather than per value. Returns how many were pushed, short of those dropped.
+  std::size_t pushBatch(const std::span<const T> &values) {
+	std::size_t pushed{0};
+	for (const auto &value : values) pushed += write(value);
+	publish();
+	return pushed;
+  }
+
+  // Producer side, wakes a consumer parked in waitForData so it checks its stop condition, see waitForData
+  void notify() {
+	if (wait_policy_ == ConsumerWaitPolicy::PARK) wakeParkedConsumer();
+  }
+
+  // Consumer side, returns false when there is nothing to read
+  bool tryPop(T &value) {
+	// an element overwritten under DROP_OLDEST is skipped, up to the oldest one still in the ring
+	const std::uint64_t tail = consumer_.next_;
+	const bool popped = tryReadSeqlockSlot(
+		consumer_.next_, consumer_.overwritten_, capacity_,
+		[this](const std::uint64_t &position) -> const Slot & { return slots_[position & mask_]; },
+		[&value](const Slot &slot) { value = slot.value_; },
+		[this] { return head_.load(std::memory_order_acquire); });
+	if (consumer_.next_ != tail) consumer_.tail_.store(consumer_.next_, std::memory_order_release);
+	return popped;
+  }
+
+  // Consumer side, appends up to max_count elements to out and returns how many were read
+  std::size_t popBatch(std::vector<T> &out, const std::size_t &max_count) {
+	std::size_t count{0};
+	T value;
+	while (count < max_count && tryPop(value)) {
+	  out.push_back(value);
+	  count++;
+	}
+	return count;
+  }
+
+  // Consumer side, returns once the ring is not empty, close() was called or stop() returns true. A producer making
+  // stop() true without pushing calls notify() after, in case the consumer parked.
+  template<typename Stop>
+  void waitForData(Stop &&stop) {
+	constexpr static int SPINS_BEFORE_PARKING = 1024;
+
+	for (int spins = 0; isEmpty(); spins++) {
+	  if (closed_.load(std::memory_order_acquire) || stop()) return;
+
+	  if (wait_policy_ == ConsumerWaitPolicy::BUSY_POLL || spins < SPINS_BEFORE_PARKING) {
+		cpuRelax();
+		continue;
+	  }
+
+	  const std::uint64_t head = consumer_.next_;
+	  const std::uint32_t wake_ups = parking_.wake_ups_.load(std::memory_order_acquire);
+	  parking_.parked_.store(true, std::memory_order_relaxed);
+	  std::atomic_thread_fence(std::memory_order_seq_cst);
+	  if (head_.load(std::memory_order_relaxed) == head && !closed_.load(std::memory_order_acquire) && !stop()) {
+		parking_.wake_ups_.wait(wake_ups, std::memory_order_acquire);
+	  }
+	  parking_.parked_.store(false, std::memory_order_relaxed);
+	}
+  }
+
+  void waitForData() {
+	waitForData([] { return false; });
+  }
+
+  // Releases a consumer blocked in waitForData for good
+  void close() {
+	closed_.store(true, std::memory_order_release);
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	parking_.wake_ups_.fetch_add(1, std::memory_order_release);
+	parking_.wake_ups_.notify_all();
+  }
+
+  [[nodiscard]] bool isClosed() const {
+	return closed_.load(std::memory_order_acquire);
+  }
+
+  [[nodiscard]] bool isEmpty() const {
+	return head_.load(std::memory_order_acquire) <= consumer_.next_;
+  }
+
+  // Producer side, position the next element is pushed at, elements dropped under DROP_NEWEST take none
+  [[nodiscard]] std::uint64_t getWritePosition() const {
+	return producer_.head_;
+  }
+
+  // Consumer side, position the next element is read at, every element before it was popped or overwritten
+  [[nodiscard]] std::uint64_t getReadPosition() const {
+	return consumer_.next_;
+  }
+
+  // Consumer side, elements pushed and not popped yet, overwritten ones included
+  [[nodiscard]] std::uint64_t getDepth() const {
+	// the consumer may skip past a head a DROP_OLDEST batch has not published yet
+	const std::uint64_t head = head_.load(std::memory_order_acquire);
+	return head > consumer_.next_ ? head - consumer_.next_ : 0;
+  }
+
+  [[nodiscard]] std::size_t getCapacity() const {
+	return capacity_;
+  }
+
+  // elements lost to DROP_NEWEST or DROP_OLDEST so far
+  [[nodiscard]] std::uint64_t getDroppedCount() const {
+	return producer_.dropped_.load(std::memory_order_relaxed) + consumer_.overwritten_.load(std::memory_order_relaxed);
+  }
+
+  // pushes which found the ring full and had to spin under SPIN
+  [[nodiscard]] std::uint64_t getFullCount() const {
+	return producer_.full_.load(std::memory_order_relaxed);
+  }
+
+ private:
+  constexpr static int SPINS_BEFORE_YIELDING = 256;
+
+  // copies the value into the next slot without making it visible to the consumer, false when dropped
+  bool write(const T &value) {
+	const std::uint64_t head = producer_.head_;
+
+	if (overflow_policy_ != OverflowPolicy::DROP_OLDEST && head - producer_.cached_tail_ >= capacity_) [[unlikely]] {
+	  producer_.cached_tail_ = consumer_.tail_.load(std::memory_order_acquire);
+
+	  if (head - producer_.cached_tail_ >= capacity_) {
+		if (overflow_policy_ == OverflowPolicy::DROP_NEWEST) {
+		  producer_.dropped_.store(producer_.dropped_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		  return false;
+		}
+
+		// the consumer has to see what was written so far to free a slot
+		publish();
+		producer_.full_.store(producer_.full_.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+		for (int spins = 0; head - producer_.cached_tail_ >= capacity_; spins++) {
+		  // let a consumer sharing this core make progress
+		  (spins < SPINS_BEFORE_YIELDING) ? cpuRelax() : std::this_thread::yield();
+		  producer_.cached_tail_ = consumer_.tail_.load(std::memory_order_acquire);
+		}
+	  }
+	}
+
+	Slot &slot = slots_[head & mask_];
+	// odd sequence while the slot is being written, tryPop discards what it read meanwhile
+	slot.sequence_.store(2 * head + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.value_ = value;
+	slot.sequence_.store(2 * head + 2, std::memory_order_release);
+
+	producer_.head_ = head + 1;
+	return true;
+  }
+
+  // makes the values written so far visible to the consumer
+  void publish() {
+	head_.store(producer_.head_, std::memory_order_release);
+	if (wait_policy_ == ConsumerWaitPolicy::PARK) wakeParkedConsumer();
+  }
+
+  void wakeParkedConsumer() {
+	// pairs with the fence in waitForData, either we see the consumer parked or it sees what we published
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (parking_.parked_.load(std::memory_order_relaxed) &&
+		parking_.parked_.exchange(false, std::memory_order_relaxed)) [[unlikely]] {
+	  // only the first publication after the consumer parked pays for the wake up
+	  parking_.wake_ups_.fetch_add(1, std::memory_order_release);
+	  parking_.wake_ups_.notify_one();
+	}
+  }
+
+  struct Slot {
+	std::atomic<std::uint64_t> sequence_{0};
+	T value_{};
+  };
+
+  struct alignas(CACHE_LINE_SIZE) ProducerState {
+	std::uint64_t head_{0};
+	std::uint64_t cached_tail_{0};
+	std::atomic<std::uint64_t> dropped_{0};
+	std::atomic<std::uint64_t> full_{0};
+  };
+
+  struct alignas(CACHE_LINE_SIZE) ConsumerState {
+	std::uint64_t next_{0};
+	std::atomic<std::uint64_t> tail_{0};
+	std::atomic<std::uint64_t> overwritten_{0};
+  };
+
+  // read by the producer on every push under PARK, hence kept away from the consumer's tail updates
+  struct alignas(CACHE_LINE_SIZE) ParkingState {
+	std::atomic<bool> parked_{false};
+	// what a parked consumer sleeps on, bumped to wake it - a 32 bit word is waited on as a futex directly, and
+	// unlike head_ it also changes on close()
+	std::atomic<std::uint32_t> wake_ups_{0};
+  };
+
+  const std::size_t capacity_;
+  const std::size_t mask_;
+  const OverflowPolicy overflow_policy_;
+  const ConsumerWaitPolicy wait_policy_;
+
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> head_{0};
+  std::atomic<bool> closed_{false};
+
+  ProducerState producer_{};
+  ConsumerState consumer_{};
+  ParkingState parking_{};
+
+  alignas(CACHE_LINE_SIZE) std::unique_ptr<Slot[]> slots_;
+};
+
+}
@@ -0,0 +1,41 @@
+#pragma once
+
+#include <concepts>
+#include <span>
+
+#include "IMarketDataProvider.h"
+#include "TickEvent.h"
+
+namespace basket::pricer {
+
+// Takes ticks straight from a provider bound to it at compile time, with the semantics of
+// IMarketDataProvider::BatchCallbackFunc
+template<typename Subscriber>
+concept TickBatchSubscriber = requires(Subscriber &subscriber,
+									   const std::span<const TickEvent> &ticks,
+									   const bool &endOfBatch) {
+  subscriber.onTickBatch(ticks, endOfBatch);
+};
+
+// A provider which, besides run() through the subscribed callback, publishes to a subscriber of a type known at
+// compile time with runInto(subscriber): no std::function nor virtual call stands between the provider's loop and
+// the subscriber's, so the compiler can inline the pricing into the publication loop. The subscription is still
+// made through subscribeBatch, which interns the instruments; only the callback goes unused.
+template<typename Provider, typename Subscriber>
+concept StaticMarketDataProvider = std::derived_from<Provider, IMarketDataProvider> &&
+	TickBatchSubscriber<Subscriber> &&
+	requires(Provider &provider, Subscriber &subscriber) {
+	  provider.runInto(subscriber);
+	};
+
+// Publishes the provider's ticks to the subscriber, statically bound when the types allow, through run() otherwise
+template<typename Provider, typename Subscriber>
+void runTickPipeline(Provider &provider, Subscriber &subscriber) {
+  if constexpr (StaticMarketDataProvider<Provider, Subscriber>) {
+	provider.runInto(subscriber);
+  } else {
+	provider.run();
+  }
+}
+
+}
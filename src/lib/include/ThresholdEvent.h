@@ -0,0 +1,22 @@
+#pragma once
+
+#include <string_view>
+#include <type_traits>
+
+#include "base/types.h"
+#include "TickEvent.h"
+
+namespace basket::pricer {
+
+struct ThresholdEvent {
+  int basket_id_;
+  TickEventType event_type_;
+  WeightedPriceType prev_price_;
+  WeightedPriceType new_price_;
+  double delta_pct_;
+  // views the composition the event was priced with, which the pricer keeps until the event is printed
+  std::string_view basket_name_;
+};
+
+static_assert(std::is_trivially_copyable_v<ThresholdEvent>, "ThresholdEvent travels through an SpscRingBuffer");
+}
@@ -0,0 +1,124 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <mutex>
+#include <span>
+#include <string>
+#include <type_traits>
+
+#include "base/buffered_file_writer.h"
+#include "base/types.h"
+#include "IThresholdEventSink.h"
+#include "ThresholdEvent.h"
+
+namespace basket::pricer {
+
+// One line per event, e.g. "B01 PrevLastPrice 68.5802 NewLastPrice 68.8602 DeltaPct 0.408281", numbers formatted
+// with std::to_chars to the 6 significant digits of the former std::ostream output.
+class TextThresholdEventSink : public IThresholdEventSink {
+ public:
+  // standard output
+  TextThresholdEventSink();
+
+  explicit TextThresholdEventSink(const std::string &path);
+
+  TextThresholdEventSink(const TextThresholdEventSink &) = delete;
+
+  TextThresholdEventSink &operator=(const TextThresholdEventSink &) = delete;
+
+  TextThresholdEventSink(TextThresholdEventSink &&) noexcept = delete;
+
+  TextThresholdEventSink &operator=(TextThresholdEventSink &&) noexcept = delete;
+
+  ~TextThresholdEventSink() override = default;
+
+  void write(const std::span<const ThresholdEvent> &events) override;
+
+  void flush() override;
+
+ private:
+  BufferedFileWriter writer_;
+};
+
+// Binary threshold event log layout, native byte order:
+//   ThresholdEventLogHeader
+//   ThresholdEventRecord per event, in emission order
+// Basket ids are those of the composition being priced, the delta percentage is left to the reader.
+struct ThresholdEventLogHeader {
+  constexpr static char MAGIC[8] = {'B', 'K', 'T', 'H', 'R', 'S', '0', '1'};
+  constexpr static std::uint32_t VERSION = 1;
+
+  char magic_[8]{};
+  std::uint32_t version_{VERSION};
+  std::uint32_t record_size_{0};
+  // prices count units of 1 / (price_scale_ * weight_scale_)
+  std::int64_t price_scale_{PRICE_SCALE};
+  std::int64_t weight_scale_{WEIGHT_SCALE};
+};
+
+struct ThresholdEventRecord {
+  WeightedPriceType prev_price_{0};
+  WeightedPriceType new_price_{0};
+  std::int32_t basket_id_{0};
+  TickEventType event_type_{TickEventType::INVALID};
+};
+
+static_assert(std::is_trivially_copyable_v<ThresholdEventLogHeader> && sizeof(ThresholdEventRecord) == 24,
+			  "the header and the records are written verbatim");
+
+class BinaryThresholdEventSink : public IThresholdEventSink {
+ public:
+  explicit BinaryThresholdEventSink(const std::string &path);
+
+  BinaryThresholdEventSink(const BinaryThresholdEventSink &) = delete;
+
+  BinaryThresholdEventSink &operator=(const BinaryThresholdEventSink &) = delete;
+
+  BinaryThresholdEventSink(BinaryThresholdEventSink &&) noexcept = delete;
+
+  BinaryThresholdEventSink &operator=(BinaryThresholdEventSink &&) noexcept = delete;
+
+  ~BinaryThresholdEventSink() override = default;
+
+  void write(const std::span<const ThresholdEvent> &events) override;
+
+  void flush() override;
+
+ private:
+  BufferedFileWriter writer_;
+};
+
+// Serializes the writes of several pricers into one sink, e.g. the shards of a ShardedBasketPricer printing to the
+// same standard output, whose buffers would otherwise interleave mid line.
+class SynchronizedThresholdEventSink : public IThresholdEventSink {
+ public:
+  explicit SynchronizedThresholdEventSink(std::shared_ptr<IThresholdEventSink> sink) : sink_(std::move(sink)) {
+  }
+
+  SynchronizedThresholdEventSink(const SynchronizedThresholdEventSink &) = delete;
+
+  SynchronizedThresholdEventSink &operator=(const SynchronizedThresholdEventSink &) = delete;
+
+  SynchronizedThresholdEventSink(SynchronizedThresholdEventSink &&) noexcept = delete;
+
+  SynchronizedThresholdEventSink &operator=(SynchronizedThresholdEventSink &&) noexcept = delete;
+
+  ~SynchronizedThresholdEventSink() override = default;
+
+  void write(const std::span<const ThresholdEvent> &events) override {
+	std::lock_guard lock(mutex_);
+	sink_->write(events);
+  }
+
+  void flush() override {
+	std::lock_guard lock(mutex_);
+	sink_->flush();
+  }
+
+ private:
+  std::mutex mutex_;
+  std::shared_ptr<IThresholdEventSink> sink_;
+};
+
+}
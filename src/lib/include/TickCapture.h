@@ -0,0 +1,114 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <fstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "base/types.h"
+#include "SpscRingBuffer.h"
+#include "TickEvent.h"
+
+namespace basket::pricer {
+
+// Binary tick capture layout, native byte order:
+//   TickCaptureHeader
+//   symbol table - per instrument id a std::uint32_t length followed by the symbol, no terminator
+//   padding up to record_offset_, a multiple of TICK_CAPTURE_ALIGNMENT
+//   record_count_ TickEvent records, verbatim
+//   index_entry_count_ TickCaptureIndexEntry, one every index_stride_ records
+struct TickCaptureHeader {
+  constexpr static char MAGIC[8] = {'B', 'K', 'T', 'I', 'C', 'K', '0', '1'};
+  constexpr static std::uint32_t VERSION = 1;
+
+  char magic_[8]{};
+  std::uint32_t version_{VERSION};
+  std::uint32_t tick_event_size_{sizeof(TickEvent)};
+  // captured prices count units of 1 / price_scale_, a capture only replays into a build of the same scale
+  std::int64_t price_scale_{PRICE_SCALE};
+  std::uint64_t symbol_count_{0};
+  std::uint64_t record_offset_{0};
+  // 0 while the capture is being written, a reader then takes every complete record up to the end of file
+  std::uint64_t record_count_{0};
+  std::uint64_t index_offset_{0};
+  std::uint64_t index_entry_count_{0};
+  std::uint64_t index_stride_{0};
+};
+
+// first record at or after timestamp event_timestamp_ is record_ or later
+struct TickCaptureIndexEntry {
+  std::uint64_t event_timestamp_{0};
+  std::uint64_t record_{0};
+};
+
+constexpr static std::size_t TICK_CAPTURE_ALIGNMENT = CACHE_LINE_SIZE;
+
+static_assert(std::is_trivially_copyable_v<TickCaptureHeader> && std::is_trivially_copyable_v<TickCaptureIndexEntry>,
+			  "the header and the index are written and mapped verbatim");
+
+struct TickCaptureConfiguration {
+  // ticks in flight between the publishing thread and the writer thread, rounded up to a power of 2
+  std::size_t queue_capacity_{1 << 16};
+  // records between two index entries, 0 writes no index
+  std::uint64_t index_stride_{4096};
+};
+
+// Appends ticks to a capture file. write() only enqueues the tick, a writer thread owned by the capture does the
+// file output, so the publishing thread never waits on the disk - unless the queue fills up, which is lossless.
+class TickCaptureWriter {
+ public:
+  TickCaptureWriter(const std::string &path,
+					const std::vector<std::string> &instrumentList,
+					const TickCaptureConfiguration &configuration = {});
+
+  TickCaptureWriter() = delete;
+
+  TickCaptureWriter(const TickCaptureWriter &) = delete;
+
+  TickCaptureWriter &operator=(const TickCaptureWriter &) = delete;
+
+  TickCaptureWriter(TickCaptureWriter &&) noexcept = delete;
+
+  TickCaptureWriter &operator=(TickCaptureWriter &&) noexcept = delete;
+
+  ~TickCaptureWriter();
+
+  // publishing thread only
+  inline void write(const TickEvent &tickEvent) {
+	ticks_.push(tickEvent);
+  }
+
+  // Publishing thread only, writes out the queued ticks, the index and the final header. Idempotent. Throws
+  // std::runtime_error when the capture could not be written in full, its header then counts no record.
+  void close();
+
+  // ticks written so far, final once closed
+  [[nodiscard]] std::uint64_t getRecordCount() const {
+	return record_count_.load(std::memory_order_acquire);
+  }
+
+ private:
+  // ticks handed to the file stream per write
+  constexpr static std::size_t WRITE_BATCH_SIZE = 4096;
+
+  void drain();
+
+  [[noreturn]] void throwWriteFailure() const;
+
+  std::string path_;
+  std::ofstream ofs_;
+  std::vector<char> stream_buffer_;
+  TickCaptureHeader header_{};
+
+  SpscRingBuffer<TickEvent> ticks_;
+
+  // writer thread only until it is joined
+  std::vector<TickCaptureIndexEntry> index_{};
+  std::atomic<std::uint64_t> record_count_{0};
+
+  std::thread writer_thread_{};
+};
+
+}
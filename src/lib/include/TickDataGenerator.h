@@ -1,14 +1,26 @@
 #pragma once
 
+#include <array>
+#include <atomic>
 #include <cstdint>
-#include <queue>
+#include <limits>
+#include <memory>
+#include <optional>
 #include <string>
+#include <thread>
 #include <unordered_map>
+#include <vector>
 
 #include "InstrumentSimulationModel.h"
+#include "ShapedSimulationModels.h"
+#include "TimingWheel.h"
+
+#include "base/types.h"
+#include "base/two_level_bitset.h"
 
 #include "InstrumentPrice.h"
 #include "IMarketDataProvider.h"
+#include "StaticTickPipeline.h"
 #include "TickEvent.h"
 
 namespace basket::pricer {
@@ -17,11 +29,25 @@ struct GenerationData {
   InstrumentPrice instrumentPrice{};
 };
 
+struct TickDataGeneratorConfiguration {
+  // master seed of the simulation, overriding the master_seed line of the simulation config: every model is seeded
+  // from it and the model position in the config, reproducing the same run. Without either, models draw their seeds
+  // from std::random_device
+  std::optional<std::uint64_t> seed_{};
+
+  // 1 simulates on the thread calling run(), more splits the instruments across as many worker threads
+  int generation_threads_{1};
+
+  // clock ticks the worker threads simulate per round, merged into the subscriber one round behind
+  std::uint64_t generation_window_{256};
+};
+
 class TickDataGenerator : public IMarketDataProvider {
  public:
-  explicit TickDataGenerator(const std::string &csv_path);
+  explicit TickDataGenerator(const std::string &csv_path, const TickDataGeneratorConfiguration &configuration = {});
 
-  ~TickDataGenerator() = default;
+  // stops the worker threads
+  ~TickDataGenerator();
 
   TickDataGenerator() = delete;
 
@@ -33,27 +59,282 @@ class TickDataGenerator : public IMarketDataProvider {
 
   TickDataGenerator &operator=(TickDataGenerator &&) noexcept = delete;
 
-  void subscribe(CallbackFunc &&callback, std::vector<std::string> &&instrumentList) override;
+  void subscribeBatch(BatchCallbackFunc &&callback, std::vector<std::string> &&instrumentList) override;
+
+  // Publishes every event of a timestamp, in the order they were scheduled, then simulates each instrument which
+  // ticked once. Worker threads publish exactly the same sequence. Batches hold whole timestamps, as many as fit
+  // PUBLICATION_BATCH_SIZE events, or a round of the worker threads, hence always end a timestamp.
   void run() override;
 
+  // run() publishing straight to the subscriber, see StaticTickPipeline.h
+  template<TickBatchSubscriber Subscriber>
+  void runInto(Subscriber &subscriber);
+
+  // Any thread, run() returns after the batch it is publishing, hence on a whole timestamp, and every later run()
+  // returns at once
+  void requestStop() {
+	stop_requested_.store(true, std::memory_order_release);
+  }
+
+  // run() returns before publishing an event later than end_timestamp, a later run() resumes where it stopped
+  void setEndTimestamp(const std::uint64_t &end_timestamp) {
+	end_event_timestamp_ = end_timestamp;
+  }
+
+  [[nodiscard]] std::uint64_t getLatestEventTimestamp() const {
+	return lastest_event_timestamp_;
+  }
+
+  // next bid / ask shape of the instrument as per its simulation model
+  static InstrumentPrice produceNewPriceShape(const GenerationData &data) {
+	return pricer::produceNewPriceShape(*data.generation_model_, data.instrumentPrice);
+  }
+
  private:
+  // events published per batch by the thread calling run(), short of the timestamps which do not fit
+  constexpr static std::size_t PUBLICATION_BATCH_SIZE = 64;
+
+  // events scheduled at the same timestamp and time are ordered by instrument id then by enqueueing order
+  struct ScheduledEvent {
+	TickEvent tick_event_{};
+	std::uint64_t scheduled_at_{0};
+  };
+
+  struct EventTimestamp {
+	std::uint64_t operator()(const ScheduledEvent &scheduledEvent) const {
+	  return scheduledEvent.tick_event_.event_timestamp_;
+	}
+  };
+
+  // Instruments [first_instrument_, end_instrument_) simulated together, by the thread calling run() or by a worker
+  struct Partition {
+	InstrumentIdType first_instrument_{0};
+	InstrumentIdType end_instrument_{0};
 
-  void simulateInstrument(const std::string &instrumentName);
+	// pending tick events by timestamp, same timestamp events in the order they were scheduled
+	TimingWheel<ScheduledEvent, EventTimestamp> scheduled_events_{};
+	std::vector<ScheduledEvent> due_events_{};
 
-  InstrumentPrice produceNewPriceShape(
-	  const GenerationData &data,
-	  const std::string &instrumentName) const;
+	// instruments which published at the current timestamp, by offset from first_instrument_
+	TwoLevelBitset instruments_with_events_{};
+	std::vector<InstrumentIdType> instruments_to_simulate_{};
+	std::vector<std::vector<InstrumentIdType>> instruments_by_model_shape_{};
+
+	// an event time overflowed the uint64_t clock, the simulation cannot go further
+	bool end_of_world_{false};
+
+	// worker threads only - the events of two consecutive rounds, one being merged while the next is simulated
+	std::array<std::vector<ScheduledEvent>, 2> rounds_{};
+	std::array<bool, 2> exhausted_{};
+	std::size_t merge_position_{0};
+
+	alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> simulated_rounds_{0};
+  };
+
+  template<typename Publish>
+  bool simulateNextTimestamp(Partition &partition, const std::uint64_t &last_timestamp, Publish &&publish);
+
+  // simulates the instruments_to_simulate_ of the partition, scheduling their next events in instrument id order
+  void simulateInstruments(Partition &partition, const std::uint64_t &now);
 
   void enqueueNewTickEvents(
+	  Partition &partition,
+	  const InstrumentPrice &prevInstrumentPrice,
 	  const InstrumentPrice &newInstrumentPrice,
-	  const GenerationData &generationData,
-	  const std::string &instrumentName);
+	  const std::uint64_t &nextEventInterval,
+	  const InstrumentIdType &instrumentId,
+	  const std::uint64_t &now);
+
+  // publishes through deliver, the subscribed callback or a subscriber bound at compile time
+  template<typename Deliver>
+  void runWith(Deliver &deliver);
+
+  // hands the events gathered so far to the subscriber
+  template<typename Deliver>
+  void publishBatch(Deliver &deliver);
+
+  template<typename Deliver>
+  void runInline(Deliver &deliver);
+
+  template<typename Deliver>
+  void runMerged(Deliver &deliver);
+
+  void simulateRounds(Partition &partition);
+
+  void stopWorkers();
+
+  TickDataGeneratorConfiguration configuration_;
 
   std::uint64_t lastest_event_timestamp_{0};
+  std::uint64_t end_event_timestamp_{std::numeric_limits<std::uint64_t>::max()};
+
+  // a simulation model as configured, built anew upon every subscription
+  struct ModelConfiguration {
+	std::vector<std::string> next_event_time_cfg_{};
+	std::vector<std::string> initial_price_cfg_{};
+	std::vector<std::string> direction_cfg_{};
+	std::vector<std::string> tick_move_cfg_{};
+	int max_tick_diff_{0};
+	std::uint64_t seed_{0};
+  };
+
+  std::unordered_map<std::string, ModelConfiguration> instrument_models_{};
 
-  std::priority_queue<TickEvent, std::vector<TickEvent>, std::greater<TickEvent>> pq_{};
+  // indexed by the instrument id interned at subscription
+  ShapedSimulationModels subscribed_models_{};
+  std::vector<InstrumentPrice> instrument_prices_{};
+  std::vector<InstrumentPrice> next_instrument_prices_{};
+  std::vector<std::uint64_t> next_event_intervals_{};
 
-  std::unordered_map<std::string, GenerationData> instrument_model_{};
+  std::vector<std::unique_ptr<Partition>> partitions_{};
 
+  // events gathered for the subscriber, thread calling run() only
+  std::vector<TickEvent> publication_batch_{};
+
+  std::atomic<bool> stop_requested_{false};
+
+  // worker threads only
+  std::vector<std::thread> workers_{};
+  std::uint64_t merged_rounds_{0};
+  alignas(CACHE_LINE_SIZE) std::atomic<std::uint64_t> released_rounds_{0};
+  std::atomic<bool> stopping_{false};
 };
-}
\ No newline at end of file
+
+template<TickBatchSubscriber Subscriber>
+void TickDataGenerator::runInto(Subscriber &subscriber) {
+  auto deliver = [&subscriber](const std::span<const TickEvent> &ticks, const bool &endOfBatch) {
+	subscriber.onTickBatch(ticks, endOfBatch);
+  };
+  runWith(deliver);
+}
+
+template<typename Deliver>
+void TickDataGenerator::runWith(Deliver &deliver) {
+  if (stop_requested_.load(std::memory_order_acquire)) return;
+
+  if (partitions_.size() == 1) {
+	runInline(deliver);
+  } else if (partitions_.size() > 1) {
+	runMerged(deliver);
+  }
+}
+
+template<typename Publish>
+bool TickDataGenerator::simulateNextTimestamp(Partition &partition,
+											  const std::uint64_t &last_timestamp,
+											  Publish &&publish) {
+  if (partition.end_of_world_ || partition.scheduled_events_.isEmpty()) return false;
+
+  const auto timestamp = partition.scheduled_events_.advance();
+  if (timestamp > last_timestamp) return false;
+
+  partition.due_events_.clear();
+  partition.scheduled_events_.popDue(partition.due_events_);
+
+  for (const auto &scheduledEvent : partition.due_events_) {
+	publish(scheduledEvent);
+	partition.instruments_with_events_.set(scheduledEvent.tick_event_.instrumentId_ - partition.first_instrument_);
+  }
+
+  // every instrument which ticked is simulated once the timestamp is over, in instrument id order
+  partition.instruments_with_events_.forEachAndClear([&partition](const std::size_t &offset) {
+	partition.instruments_to_simulate_.push_back(static_cast<InstrumentIdType>(partition.first_instrument_ + offset));
+  });
+  simulateInstruments(partition, timestamp);
+  return true;
+}
+
+template<typename Deliver>
+void TickDataGenerator::publishBatch(Deliver &deliver) {
+  if (publication_batch_.empty()) return;
+
+  deliver(std::span<const TickEvent>(publication_batch_), true);
+  publication_batch_.clear();
+}
+
+template<typename Deliver>
+void TickDataGenerator::runInline(Deliver &deliver) {
+  auto &partition = *partitions_.front();
+
+  while (simulateNextTimestamp(partition, end_event_timestamp_, [this](const ScheduledEvent &scheduledEvent) {
+	lastest_event_timestamp_ = scheduledEvent.tick_event_.event_timestamp_;
+	publication_batch_.push_back(scheduledEvent.tick_event_);
+  })) {
+	if (publication_batch_.size() >= PUBLICATION_BATCH_SIZE) {
+	  publishBatch(deliver);
+	  if (stop_requested_.load(std::memory_order_acquire)) [[unlikely]] return;
+	}
+  }
+  publishBatch(deliver);
+}
+
+template<typename Deliver>
+void TickDataGenerator::runMerged(Deliver &deliver) {
+  if (workers_.empty()) {
+	for (auto &partition : partitions_) {
+	  workers_.emplace_back([this, &partition = *partition] { simulateRounds(partition); });
+	}
+  }
+
+  // the order a single partition publishes in, see ScheduledEvent
+  auto is_earlier = [](const ScheduledEvent &lhs, const ScheduledEvent &rhs) {
+	if (lhs.tick_event_.event_timestamp_ != rhs.tick_event_.event_timestamp_) {
+	  return lhs.tick_event_.event_timestamp_ < rhs.tick_event_.event_timestamp_;
+	}
+	if (lhs.scheduled_at_ != rhs.scheduled_at_) return lhs.scheduled_at_ < rhs.scheduled_at_;
+	return lhs.tick_event_.instrumentId_ < rhs.tick_event_.instrumentId_;
+  };
+
+  while (true) {
+	const auto round = merged_rounds_;
+	const auto buffer = round % 2;
+
+	bool exhausted{true};
+	for (auto &partition : partitions_) {
+	  for (auto simulated = partition->simulated_rounds_.load(std::memory_order_acquire); simulated <= round;
+		   simulated = partition->simulated_rounds_.load(std::memory_order_acquire)) {
+		partition->simulated_rounds_.wait(simulated, std::memory_order_acquire);
+	  }
+	  exhausted = exhausted && partition->exhausted_[buffer];
+	}
+
+	// k-way merge of the partition rounds, each already in publication order
+	while (true) {
+	  Partition *next{nullptr};
+	  const ScheduledEvent *next_event{nullptr};
+
+	  for (auto &partition : partitions_) {
+		const auto &events = partition->rounds_[buffer];
+		if (partition->merge_position_ == events.size()) continue;
+
+		const auto &scheduledEvent = events[partition->merge_position_];
+		if (!next_event || is_earlier(scheduledEvent, *next_event)) {
+		  next = partition.get();
+		  next_event = &scheduledEvent;
+		}
+	  }
+	  if (!next) break;
+
+	  if (next_event->tick_event_.event_timestamp_ > end_event_timestamp_) {
+		publishBatch(deliver);
+		return;
+	  }
+
+	  next->merge_position_++;
+	  lastest_event_timestamp_ = next_event->tick_event_.event_timestamp_;
+	  publication_batch_.push_back(next_event->tick_event_);
+	}
+
+	// rounds end on the same timestamp for every partition
+	publishBatch(deliver);
+
+	for (auto &partition : partitions_) partition->merge_position_ = 0;
+
+	merged_rounds_ = round + 1;
+	released_rounds_.store(merged_rounds_, std::memory_order_release);
+	released_rounds_.notify_all();
+
+	if (exhausted || stop_requested_.load(std::memory_order_acquire)) return;
+  }
+}
+}
@@ -1,7 +1,7 @@
 #pragma once
 
 #include <cstdint>
-#include <string>
+#include <type_traits>
 
 #include "base/types.h"
 
@@ -13,22 +13,24 @@ enum class TickEventType : std::int32_t {
   INVALID
 };
 
+// Fixed size record travelling from the market data provider to the pricer.
+// The instrument is identified by the id interned at subscription, see IMarketDataProvider::subscribe
 struct TickEvent {
   TickEvent() = default;
 
   TickEvent(const std::uint64_t &event_timestamp,
 			const PriceType &price,
 			const TickEventType &eventType,
-			const std::string &instrumentName)
+			const InstrumentIdType &instrumentId)
 	  : event_timestamp_(event_timestamp), price_(price), eventType_(eventType),
-		instrumentName_(instrumentName) {
+		instrumentId_(instrumentId) {
   }
 
   std::uint64_t event_timestamp_{0};
   PriceType price_{0};
 
   TickEventType eventType_{TickEventType::INVALID};
-  std::string instrumentName_{};
+  InstrumentIdType instrumentId_{-1};
 
   friend bool operator<(const TickEvent &lhs, const TickEvent &rhs);
 
@@ -38,4 +40,7 @@ struct TickEvent {
 
   friend bool operator>=(const TickEvent &lhs, const TickEvent &rhs);
 };
+
+static_assert(std::is_trivially_copyable_v<TickEvent> && std::is_standard_layout_v<TickEvent>,
+			  "TickEvent is copied around the tick path and must stay a plain record");
 }
\ No newline at end of file
@@ -0,0 +1,71 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <ostream>
+
+#include "base/latency_clock.h"
+#include "LatencyHistogram.h"
+#include "TickEvent.h"
+
+#ifndef BASKET_LATENCY_HISTOGRAM
+#define BASKET_LATENCY_HISTOGRAM 0
+#endif
+
+namespace basket::pricer {
+
+// onTickUpdate latency split by tick event type and by whether the tick emitted a threshold event.
+// Built with BASKET_LATENCY_HISTOGRAM=0 - the default - start and record are empty and the recorder holds nothing.
+class TickLatencyRecorder {
+ public:
+  constexpr static bool ENABLED = BASKET_LATENCY_HISTOGRAM;
+
+  // tick events with a histogram, INVALID is rejected before being priced
+  constexpr static int EVENT_TYPE_COUNT = static_cast<int>(TickEventType::INVALID);
+
+  struct Start {
+#if BASKET_LATENCY_HISTOGRAM
+	std::uint64_t clock_{0};
+#endif
+  };
+
+  TickLatencyRecorder();
+
+  TickLatencyRecorder(const TickLatencyRecorder &) = delete;
+
+  TickLatencyRecorder &operator=(const TickLatencyRecorder &) = delete;
+
+  ~TickLatencyRecorder() = default;
+
+  [[nodiscard]] inline Start start() const {
+#if BASKET_LATENCY_HISTOGRAM
+	return Start{LatencyClock::now()};
+#else
+	return {};
+#endif
+  }
+
+  // pricing thread only
+  inline void record([[maybe_unused]] const Start &start,
+					 [[maybe_unused]] const TickEventType &eventType,
+					 [[maybe_unused]] const bool &breached) {
+#if BASKET_LATENCY_HISTOGRAM
+	const auto elapsed = LatencyClock::now() - start.clock_;
+	histograms_[static_cast<int>(eventType) * 2 + breached].record(elapsed);
+#endif
+  }
+
+  // adds the latencies recorded by other, from the thread calling dump only
+  void merge(const TickLatencyRecorder &other);
+
+  // count, p50, p99, p99.9 and max in nanoseconds per event type and breach outcome, safe while recording
+  void dump(std::ostream &os) const;
+
+ private:
+#if BASKET_LATENCY_HISTOGRAM
+  // [event type][breached]
+  std::unique_ptr<LatencyHistogram[]> histograms_;
+#endif
+};
+
+}
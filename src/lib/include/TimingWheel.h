@@ -0,0 +1,140 @@
+#pragma once
+
+#include <array>
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace basket::pricer {
+
+// Hierarchical timing wheel over 64 bit integer timestamps: LEVEL_COUNT levels of SLOT_COUNT slots, one level per
+// byte of the timestamp. A value lives on the level of the highest byte where its timestamp differs from the wheel
+// clock, in the slot given by that byte, and moves one or more levels down whenever the clock enters its slot.
+// schedule is O(1), moving to the next timestamp is O(1) amortised over the values scheduled - occupied slots are
+// found through per level occupancy bitmaps.
+// Values due at the same timestamp come out in scheduling order. Slot storage is recycled, the wheel stops
+// allocating once it has seen its peak load.
+// TimestampOf returns the timestamp of a value.
+template<typename T, typename TimestampOf>
+class TimingWheel {
+ public:
+  TimingWheel() = default;
+
+  TimingWheel(const TimingWheel &) = delete;
+
+  TimingWheel &operator=(const TimingWheel &) = delete;
+
+  TimingWheel(TimingWheel &&) noexcept = default;
+
+  TimingWheel &operator=(TimingWheel &&) noexcept = default;
+
+  ~TimingWheel() = default;
+
+  // the timestamp of value must not be earlier than getNow()
+  inline void schedule(const T &value) {
+	const std::uint64_t timestamp = TimestampOf{}(value);
+	const int level = levelOf(timestamp);
+	const int slot = slotOf(timestamp, level);
+
+	slots_[level][slot].push_back(value);
+	occupancy_[level][slot / 64] |= std::uint64_t{1} << (slot % 64);
+	size_++;
+  }
+
+  [[nodiscard]] bool isEmpty() const {
+	return size_ == 0;
+  }
+
+  [[nodiscard]] std::size_t getSize() const {
+	return size_;
+  }
+
+  // wheel clock, no value is due earlier
+  [[nodiscard]] std::uint64_t getNow() const {
+	return now_;
+  }
+
+  // Moves the clock to the earliest scheduled timestamp and returns it, the wheel must not be empty
+  std::uint64_t advance() {
+	while (true) {
+	  const int slot = nextOccupiedSlot(0, static_cast<int>(now_ & SLOT_MASK));
+	  if (slot >= 0) {
+		now_ = (now_ & ~SLOT_MASK) | static_cast<std::uint64_t>(slot);
+		return now_;
+	  }
+
+	  // level 0 is exhausted, enter the next occupied slot of the lowest level holding one
+	  for (int level = 1; level < LEVEL_COUNT; level++) {
+		const int digit = static_cast<int>((now_ >> (level * SLOT_BITS)) & SLOT_MASK);
+		const int next = nextOccupiedSlot(level, digit + 1);
+		if (next < 0) continue;
+
+		const int shift = level * SLOT_BITS;
+		const std::uint64_t above = (shift + SLOT_BITS < 64) ? (now_ >> (shift + SLOT_BITS)) << (shift + SLOT_BITS) : 0;
+		now_ = above | (static_cast<std::uint64_t>(next) << shift);
+		cascade(level, next);
+		break;
+	  }
+	}
+  }
+
+  // Appends the values due at getNow() to out in scheduling order, call after advance()
+  void popDue(std::vector<T> &out) {
+	const int slot = static_cast<int>(now_ & SLOT_MASK);
+	auto &due = slots_[0][slot];
+
+	size_ -= due.size();
+	if (out.empty()) {
+	  // hand the slot storage over, out's storage serves the slot next time
+	  out.swap(due);
+	} else {
+	  out.insert(out.end(), due.begin(), due.end());
+	}
+	due.clear();
+	occupancy_[0][slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+  }
+
+ private:
+  constexpr static int SLOT_BITS = 8;
+  constexpr static int SLOT_COUNT = 1 << SLOT_BITS;
+  constexpr static std::uint64_t SLOT_MASK = SLOT_COUNT - 1;
+  constexpr static int LEVEL_COUNT = 64 / SLOT_BITS;
+  constexpr static int OCCUPANCY_WORDS = SLOT_COUNT / 64;
+
+  [[nodiscard]] inline int levelOf(const std::uint64_t &timestamp) const {
+	const std::uint64_t differing = timestamp ^ now_;
+	return differing ? (std::bit_width(differing) - 1) / SLOT_BITS : 0;
+  }
+
+  [[nodiscard]] static inline int slotOf(const std::uint64_t &timestamp, const int &level) {
+	return static_cast<int>((timestamp >> (level * SLOT_BITS)) & SLOT_MASK);
+  }
+
+  // first occupied slot of the level at or after from, -1 if none
+  [[nodiscard]] int nextOccupiedSlot(const int &level, const int &from) const {
+	for (int word = from / 64; word < OCCUPANCY_WORDS; word++) {
+	  std::uint64_t bits = occupancy_[level][word];
+	  if (word == from / 64) bits &= ~std::uint64_t{0} << (from % 64);
+	  if (bits) return word * 64 + std::countr_zero(bits);
+	}
+	return -1;
+  }
+
+  // redistributes a slot the clock just entered over the lower levels, keeping the scheduling order
+  void cascade(const int &level, const int &slot) {
+	auto &values = slots_[level][slot];
+	occupancy_[level][slot / 64] &= ~(std::uint64_t{1} << (slot % 64));
+
+	size_ -= values.size();
+	for (const auto &value : values) schedule(value);
+	values.clear();
+  }
+
+  std::array<std::array<std::vector<T>, SLOT_COUNT>, LEVEL_COUNT> slots_{};
+  std::array<std::array<std::uint64_t, OCCUPANCY_WORDS>, LEVEL_COUNT> occupancy_{};
+
+  std::uint64_t now_{0};
+  std::size_t size_{0};
+};
+
+}
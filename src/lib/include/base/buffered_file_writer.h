@@ -0,0 +1,97 @@
+#pragma once
+
+#include <cerrno>
+#include <cstddef>
+#include <cstdint>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <vector>
+
+#include <fcntl.h>
+#include <unistd.h>
+
+namespace basket::pricer {
+
+// Appends to a file descriptor through a buffer which is only written out when full or flushed, in as few write
+// calls as the descriptor accepts. A failed write drops what was buffered and is counted, the writer never throws
+// once open.
+class BufferedFileWriter {
+ public:
+  constexpr static std::size_t DEFAULT_CAPACITY = 1 << 16;
+
+  // writes to an open descriptor, e.g. STDOUT_FILENO, which is left open
+  explicit BufferedFileWriter(const int &fd, const std::size_t &capacity = DEFAULT_CAPACITY)
+	  : buffer_(capacity), fd_(fd) {
+  }
+
+  // creates or truncates the file
+  explicit BufferedFileWriter(const std::string &path, const std::size_t &capacity = DEFAULT_CAPACITY)
+	  : buffer_(capacity), fd_(::open(path.c_str(), O_WRONLY | O_CREAT | O_TRUNC, 0644)), owned_(true) {
+	if (fd_ < 0) {
+	  std::ostringstream oss;
+	  oss << "Unable to create " << path << " - " << std::strerror(errno);
+	  throw std::runtime_error(oss.str());
+	}
+  }
+
+  BufferedFileWriter(const BufferedFileWriter &) = delete;
+
+  BufferedFileWriter &operator=(const BufferedFileWriter &) = delete;
+
+  BufferedFileWriter(BufferedFileWriter &&) = delete;
+
+  BufferedFileWriter &operator=(BufferedFileWriter &&) = delete;
+
+  ~BufferedFileWriter() {
+	flush();
+	if (owned_) ::close(fd_);
+  }
+
+  // room for at least size bytes to format in place, made visible by commit()
+  inline char *prepare(const std::size_t &size) {
+	if (buffer_.size() - size_ < size) [[unlikely]] {
+	  flush();
+	  if (buffer_.size() < size) buffer_.resize(size);
+	}
+	return buffer_.data() + size_;
+  }
+
+  inline void commit(const std::size_t &size) {
+	size_ += size;
+  }
+
+  inline void append(const void *data, const std::size_t &size) {
+	std::memcpy(prepare(size), data, size);
+	commit(size);
+  }
+
+  void flush() {
+	std::size_t written{0};
+	while (written < size_) {
+	  const auto result = ::write(fd_, buffer_.data() + written, size_ - written);
+	  if (result < 0) {
+		if (errno == EINTR) continue;
+		write_errors_++;
+		break;
+	  }
+	  written += static_cast<std::size_t>(result);
+	}
+	size_ = 0;
+  }
+
+  [[nodiscard]] std::uint64_t getWriteErrorCount() const {
+	return write_errors_;
+  }
+
+ private:
+  std::vector<char> buffer_;
+  std::size_t size_{0};
+
+  int fd_{-1};
+  bool owned_{false};
+  std::uint64_t write_errors_{0};
+};
+
+}
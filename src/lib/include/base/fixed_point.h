@@ -0,0 +1,53 @@
+#pragma once
+
+#include <cmath>
+
+#include "types.h"
+
+namespace basket::pricer {
+
+inline PriceType toPrice(const double &price) {
+  return static_cast<PriceType>(std::llround(price * PRICE_SCALE));
+}
+
+inline WeightType toWeight(const double &weight) {
+  return static_cast<WeightType>(std::llround(weight * WEIGHT_SCALE));
+}
+
+inline ThresholdType toThreshold(const double &threshold_pct) {
+  return static_cast<ThresholdType>(std::llround(threshold_pct * THRESHOLD_SCALE));
+}
+
+inline double priceToDouble(const PriceType &price) {
+  return static_cast<double>(price) / PRICE_SCALE;
+}
+
+inline double weightedPriceToDouble(const WeightedPriceType &price) {
+  return static_cast<double>(price) / (static_cast<double>(PRICE_SCALE) * WEIGHT_SCALE);
+}
+
+inline double thresholdToDouble(const ThresholdType &threshold) {
+  return static_cast<double>(threshold) / THRESHOLD_SCALE;
+}
+
+// |new_price - prev_price| / prev_price * 100 > threshold, evaluated exactly in integers.
+// Products are widened to 128 bits only in the rare case they do not fit 64 bits.
+inline bool isThresholdBreached(const WeightedPriceType &prev_price,
+								const WeightedPriceType &new_price,
+								const ThresholdType &threshold) {
+  const WeightedPriceType delta = (new_price > prev_price) ? new_price - prev_price : prev_price - new_price;
+
+  WeightedPriceType scaled_delta{0}, scaled_threshold{0};
+  if (!__builtin_mul_overflow(delta, 100 * THRESHOLD_SCALE, &scaled_delta) &&
+	  !__builtin_mul_overflow(threshold, prev_price, &scaled_threshold)) [[likely]] {
+	return scaled_delta > scaled_threshold;
+  }
+  return static_cast<__int128>(delta) * (100 * THRESHOLD_SCALE) > static_cast<__int128>(threshold) * prev_price;
+}
+
+// only meant for reporting, the pricing itself never leaves the integer domain
+inline double deltaPercentage(const WeightedPriceType &prev_price, const WeightedPriceType &new_price) {
+  return std::fabs(static_cast<double>(new_price - prev_price)) / static_cast<double>(prev_price) * 100.0;
+}
+
+}
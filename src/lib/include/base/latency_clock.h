@@ -0,0 +1,49 @@
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+
+#if defined(__x86_64__) || defined(__i386__)
+#include <x86intrin.h>
+#endif
+
+namespace basket::pricer {
+
+// Cheapest monotonic timestamp available - the time stamp counter on x86, steady_clock nanoseconds elsewhere.
+// Tick differences convert to nanoseconds with nanosecondsPerTick, calibrated against steady_clock on first use.
+class LatencyClock {
+ public:
+  [[nodiscard]] static inline std::uint64_t now() {
+#if defined(__x86_64__) || defined(__i386__)
+	return __rdtsc();
+#else
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+#endif
+  }
+
+  [[nodiscard]] static double nanosecondsPerTick() {
+#if defined(__x86_64__) || defined(__i386__)
+	static const double nanoseconds_per_tick = calibrate();
+	return nanoseconds_per_tick;
+#else
+	return 1.0;
+#endif
+  }
+
+ private:
+  static double calibrate() {
+	constexpr static auto CALIBRATION_PERIOD = std::chrono::milliseconds(20);
+
+	const auto steady_start = std::chrono::steady_clock::now();
+	const auto tick_start = now();
+
+	auto steady_end = steady_start;
+	while (steady_end - steady_start < CALIBRATION_PERIOD) steady_end = std::chrono::steady_clock::now();
+	const auto tick_end = now();
+
+	return std::chrono::duration<double, std::nano>(steady_end - steady_start).count() / (tick_end - tick_start);
+  }
+};
+
+}
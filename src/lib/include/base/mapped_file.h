@@ -0,0 +1,77 @@
+#pragma once
+
+#include <cstddef>
+#include <sstream>
+#include <stdexcept>
+#include <string>
+#include <string_view>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+namespace basket::pricer {
+
+// Read only private mapping of a whole file, unmapped on destruction. An empty file maps to an empty view.
+class MappedFile {
+ public:
+  explicit MappedFile(const std::string &path, const int &advice = MADV_SEQUENTIAL) {
+	const int fd = ::open(path.c_str(), O_RDONLY);
+	if (fd < 0) throwError(path, "unable to open");
+
+	struct stat file_stat{};
+	if (::fstat(fd, &file_stat) != 0) {
+	  ::close(fd);
+	  throwError(path, "unable to stat");
+	}
+
+	size_ = static_cast<std::size_t>(file_stat.st_size);
+	if (size_ > 0) {
+	  data_ = ::mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+	  if (data_ == MAP_FAILED) {
+		data_ = nullptr;
+		::close(fd);
+		throwError(path, "unable to map");
+	  }
+	  ::madvise(data_, size_, advice);
+	}
+	::close(fd);
+  }
+
+  MappedFile(const MappedFile &) = delete;
+
+  MappedFile &operator=(const MappedFile &) = delete;
+
+  MappedFile(MappedFile &&) = delete;
+
+  MappedFile &operator=(MappedFile &&) = delete;
+
+  ~MappedFile() {
+	if (data_) ::munmap(data_, size_);
+  }
+
+  [[nodiscard]] const char *data() const {
+	return static_cast<const char *>(data_);
+  }
+
+  [[nodiscard]] std::size_t size() const {
+	return size_;
+  }
+
+  [[nodiscard]] std::string_view view() const {
+	return {data(), size_};
+  }
+
+ private:
+  [[noreturn]] static void throwError(const std::string &path, const std::string &reason) {
+	std::ostringstream oss;
+	oss << "Failed to read " << path << " - " << reason;
+	throw std::runtime_error(oss.str());
+  }
+
+  void *data_{nullptr};
+  std::size_t size_{0};
+};
+
+}
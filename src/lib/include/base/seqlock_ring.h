@@ -0,0 +1,82 @@
+#pragma once
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <thread>
+
+#include "base/spin_wait.h"
+
+namespace basket::pricer {
+
+// Reader side of a ring with a single writer which never waits for its readers: entry n goes to slot n % capacity,
+// whose sequence_ is 2 * n + 1 while the entry is written and 2 * n + 2 once it can be read.
+// Copies the entry at position with copy(slot) and moves past it, false when it is not written yet. An entry the
+// writer overwrote before or during the copy is skipped, along with whatever else it lapped, up to the oldest entry
+// still in the ring - write_position() tells where the writer is - and counted in gap_count.
+template<typename SlotAt, typename Copy, typename WritePosition>
+inline bool tryReadSeqlockSlot(std::uint64_t &position,
+							   std::atomic<std::uint64_t> &gap_count,
+							   const std::uint64_t &capacity,
+							   SlotAt &&slot_at,
+							   Copy &&copy,
+							   WritePosition &&write_position) {
+  while (true) {
+	const auto &slot = slot_at(position);
+
+	const std::uint64_t sequence = slot.sequence_.load(std::memory_order_acquire);
+	if (sequence < 2 * position + 2) return false;
+
+	if (sequence == 2 * position + 2) {
+	  // the copy may race with the writer lapping the ring, the sequence recheck rejects a torn copy
+	  copy(slot);
+	  std::atomic_thread_fence(std::memory_order_acquire);
+	  if (slot.sequence_.load(std::memory_order_relaxed) == sequence) [[likely]] {
+		position++;
+		return true;
+	  }
+	}
+
+	// overwritten, skip to the oldest entry still in the ring
+	const std::uint64_t head = write_position();
+	const std::uint64_t oldest = head > capacity ? head - capacity : 0;
+	const std::uint64_t resume = (oldest > position) ? oldest : position + 1;
+	gap_count.store(gap_count.load(std::memory_order_relaxed) + (resume - position), std::memory_order_relaxed);
+	position = resume;
+  }
+}
+
+// Between the empty polls of a ring reader: spins, then yields, then sleeps in short steps, or only spins when busy
+// polling
+class PollBackoff {
+ public:
+  explicit PollBackoff(const bool &busy_poll = false) : busy_poll_(busy_poll) {
+  }
+
+  // after a poll which read something
+  inline void reset() {
+	idle_ = 0;
+  }
+
+  // after an empty poll
+  void wait() {
+	if (busy_poll_ || idle_ < SPINS_BEFORE_YIELDING) {
+	  cpuRelax();
+	} else if (idle_ < SPINS_BEFORE_YIELDING + YIELDS_BEFORE_SLEEPING) {
+	  std::this_thread::yield();
+	} else {
+	  std::this_thread::sleep_for(SLEEP_STEP);
+	}
+	if (idle_ < SPINS_BEFORE_YIELDING + YIELDS_BEFORE_SLEEPING) idle_++;
+  }
+
+ private:
+  constexpr static int SPINS_BEFORE_YIELDING = 1024;
+  constexpr static int YIELDS_BEFORE_SLEEPING = 64;
+  constexpr static auto SLEEP_STEP = std::chrono::microseconds(50);
+
+  bool busy_poll_;
+  int idle_{0};
+};
+
+}
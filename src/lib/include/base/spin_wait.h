@@ -0,0 +1,14 @@
+#pragma once
+
+namespace basket::pricer {
+
+// hint to the cpu that the caller is busy waiting
+inline void cpuRelax() {
+#if defined(__x86_64__) || defined(__i386__)
+  __builtin_ia32_pause();
+#elif defined(__aarch64__)
+  asm volatile("yield");
+#endif
+}
+
+}
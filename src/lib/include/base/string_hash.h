@@ -0,0 +1,23 @@
+#pragma once
+
+#include <cstddef>
+#include <functional>
+#include <string>
+#include <string_view>
+#include <unordered_map>
+
+namespace basket::pricer {
+
+// Hash of std::string keys which also accepts string_view lookups, sparing a string per find
+struct StringHash {
+  using is_transparent = void;
+
+  std::size_t operator()(const std::string_view &value) const {
+	return std::hash<std::string_view>{}(value);
+  }
+};
+
+template<typename T>
+using StringMap = std::unordered_map<std::string, T, StringHash, std::equal_to<>>;
+
+}
@@ -0,0 +1,47 @@
+#pragma once
+
+#include <bit>
+#include <cstdint>
+#include <vector>
+
+namespace basket::pricer {
+
+// Bitset over [0, size) with a summary word per 64 words, so visiting the set bits costs
+// size / 4096 summary words plus one word per 64 bit block holding a set bit, not size / 64 words.
+class TwoLevelBitset {
+ public:
+  TwoLevelBitset() = default;
+
+  explicit TwoLevelBitset(const std::size_t &size)
+	  : words_((size + 63) / 64, 0), summary_((words_.size() + 63) / 64, 0) {
+  }
+
+  inline void set(const std::size_t &position) {
+	const auto word = position / 64;
+	words_[word] |= std::uint64_t{1} << (position % 64);
+	summary_[word / 64] |= std::uint64_t{1} << (word % 64);
+  }
+
+  // visits the set bits in ascending order, clearing them
+  template<typename F>
+  void forEachAndClear(F &&f) {
+	for (std::size_t summary = 0; summary < summary_.size(); summary++) {
+	  while (summary_[summary]) {
+		const auto word = summary * 64 + std::countr_zero(summary_[summary]);
+		summary_[summary] &= summary_[summary] - 1;
+
+		while (words_[word]) {
+		  const auto bit = std::countr_zero(words_[word]);
+		  words_[word] &= words_[word] - 1;
+		  f(word * 64 + bit);
+		}
+	  }
+	}
+  }
+
+ private:
+  std::vector<std::uint64_t> words_{};
+  std::vector<std::uint64_t> summary_{};
+};
+
+}
@@ -1,5 +1,39 @@
 #pragma once
 
+#include <cstddef>
+#include <cstdint>
+
+// Number of fixed point price units per 1.0 of currency, must be a multiple of 100 to represent a 0.01 tick
+#ifndef BASKET_PRICE_SCALE
+#define BASKET_PRICE_SCALE 10000
+#endif
+
+// Number of fixed point weight units per 1.0 of basket weighting
+#ifndef BASKET_WEIGHT_SCALE
+#define BASKET_WEIGHT_SCALE 1000000
+#endif
+
 namespace basket::pricer {
-using PriceType = double;
+// price in units of 1 / PRICE_SCALE
+using PriceType = std::int64_t;
+
+// basket weighting in units of 1 / WEIGHT_SCALE
+using WeightType = std::int64_t;
+
+// weighted sum of prices as accumulated by a basket, in units of 1 / (PRICE_SCALE * WEIGHT_SCALE),
+// keeping every partial product exact so incremental basket updates never drift
+using WeightedPriceType = std::int64_t;
+
+// delta percentage threshold in units of 1 / THRESHOLD_SCALE percent
+using ThresholdType = std::int64_t;
+
+constexpr PriceType PRICE_SCALE = BASKET_PRICE_SCALE;
+constexpr WeightType WEIGHT_SCALE = BASKET_WEIGHT_SCALE;
+constexpr ThresholdType THRESHOLD_SCALE = 10000;
+
+// padding unit keeping data written by different threads on different cache lines
+constexpr std::size_t CACHE_LINE_SIZE = 64;
+
+// dense id assigned to an instrument when it is subscribed, starting from 0
+using InstrumentIdType = std::int32_t;
 }
@@ -0,0 +1,70 @@
+#pragma once
+
+#include <bit>
+#include <cstddef>
+#include <cstdint>
+#include <limits>
+
+namespace basket::pricer {
+
+// splitmix64, expands a 64 bit seed into independent, well mixed 64 bit words
+class SplitMix64 {
+ public:
+  explicit SplitMix64(const std::uint64_t &seed) : state_(seed) {
+  }
+
+  inline std::uint64_t next() {
+	std::uint64_t z = (state_ += 0x9e3779b97f4a7c15ULL);
+	z = (z ^ (z >> 30)) * 0xbf58476d1ce4e5b9ULL;
+	z = (z ^ (z >> 27)) * 0x94d049bb133111ebULL;
+	return z ^ (z >> 31);
+  }
+
+ private:
+  std::uint64_t state_{0};
+};
+
+// xoshiro256++ - 32 bytes of state, about a nanosecond a draw, seeded through splitmix64 as its authors recommend.
+// Satisfies UniformRandomBitGenerator so the std distributions can draw from it.
+class Xoshiro256PlusPlus {
+ public:
+  using result_type = std::uint64_t;
+
+  explicit Xoshiro256PlusPlus(const std::uint64_t &seed) {
+	SplitMix64 seeder(seed);
+	for (auto &word : state_) word = seeder.next();
+  }
+
+  static constexpr result_type min() { return 0; }
+
+  static constexpr result_type max() { return std::numeric_limits<result_type>::max(); }
+
+  inline result_type operator()() {
+	const std::uint64_t result = std::rotl(state_[0] + state_[3], 23) + state_[0];
+	const std::uint64_t t = state_[1] << 17;
+
+	state_[2] ^= state_[0];
+	state_[3] ^= state_[1];
+	state_[1] ^= state_[2];
+	state_[0] ^= state_[3];
+	state_[2] ^= t;
+	state_[3] = std::rotl(state_[3], 45);
+
+	return result;
+  }
+
+  inline void fill(std::uint64_t *out, const std::size_t &count) {
+	for (std::size_t i = 0; i < count; i++) out[i] = (*this)();
+  }
+
+ private:
+  std::uint64_t state_[4]{};
+};
+
+// uniform double in [0, 1) from the top 52 bits, by setting them as the mantissa of a double in [1, 2) -
+// no integer to floating point conversion, so loops of it vectorize with plain AVX2
+inline double toUnitInterval(const std::uint64_t &bits) {
+  return std::bit_cast<double>((bits >> 12) | 0x3ff0000000000000ULL) - 1.0;
+}
+
+}
@@ -0,0 +1,263 @@
+#include <iomanip>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include "FanInMarketDataProvider.h"
+
+#include "base/latency_clock.h"
+#include "base/spin_wait.h"
+
+namespace basket::pricer {
+FanInMarketDataProvider::FanInMarketDataProvider(std::vector<MarketDataSource> &&sources,
+												 const FanInConfiguration &configuration)
+	: configuration_(configuration) {
+  if (sources.empty()) throw std::invalid_argument("FanInMarketDataProvider needs at least one source");
+
+  for (auto &source : sources) {
+	if (!source.provider_) throw std::invalid_argument("FanInMarketDataProvider source " + source.name_ + " has no provider");
+	sources_.push_back(std::make_unique<Source>(std::move(source), configuration_));
+  }
+
+  batch_.reserve(DELIVERY_BATCH_SIZE);
+  published_at_.reserve(DELIVERY_BATCH_SIZE);
+}
+
+FanInMarketDataProvider::~FanInMarketDataProvider() {
+  joinSources();
+}
+
+void FanInMarketDataProvider::subscribeBatch(BatchCallbackFunc &&callback, std::vector<std::string> &&instrumentList) {
+  callback_ = std::move(callback);
+
+  std::unordered_map<std::string, InstrumentIdType> subscribed;
+  for (InstrumentIdType instrumentId = 0; instrumentId < instrumentList.size(); instrumentId++) {
+	subscribed.emplace(instrumentList[instrumentId], instrumentId);
+  }
+
+  for (auto &source_ptr : sources_) {
+	Source &source = *source_ptr;
+
+	// the source's own instrument ids are the positions in its share of the subscription
+	std::vector<std::string> source_instruments;
+	source.instrument_remap_.clear();
+	for (const auto &instrumentName : source.source_.instrument_list_.empty()
+		? instrumentList : source.source_.instrument_list_) {
+	  auto itr = subscribed.find(instrumentName);
+	  if (itr == subscribed.end()) continue;
+	  source_instruments.push_back(instrumentName);
+	  source.instrument_remap_.push_back(itr->second);
+	}
+
+	source.source_.provider_->subscribeBatch([this, &source](const std::span<const TickEvent> &ticks,
+															 const bool &endOfBatch) {
+	  const auto published_at = LatencyClock::now();
+	  for (std::size_t i = 0; i < ticks.size(); i++) {
+		const auto &tickEvent = ticks[i];
+		// unwinds the source's run() once the subscriber is gone, see stopSources
+		if (stopping_.load(std::memory_order_acquire)) [[unlikely]] {
+		  throw std::runtime_error("Market data source " + source.source_.name_ + " stopped, its subscriber threw");
+		}
+		// the source's end of batch rides on its last tick, an empty one is left to the end of batch before parking
+		QueuedTick queued{tickEvent, published_at, endOfBatch && i + 1 == ticks.size()};
+		queued.tick_event_.instrumentId_ = source.instrument_remap_[tickEvent.instrumentId_];
+		source.ticks_.push(queued);
+	  }
+	  wakeUp();
+	}, std::move(source_instruments));
+  }
+}
+
+void FanInMarketDataProvider::wakeUp() {
+  // pairs with the fence in waitForSources, either we see run() parked or it sees the new ticks
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (parking_.parked_.load(std::memory_order_relaxed) &&
+	  parking_.parked_.exchange(false, std::memory_order_relaxed)) [[unlikely]] {
+	parking_.wake_ups_.fetch_add(1, std::memory_order_release);
+	parking_.wake_ups_.notify_one();
+  }
+}
+
+void FanInMarketDataProvider::run() {
+  stopping_.store(false, std::memory_order_relaxed);
+
+  try {
+	for (auto &source_ptr : sources_) {
+	  Source &source = *source_ptr;
+	  source.drained_ = false;
+	  source.thread_ = std::thread([this, &source] {
+		try {
+		  source.source_.provider_->run();
+		} catch (...) {
+		  source.error_ = std::current_exception();
+		}
+		// after the last tick, run() takes a closed and empty queue as a source done for good
+		source.ticks_.close();
+		wakeUp();
+	  });
+	}
+
+	std::size_t remaining_sources = sources_.size();
+	int idle_sweeps{0};
+	end_of_batch_due_ = false;
+
+	while (remaining_sources > 0) {
+	  std::size_t delivered{0};
+	  for (auto &source_ptr : sources_) {
+		Source &source = *source_ptr;
+		if (source.drained_) continue;
+
+		const bool closed = source.ticks_.isClosed();
+		const auto count = deliver(source);
+		delivered += count;
+		if (count == 0 && closed) {
+		  source.drained_ = true;
+		  remaining_sources--;
+		}
+	  }
+
+	  if (delivered > 0) {
+		idle_sweeps = 0;
+	  } else if (remaining_sources > 0) {
+		// every source is quiet, whatever the subscriber holds per timestamp is not left waiting for the next tick
+		if (idle_sweeps >= SPINS_BEFORE_PARKING) deliverEndOfBatch();
+		waitForSources(idle_sweeps);
+	  }
+	}
+	deliverEndOfBatch();
+  } catch (...) {
+	// the subscriber's exception wins over whatever the stopped sources throw
+	stopSources();
+	throw;
+  }
+
+  joinSources();
+  for (auto &source : sources_) {
+	if (source->error_) std::rethrow_exception(std::exchange(source->error_, nullptr));
+  }
+}
+
+std::size_t FanInMarketDataProvider::deliver(Source &source) {
+  const auto depth = source.ticks_.getDepth();
+  source.queue_depth_.store(depth, std::memory_order_relaxed);
+  if (depth > source.max_queue_depth_.load(std::memory_order_relaxed)) {
+	source.max_queue_depth_.store(depth, std::memory_order_relaxed);
+  }
+  if (depth == 0) return 0;
+
+  batch_.clear();
+  published_at_.clear();
+  QueuedTick queued;
+  bool end_of_batch{false};
+  while (!end_of_batch && batch_.size() < DELIVERY_BATCH_SIZE && source.ticks_.tryPop(queued)) {
+	batch_.push_back(queued.tick_event_);
+	published_at_.push_back(queued.published_at_);
+	end_of_batch = queued.end_of_batch_;
+  }
+  if (batch_.empty()) return 0;
+
+  // As the source ended it. Another source may still publish the same timestamp, its ticks are then priced as a
+  // timestamp of their own.
+  callback_(batch_, end_of_batch);
+  end_of_batch_due_ = !end_of_batch;
+
+  const auto priced_at = LatencyClock::now();
+  for (const auto &published_at : published_at_) source.latency_.record(priced_at - published_at);
+  source.delivered_.store(source.delivered_.load(std::memory_order_relaxed) + batch_.size(),
+						  std::memory_order_relaxed);
+  return batch_.size();
+}
+
+void FanInMarketDataProvider::deliverEndOfBatch() {
+  if (!end_of_batch_due_) return;
+
+  batch_.clear();
+  callback_(batch_, true);
+  end_of_batch_due_ = false;
+}
+
+bool FanInMarketDataProvider::isAnySourceReady() const {
+  for (const auto &source : sources_) {
+	if (!source->drained_ && (!source->ticks_.isEmpty() || source->ticks_.isClosed())) return true;
+  }
+  return false;
+}
+
+void FanInMarketDataProvider::waitForSources(int &idle_sweeps) {
+  if (configuration_.wait_policy_ == ConsumerWaitPolicy::BUSY_POLL || idle_sweeps < SPINS_BEFORE_PARKING) {
+	idle_sweeps++;
+	cpuRelax();
+	return;
+  }
+
+  const std::uint32_t wake_ups = parking_.wake_ups_.load(std::memory_order_acquire);
+  parking_.parked_.store(true, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_seq_cst);
+  if (!isAnySourceReady()) parking_.wake_ups_.wait(wake_ups, std::memory_order_acquire);
+  parking_.parked_.store(false, std::memory_order_relaxed);
+}
+
+void FanInMarketDataProvider::stopSources() {
+  stopping_.store(true, std::memory_order_release);
+
+  // a source spinning on its full queue gets the room to finish that push, it throws before the next one
+  QueuedTick queued;
+  for (auto &source : sources_) {
+	source->ticks_.close();
+	while (source->ticks_.tryPop(queued)) {}
+  }
+
+  joinSources();
+  for (auto &source : sources_) source->error_ = nullptr;
+}
+
+void FanInMarketDataProvider::joinSources() {
+  for (auto &source : sources_) {
+	if (source->thread_.joinable()) source->thread_.join();
+  }
+}
+
+std::vector<FanInSourceCounters> FanInMarketDataProvider::getSourceCounters() const {
+  std::vector<FanInSourceCounters> counters;
+  for (const auto &source : sources_) {
+	counters.push_back({source->source_.name_,
+						source->delivered_.load(std::memory_order_relaxed),
+						source->ticks_.getFullCount(),
+						source->queue_depth_.load(std::memory_order_relaxed),
+						source->max_queue_depth_.load(std::memory_order_relaxed)});
+  }
+  return counters;
+}
+
+void FanInMarketDataProvider::dumpSourceCounters(std::ostream &os) const {
+  const double nanoseconds_per_tick = LatencyClock::nanosecondsPerTick();
+  auto nanoseconds = [nanoseconds_per_tick](const std::uint64_t &clock_ticks) {
+	return clock_ticks * nanoseconds_per_tick;
+  };
+
+  const auto flags = os.flags();
+  const auto precision = os.precision();
+
+  os << "market data sources, latency from publication to priced (ns)" << std::endl
+	 << std::left << std::setw(16) << "source"
+	 << std::right << std::setw(14) << "ticks" << std::setw(10) << "full" << std::setw(10) << "max depth"
+	 << std::setw(12) << "p50" << std::setw(12) << "p99" << std::setw(12) << "p99.9" << std::setw(12) << "max"
+	 << std::endl
+	 << std::fixed << std::setprecision(0);
+
+  const auto counters = getSourceCounters();
+  for (std::size_t i = 0; i < counters.size(); i++) {
+	const auto &latency = sources_[i]->latency_;
+	os << std::left << std::setw(16) << counters[i].name_
+	   << std::right << std::setw(14) << counters[i].ticks_ << std::setw(10) << counters[i].full_
+	   << std::setw(10) << counters[i].max_queue_depth_
+	   << std::setw(12) << nanoseconds(latency.getValueAtPercentile(50))
+	   << std::setw(12) << nanoseconds(latency.getValueAtPercentile(99))
+	   << std::setw(12) << nanoseconds(latency.getValueAtPercentile(99.9))
+	   << std::setw(12) << nanoseconds(latency.getMax()) << std::endl;
+  }
+
+  os.flags(flags);
+  os.precision(precision);
+}
+}
@@ -0,0 +1,32 @@
+#include <thread>
+#include <utility>
+
+#include "QueuedMarketDataProvider.h"
+
+namespace basket::pricer {
+QueuedMarketDataProvider::QueuedMarketDataProvider(const std::size_t &capacity, const ConsumerWaitPolicy &waitPolicy)
+	: ticks_(capacity, OverflowPolicy::SPIN, waitPolicy) {
+}
+
+void QueuedMarketDataProvider::subscribeBatch(BatchCallbackFunc &&callback,
+											  std::vector<std::string> &&instrumentList) {
+  callback_ = std::move(callback);
+  instrument_list_ = std::move(instrumentList);
+}
+
+void QueuedMarketDataProvider::run() {
+  runWith(callback_);
+}
+
+void QueuedMarketDataProvider::waitUntilDrained() const {
+  constexpr static int SPINS_BEFORE_YIELDING = 256;
+
+  for (int spins = 0; processed_.load(std::memory_order_acquire) < published_; spins++) {
+	(spins < SPINS_BEFORE_YIELDING) ? cpuRelax() : std::this_thread::yield();
+  }
+}
+
+void QueuedMarketDataProvider::close() {
+  ticks_.close();
+}
+}
@@ -0,0 +1,31 @@
+#include <utility>
+
+#include "RecordingMarketDataProvider.h"
+
+namespace basket::pricer {
+RecordingMarketDataProvider::RecordingMarketDataProvider(std::shared_ptr<IMarketDataProvider> source,
+														 const std::string &capture_path,
+														 const TickCaptureConfiguration &configuration)
+	: source_(std::move(source)), capture_path_(capture_path), configuration_(configuration) {
+}
+
+void RecordingMarketDataProvider::subscribeBatch(BatchCallbackFunc &&callback,
+												std::vector<std::string> &&instrumentList) {
+  capture_ = std::make_unique<TickCaptureWriter>(capture_path_, instrumentList, configuration_);
+  callback_ = std::move(callback);
+
+  source_->subscribeBatch([this](const std::span<const TickEvent> &ticks, const bool &endOfBatch) {
+	for (const auto &tickEvent : ticks) capture_->write(tickEvent);
+	callback_(ticks, endOfBatch);
+  }, std::move(instrumentList));
+}
+
+void RecordingMarketDataProvider::run() {
+  source_->run();
+  close();
+}
+
+void RecordingMarketDataProvider::close() {
+  if (capture_) capture_->close();
+}
+}
@@ -0,0 +1,136 @@
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "ReplayMarketDataProvider.h"
+
+namespace basket::pricer {
+namespace {
+[[noreturn]] void throwInvalidCapture(const std::string &capture_path, const std::string &reason) {
+  std::ostringstream oss;
+  oss << "Invalid tick capture " << capture_path << " - " << reason;
+  throw std::runtime_error(oss.str());
+}
+}
+
+ReplayMarketDataProvider::ReplayMarketDataProvider(const std::string &capture_path,
+												   const ReplayConfiguration &configuration)
+	: configuration_(configuration) {
+
+  const int fd = ::open(capture_path.c_str(), O_RDONLY);
+  if (fd < 0) throwInvalidCapture(capture_path, "unable to open");
+
+  struct stat file_stat{};
+  if (::fstat(fd, &file_stat) != 0 || file_stat.st_size < static_cast<off_t>(sizeof(TickCaptureHeader))) {
+	::close(fd);
+	throwInvalidCapture(capture_path, "truncated header");
+  }
+
+  mapping_size_ = static_cast<std::size_t>(file_stat.st_size);
+  mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ, MAP_PRIVATE, fd, 0);
+  ::close(fd);
+  if (mapping_ == MAP_FAILED) {
+	mapping_ = nullptr;
+	throwInvalidCapture(capture_path, "unable to map");
+  }
+  ::madvise(mapping_, mapping_size_, MADV_SEQUENTIAL);
+
+  const auto *base = static_cast<const char *>(mapping_);
+  TickCaptureHeader header;
+  std::memcpy(&header, base, sizeof(header));
+
+  try {
+	if (std::memcmp(header.magic_, TickCaptureHeader::MAGIC, sizeof(header.magic_)) != 0 ||
+		header.version_ != TickCaptureHeader::VERSION) {
+	  throwInvalidCapture(capture_path, "not a tick capture or unsupported version");
+	}
+	if (header.tick_event_size_ != sizeof(TickEvent) || header.price_scale_ != PRICE_SCALE) {
+	  throwInvalidCapture(capture_path, "captured with a different TickEvent layout or price scale");
+	}
+	if (header.record_offset_ > mapping_size_ || header.record_offset_ % alignof(TickEvent) != 0) {
+	  throwInvalidCapture(capture_path, "truncated symbol table");
+	}
+
+	std::size_t position = sizeof(TickCaptureHeader);
+	instrument_list_.reserve(header.symbol_count_);
+	for (std::uint64_t i = 0; i < header.symbol_count_; i++) {
+	  std::uint32_t length{0};
+	  if (position + sizeof(length) > header.record_offset_) throwInvalidCapture(capture_path, "truncated symbol table");
+	  std::memcpy(&length, base + position, sizeof(length));
+	  position += sizeof(length);
+
+	  if (position + length > header.record_offset_) throwInvalidCapture(capture_path, "truncated symbol table");
+	  instrument_list_.emplace_back(base + position, length);
+	  position += length;
+	}
+
+	const auto available_records = (mapping_size_ - header.record_offset_) / sizeof(TickEvent);
+	record_count_ = header.record_count_ ? header.record_count_ : available_records;
+	if (record_count_ > available_records) throwInvalidCapture(capture_path, "truncated records");
+	records_ = reinterpret_cast<const TickEvent *>(base + header.record_offset_);
+
+	if (header.record_count_ && header.index_entry_count_ &&
+		header.index_offset_ + header.index_entry_count_ * sizeof(TickCaptureIndexEntry) <= mapping_size_ &&
+		header.index_offset_ % alignof(TickCaptureIndexEntry) == 0) {
+	  index_ = reinterpret_cast<const TickCaptureIndexEntry *>(base + header.index_offset_);
+	  index_entry_count_ = header.index_entry_count_;
+	}
+  } catch (...) {
+	::munmap(mapping_, mapping_size_);
+	throw;
+  }
+}
+
+ReplayMarketDataProvider::~ReplayMarketDataProvider() {
+  if (mapping_) ::munmap(mapping_, mapping_size_);
+}
+
+void ReplayMarketDataProvider::subscribeBatch(BatchCallbackFunc &&callback,
+											  std::vector<std::string> &&instrumentList) {
+  callback_ = std::move(callback);
+  instrument_remap_.clear();
+
+  if (instrumentList == instrument_list_) return;
+
+  std::unordered_map<std::string, InstrumentIdType> subscribed;
+  for (InstrumentIdType instrumentId = 0; instrumentId < instrumentList.size(); instrumentId++) {
+	subscribed.emplace(instrumentList[instrumentId], instrumentId);
+  }
+
+  instrument_remap_.assign(instrument_list_.size(), -1);
+  for (std::size_t i = 0; i < instrument_list_.size(); i++) {
+	auto itr = subscribed.find(instrument_list_[i]);
+	if (itr != subscribed.end()) instrument_remap_[i] = itr->second;
+  }
+}
+
+void ReplayMarketDataProvider::seekToTimestamp(const std::uint64_t &event_timestamp) {
+  std::uint64_t first{0};
+
+  // the index narrows the search down to one stride
+  if (index_entry_count_ > 0) {
+	const auto *entry = std::upper_bound(index_, index_ + index_entry_count_, event_timestamp,
+										 [](const std::uint64_t &ts, const TickCaptureIndexEntry &e) {
+										   return ts <= e.event_timestamp_;
+										 });
+	if (entry != index_) first = (entry - 1)->record_;
+  }
+
+  next_record_ = std::lower_bound(records_ + first, records_ + record_count_, event_timestamp,
+								  [](const TickEvent &tickEvent, const std::uint64_t &ts) {
+									return tickEvent.event_timestamp_ < ts;
+								  }) - records_;
+}
+
+void ReplayMarketDataProvider::run() {
+  runWith(callback_);
+}
+}
@@ -0,0 +1,203 @@
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+#include <unordered_map>
+#include <utility>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+
+#include "SharedMemoryMarketDataProvider.h"
+
+#include "base/seqlock_ring.h"
+
+namespace basket::pricer {
+namespace {
+[[noreturn]] void throwInvalidRing(const std::string &name, const std::string &reason) {
+  std::ostringstream oss;
+  oss << "Invalid shared memory tick ring " << name << " - " << reason;
+  throw std::runtime_error(oss.str());
+}
+}
+
+SharedMemoryMarketDataProvider::SharedMemoryMarketDataProvider(const std::string &name,
+															   const SharedMemoryFeedConfiguration &configuration)
+	: configuration_(configuration), name_(name) {
+
+  const int fd = ::shm_open(name_.c_str(), O_RDWR, 0);
+  if (fd < 0) throwInvalidRing(name_, "unable to open, is the writer running?");
+
+  struct stat ring_stat{};
+  if (::fstat(fd, &ring_stat) != 0 || ring_stat.st_size < static_cast<off_t>(sizeof(SharedMemoryTickRingHeader))) {
+	::close(fd);
+	throwInvalidRing(name_, "truncated header");
+  }
+
+  mapping_size_ = static_cast<std::size_t>(ring_stat.st_size);
+  mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping_ == MAP_FAILED) {
+	mapping_ = nullptr;
+	throwInvalidRing(name_, "unable to map");
+  }
+
+  const auto *base = static_cast<const char *>(mapping_);
+  header_ = static_cast<SharedMemoryTickRingHeader *>(mapping_);
+
+  try {
+	if (header_->magic_.load(std::memory_order_acquire) != SharedMemoryTickRingHeader::MAGIC_WORD ||
+		header_->version_ != SharedMemoryTickRingHeader::VERSION) {
+	  throwInvalidRing(name_, "not a tick ring, unsupported version or not initialised yet");
+	}
+	if (header_->slot_size_ != sizeof(SharedMemoryTickSlot) || header_->price_scale_ != PRICE_SCALE) {
+	  throwInvalidRing(name_, "written with a different TickEvent layout or price scale");
+	}
+	if (header_->capacity_ == 0 || (header_->capacity_ & (header_->capacity_ - 1)) != 0 ||
+		header_->slot_offset_ % CACHE_LINE_SIZE != 0 ||
+		header_->slot_offset_ + header_->capacity_ * sizeof(SharedMemoryTickSlot) > mapping_size_) {
+	  throwInvalidRing(name_, "truncated slots");
+	}
+
+	std::size_t position = sizeof(SharedMemoryTickRingHeader);
+	instrument_list_.reserve(header_->symbol_count_);
+	for (std::uint64_t i = 0; i < header_->symbol_count_; i++) {
+	  std::uint32_t length{0};
+	  if (position + sizeof(length) > header_->slot_offset_) throwInvalidRing(name_, "truncated symbol table");
+	  std::memcpy(&length, base + position, sizeof(length));
+	  position += sizeof(length);
+
+	  if (position + length > header_->slot_offset_) throwInvalidRing(name_, "truncated symbol table");
+	  instrument_list_.emplace_back(base + position, length);
+	  position += length;
+	}
+
+	slots_ = reinterpret_cast<const SharedMemoryTickSlot *>(base + header_->slot_offset_);
+	mask_ = header_->capacity_ - 1;
+
+	for (auto &reader : header_->readers_) {
+	  auto state = SharedMemoryTickReaderCursor::FREE;
+	  if (reader.state_.compare_exchange_strong(state, SharedMemoryTickReaderCursor::ATTACHING,
+												std::memory_order_acq_rel)) {
+		cursor_ = &reader;
+		break;
+	  }
+	}
+	if (!cursor_) throwInvalidRing(name_, "no reader slot left");
+  } catch (...) {
+	::munmap(mapping_, mapping_size_);
+	throw;
+  }
+
+  // the writer ignores the cursor until it is ATTACHED, by then its position is set
+  const auto head = header_->head_.load(std::memory_order_acquire);
+  position_ = configuration_.from_oldest_ ? (head > header_->capacity_ ? head - header_->capacity_ : 0) : head;
+  cursor_->position_.store(position_, std::memory_order_release);
+  cursor_->state_.store(SharedMemoryTickReaderCursor::ATTACHED, std::memory_order_release);
+
+  batch_.reserve(FEED_BATCH_SIZE);
+  written_at_.reserve(FEED_BATCH_SIZE);
+}
+
+SharedMemoryMarketDataProvider::~SharedMemoryMarketDataProvider() {
+  cursor_->state_.store(SharedMemoryTickReaderCursor::FREE, std::memory_order_release);
+  ::munmap(mapping_, mapping_size_);
+}
+
+void SharedMemoryMarketDataProvider::subscribeBatch(BatchCallbackFunc &&callback,
+													std::vector<std::string> &&instrumentList) {
+  callback_ = std::move(callback);
+  instrument_remap_.clear();
+
+  if (instrumentList == instrument_list_) return;
+
+  std::unordered_map<std::string, InstrumentIdType> subscribed;
+  for (InstrumentIdType instrumentId = 0; instrumentId < instrumentList.size(); instrumentId++) {
+	subscribed.emplace(instrumentList[instrumentId], instrumentId);
+  }
+
+  instrument_remap_.assign(instrument_list_.size(), -1);
+  for (std::size_t i = 0; i < instrument_list_.size(); i++) {
+	auto itr = subscribed.find(instrument_list_[i]);
+	if (itr != subscribed.end()) instrument_remap_[i] = itr->second;
+  }
+}
+
+bool SharedMemoryMarketDataProvider::tryRead(TickEvent &tickEvent, std::uint64_t &written_at, std::uint32_t &flags) {
+  return tryReadSeqlockSlot(position_, gap_count_, mask_ + 1,
+							[this](const std::uint64_t &position) -> const SharedMemoryTickSlot & {
+							  return slots_[position & mask_];
+							},
+							[&](const SharedMemoryTickSlot &slot) {
+							  tickEvent = slot.tick_event_;
+							  written_at = slot.written_at_;
+							  flags = slot.flags_;
+							},
+							[this] { return header_->head_.load(std::memory_order_acquire); });
+}
+
+std::size_t SharedMemoryMarketDataProvider::poll() {
+  batch_.clear();
+  written_at_.clear();
+
+  std::size_t read{0};
+  std::size_t ticks_read{0};
+  bool end_of_batch{false};
+  TickEvent tickEvent;
+  std::uint64_t written_at{0};
+  std::uint32_t flags{0};
+
+  // a batch ends with the tick flagged as ending it, the ticks after it come with the next poll
+  while (!end_of_batch && read < FEED_BATCH_SIZE && tryRead(tickEvent, written_at, flags)) {
+	read++;
+	end_of_batch = (flags & SharedMemoryTickSlot::END_OF_BATCH) != 0;
+	if (flags & SharedMemoryTickSlot::NO_TICK) continue;
+	ticks_read++;
+
+	if (!instrument_remap_.empty()) {
+	  if (static_cast<std::size_t>(tickEvent.instrumentId_) >= instrument_remap_.size()) continue;
+	  const auto instrumentId = instrument_remap_[tickEvent.instrumentId_];
+	  if (instrumentId < 0) continue;
+	  tickEvent.instrumentId_ = instrumentId;
+	}
+
+	batch_.push_back(tickEvent);
+	written_at_.push_back(written_at);
+  }
+  if (read == 0) return 0;
+
+  // frees the slots for a writer waiting under OverflowPolicy::SPIN
+  cursor_->position_.store(position_, std::memory_order_release);
+  read_count_.store(read_count_.load(std::memory_order_relaxed) + ticks_read, std::memory_order_relaxed);
+
+  // a batch end stays due when every tick read was filtered out, a conflating pricer may hold ticks until it comes
+  if (!batch_.empty() || end_of_batch) {
+	callback_(batch_, end_of_batch);
+
+	const auto priced_at = ringClockNow();
+	for (const auto &tick_written_at : written_at_) {
+	  tick_to_price_latency_.record(priced_at > tick_written_at ? priced_at - tick_written_at : 0);
+	}
+  }
+  return read;
+}
+
+void SharedMemoryMarketDataProvider::run() {
+  PollBackoff backoff(configuration_.wait_policy_ == FeedWaitPolicy::BUSY_POLL);
+  while (!stopped_.load(std::memory_order_acquire)) {
+	if (poll() > 0) {
+	  backoff.reset();
+	  continue;
+	}
+
+	// closed after the last tick was written, nothing read since means every tick was
+	if (header_->closed_.load(std::memory_order_acquire)) {
+	  if (poll() == 0) break;
+	  continue;
+	}
+
+	backoff.wait();
+  }
+}
+}
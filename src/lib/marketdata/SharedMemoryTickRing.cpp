@@ -0,0 +1,197 @@
+#include <cerrno>
+#include <cstring>
+#include <new>
+#include <sstream>
+#include <stdexcept>
+#include <thread>
+
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
+
+#include "SharedMemoryTickRing.h"
+
+#include "base/spin_wait.h"
+
+namespace basket::pricer {
+namespace {
+[[noreturn]] void throwRingError(const std::string &name, const std::string &reason) {
+  std::ostringstream oss;
+  oss << "Unable to create shared memory tick ring " << name << " - " << reason << " (" << std::strerror(errno) << ")";
+  throw std::runtime_error(oss.str());
+}
+}
+
+SharedMemoryTickWriter::SharedMemoryTickWriter(const std::string &name,
+											   const std::vector<std::string> &instrumentList,
+											   const SharedMemoryTickRingConfiguration &configuration)
+	: name_(name), overflow_policy_(configuration.overflow_policy_) {
+
+  const std::uint64_t capacity = std::bit_ceil(configuration.capacity_ < 2 ? std::size_t{2} : configuration.capacity_);
+
+  std::string symbol_table;
+  for (const auto &instrumentName : instrumentList) {
+	const auto length = static_cast<std::uint32_t>(instrumentName.size());
+	symbol_table.append(reinterpret_cast<const char *>(&length), sizeof(length));
+	symbol_table.append(instrumentName);
+  }
+
+  const auto symbols_end = sizeof(SharedMemoryTickRingHeader) + symbol_table.size();
+  const auto slot_offset = (symbols_end + CACHE_LINE_SIZE - 1) / CACHE_LINE_SIZE * CACHE_LINE_SIZE;
+  mapping_size_ = slot_offset + capacity * sizeof(SharedMemoryTickSlot);
+
+  // a ring left behind by a writer which did not exit cleanly is replaced, its readers keep their own mapping
+  ::shm_unlink(name_.c_str());
+  const int fd = ::shm_open(name_.c_str(), O_CREAT | O_EXCL | O_RDWR, 0600);
+  if (fd < 0) throwRingError(name_, "shm_open failed");
+
+  if (::ftruncate(fd, static_cast<off_t>(mapping_size_)) != 0) {
+	::close(fd);
+	::shm_unlink(name_.c_str());
+	throwRingError(name_, "unable to size");
+  }
+
+  mapping_ = ::mmap(nullptr, mapping_size_, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+  ::close(fd);
+  if (mapping_ == MAP_FAILED) {
+	mapping_ = nullptr;
+	::shm_unlink(name_.c_str());
+	throwRingError(name_, "unable to map");
+  }
+
+  auto *base = static_cast<char *>(mapping_);
+  header_ = new(base) SharedMemoryTickRingHeader{};
+  header_->capacity_ = capacity;
+  header_->symbol_count_ = instrumentList.size();
+  header_->slot_offset_ = slot_offset;
+  std::memcpy(base + sizeof(SharedMemoryTickRingHeader), symbol_table.data(), symbol_table.size());
+
+  slots_ = reinterpret_cast<SharedMemoryTickSlot *>(base + slot_offset);
+  for (std::uint64_t i = 0; i < capacity; i++) new(slots_ + i) SharedMemoryTickSlot{};
+  mask_ = capacity - 1;
+
+  header_->magic_.store(SharedMemoryTickRingHeader::MAGIC_WORD, std::memory_order_release);
+}
+
+SharedMemoryTickWriter::~SharedMemoryTickWriter() {
+  close();
+  ::munmap(mapping_, mapping_size_);
+  ::shm_unlink(name_.c_str());
+}
+
+std::uint64_t SharedMemoryTickWriter::getSlowestReaderPosition() const {
+  std::uint64_t slowest = head_;
+  for (const auto &reader : header_->readers_) {
+	if (reader.state_.load(std::memory_order_acquire) != SharedMemoryTickReaderCursor::ATTACHED) continue;
+	const auto position = reader.position_.load(std::memory_order_acquire);
+	if (position < slowest) slowest = position;
+  }
+  return slowest;
+}
+
+int SharedMemoryTickWriter::getAttachedReaderCount() const {
+  int count{0};
+  for (const auto &reader : header_->readers_) {
+	if (reader.state_.load(std::memory_order_acquire) == SharedMemoryTickReaderCursor::ATTACHED) count++;
+  }
+  return count;
+}
+
+void SharedMemoryTickWriter::waitForSlowestReader(const std::uint64_t &head) {
+  for (int spins = 0; head - slowest_reader_ > mask_; spins++) {
+	// the reader may share this core
+	(spins < SPINS_BEFORE_YIELDING) ? cpuRelax() : std::this_thread::yield();
+	slowest_reader_ = getSlowestReaderPosition();
+  }
+}
+
+bool SharedMemoryTickWriter::tryWriteEndOfBatch(const std::uint64_t &written_at) {
+  const std::uint64_t head = head_;
+
+  if (overflow_policy_ != OverflowPolicy::DROP_OLDEST && head - slowest_reader_ > mask_) {
+	slowest_reader_ = getSlowestReaderPosition();
+	if (head - slowest_reader_ > mask_) {
+	  if (overflow_policy_ == OverflowPolicy::DROP_NEWEST) return false;
+	  waitForSlowestReader(head);
+	}
+  }
+
+  SharedMemoryTickSlot &slot = slots_[head & mask_];
+  slot.sequence_.store(2 * head + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+  slot.written_at_ = written_at;
+  slot.tick_event_ = {};
+  slot.flags_ = SharedMemoryTickSlot::END_OF_BATCH | SharedMemoryTickSlot::NO_TICK;
+  slot.sequence_.store(2 * head + 2, std::memory_order_release);
+
+  head_ = head + 1;
+  end_of_batch_slots_++;
+  return true;
+}
+
+std::size_t SharedMemoryTickWriter::write(const std::span<const TickEvent> &ticks, const bool &endOfBatch) {
+  // one clock read stamps the whole span, its ticks become visible together as far as a reader can tell
+  const std::uint64_t written_at = ringClockNow();
+  std::size_t written{0};
+
+  // the end of an earlier batch none of whose ticks were written comes before the ticks of this one
+  if (end_of_batch_pending_) end_of_batch_pending_ = !tryWriteEndOfBatch(written_at);
+
+  // The latest slot written is published once the next one is, or at the end with the batch flag, so the flag lands
+  // on the last tick written even when DROP_NEWEST discards the ticks after it
+  SharedMemoryTickSlot *unpublished{nullptr};
+  auto publish = [&unpublished](const std::uint32_t &flags) {
+	if (!unpublished) return;
+	unpublished->flags_ = flags;
+	unpublished->sequence_.store(unpublished->sequence_.load(std::memory_order_relaxed) + 1, std::memory_order_release);
+	unpublished = nullptr;
+  };
+
+  for (std::size_t i = 0; i < ticks.size(); i++) {
+	const std::uint64_t head = head_;
+
+	if (overflow_policy_ != OverflowPolicy::DROP_OLDEST && head - slowest_reader_ > mask_) [[unlikely]] {
+	  slowest_reader_ = getSlowestReaderPosition();
+
+	  if (head - slowest_reader_ > mask_) {
+		full_++;
+		if (overflow_policy_ == OverflowPolicy::DROP_NEWEST) {
+		  dropped_++;
+		  continue;
+		}
+
+		// the readers may be waiting on the tick not published yet
+		publish(0);
+		waitForSlowestReader(head);
+	  }
+	}
+
+	publish(0);
+
+	SharedMemoryTickSlot &slot = slots_[head & mask_];
+	// odd sequence while the slot is being written, a reader discards what it copied meanwhile
+	slot.sequence_.store(2 * head + 1, std::memory_order_relaxed);
+	std::atomic_thread_fence(std::memory_order_release);
+	slot.written_at_ = written_at;
+	slot.tick_event_ = ticks[i];
+	unpublished = &slot;
+
+	head_ = head + 1;
+	written++;
+  }
+  if (unpublished) {
+	publish(endOfBatch ? SharedMemoryTickSlot::END_OF_BATCH : 0);
+	// a batch end still due is superseded by the later ticks, whose own batch end follows them
+	end_of_batch_pending_ = false;
+  } else if (endOfBatch) {
+	end_of_batch_pending_ = !tryWriteEndOfBatch(written_at);
+  }
+
+  header_->head_.store(head_, std::memory_order_release);
+  return written;
+}
+
+void SharedMemoryTickWriter::close() {
+  header_->closed_.store(1, std::memory_order_release);
+}
+}
@@ -0,0 +1,115 @@
+#include <algorithm>
+#include <cstring>
+#include <sstream>
+#include <stdexcept>
+
+#include "TickCapture.h"
+
+namespace basket::pricer {
+TickCaptureWriter::TickCaptureWriter(const std::string &path,
+									 const std::vector<std::string> &instrumentList,
+									 const TickCaptureConfiguration &configuration)
+	: path_(path), stream_buffer_(1 << 20), ticks_(configuration.queue_capacity_, OverflowPolicy::SPIN, ConsumerWaitPolicy::PARK) {
+
+  ofs_.rdbuf()->pubsetbuf(stream_buffer_.data(), static_cast<std::streamsize>(stream_buffer_.size()));
+  ofs_.open(path, std::ios::binary | std::ios::trunc);
+  if (!ofs_) {
+	std::ostringstream oss;
+	oss << "Unable to create tick capture " << path;
+	throw std::runtime_error(oss.str());
+  }
+
+  std::memcpy(header_.magic_, TickCaptureHeader::MAGIC, sizeof(header_.magic_));
+  header_.symbol_count_ = instrumentList.size();
+  header_.index_stride_ = configuration.index_stride_;
+
+  std::string symbol_table;
+  for (const auto &instrumentName : instrumentList) {
+	const auto length = static_cast<std::uint32_t>(instrumentName.size());
+	symbol_table.append(reinterpret_cast<const char *>(&length), sizeof(length));
+	symbol_table.append(instrumentName);
+  }
+
+  const auto symbols_end = sizeof(TickCaptureHeader) + symbol_table.size();
+  header_.record_offset_ = (symbols_end + TICK_CAPTURE_ALIGNMENT - 1) / TICK_CAPTURE_ALIGNMENT * TICK_CAPTURE_ALIGNMENT;
+  symbol_table.resize(header_.record_offset_ - sizeof(TickCaptureHeader), '\0');
+
+  ofs_.write(reinterpret_cast<const char *>(&header_), sizeof(header_));
+  ofs_.write(symbol_table.data(), static_cast<std::streamsize>(symbol_table.size()));
+  if (!ofs_) throwWriteFailure();
+
+  writer_thread_ = std::thread([this] { drain(); });
+}
+
+TickCaptureWriter::~TickCaptureWriter() {
+  // a failure cannot leave the destructor, close() reports it
+  try {
+	close();
+  } catch (const std::runtime_error &) {
+  }
+}
+
+void TickCaptureWriter::throwWriteFailure() const {
+  std::ostringstream oss;
+  oss << "Unable to write tick capture " << path_;
+  throw std::runtime_error(oss.str());
+}
+
+void TickCaptureWriter::drain() {
+  std::vector<TickEvent> batch;
+  batch.reserve(WRITE_BATCH_SIZE);
+
+  std::uint64_t record_count{0};
+
+  while (true) {
+	ticks_.waitForData();
+
+	batch.clear();
+	if (ticks_.popBatch(batch, WRITE_BATCH_SIZE) == 0) {
+	  if (ticks_.isClosed() && ticks_.isEmpty()) break;
+	  continue;
+	}
+
+	// once the stream failed, the queue is still drained so the publishing thread never waits on it
+	if (!ofs_) continue;
+
+	if (header_.index_stride_ > 0) {
+	  // first record of each stride
+	  for (auto record = (record_count + header_.index_stride_ - 1) / header_.index_stride_ * header_.index_stride_;
+		   record < record_count + batch.size(); record += header_.index_stride_) {
+		index_.push_back({batch[record - record_count].event_timestamp_, record});
+	  }
+	}
+
+	ofs_.write(reinterpret_cast<const char *>(batch.data()),
+			   static_cast<std::streamsize>(batch.size() * sizeof(TickEvent)));
+	record_count += batch.size();
+	record_count_.store(record_count, std::memory_order_release);
+  }
+}
+
+void TickCaptureWriter::close() {
+  if (!writer_thread_.joinable()) return;
+
+  ticks_.close();
+  writer_thread_.join();
+
+  // the capture would read as valid with the records written so far, the header is left as it is
+  if (!ofs_) {
+	ofs_.close();
+	throwWriteFailure();
+  }
+
+  header_.record_count_ = record_count_.load(std::memory_order_acquire);
+  header_.index_offset_ = header_.record_offset_ + header_.record_count_ * sizeof(TickEvent);
+  header_.index_entry_count_ = index_.size();
+
+  ofs_.write(reinterpret_cast<const char *>(index_.data()),
+			 static_cast<std::streamsize>(index_.size() * sizeof(TickCaptureIndexEntry)));
+
+  ofs_.seekp(0);
+  ofs_.write(reinterpret_cast<const char *>(&header_), sizeof(header_));
+  ofs_.close();
+  if (!ofs_) throwWriteFailure();
+}
+}
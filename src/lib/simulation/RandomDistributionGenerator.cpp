@@ -1,11 +1,45 @@
+#include <cmath>
 #include <sstream>
 #include <stdexcept>
 
 #include "RandomDistributionGeneratorFactory.h"
 
 namespace basket::pricer {
-std::unique_ptr<IRandomDistributionGenerator>
-RandomDistributionGeneratorFactory::create(const std::vector<std::string> &params) {
+static_assert(std::variant_size_v<RandomDistributionGenerator::Alternatives> == DISTRIBUTION_TYPE_COUNT);
+static_assert(DistributionOf<static_cast<std::size_t>(DistributionType::POISSON)>::TYPE == DistributionType::POISSON);
+static_assert(DistributionOf<static_cast<std::size_t>(DistributionType::UNIFORM_REAL)>::TYPE
+				  == DistributionType::UNIFORM_REAL);
+static_assert(DistributionOf<static_cast<std::size_t>(DistributionType::UNIFORM_INT)>::TYPE
+				  == DistributionType::UNIFORM_INT);
+static_assert(DistributionOf<static_cast<std::size_t>(DistributionType::NORMAL)>::TYPE == DistributionType::NORMAL);
+
+PoissonDistribution::PoissonDistribution(const double &mean) : poisson_(mean) {
+  if (mean > 0 && mean <= INVERSION_MAX_MEAN) {
+	// P(X <= k) until the remaining tail is below the resolution of the uniform draws
+	double probability = std::exp(-mean);
+	double cumulative = probability;
+	for (int k = 1; 1.0 - cumulative > 0x1p-52 && probability > 0; k++) {
+	  cdf_.push_back(cumulative);
+	  probability *= mean / k;
+	  cumulative += probability;
+	}
+  }
+}
+
+UniformIntDistribution::UniformIntDistribution(const double &lower, const double &upper)
+	: lower_(static_cast<std::int64_t>(lower)) {
+  if (static_cast<std::int64_t>(upper) < lower_)
+	throw std::invalid_argument("Unexpected distribution argument");
+  range_ = static_cast<std::uint64_t>(static_cast<std::int64_t>(upper) - lower_) + 1;
+}
+
+RandomDistributionGenerator RandomDistributionGeneratorFactory::create(const std::vector<std::string> &params) {
+  std::random_device rd;
+  return create(params, (static_cast<std::uint64_t>(rd()) << 32) | rd());
+}
+
+RandomDistributionGenerator RandomDistributionGeneratorFactory::create(const std::vector<std::string> &params,
+																	   const std::uint64_t &seed) {
   std::string random_model = params[0];
 
   if (params.size() < 2)
@@ -16,8 +50,7 @@ RandomDistributionGeneratorFactory::create(const std::vector<std::string> &param
   iss >> args1;
 
   if (random_model == "poisson_distribution") {
-	return std::unique_ptr<DistributionGenerator<std::poisson_distribution<>>>
-		(new DistributionGenerator<std::poisson_distribution<>>(args1));
+	return BlockDistributionGenerator<PoissonDistribution>(PoissonDistribution(args1), seed);
   }
 
   if (params.size() != 3)
@@ -29,18 +62,15 @@ RandomDistributionGeneratorFactory::create(const std::vector<std::string> &param
   iss >> args2;
 
   if (random_model == "uniform_real_distribution") {
-	return std::unique_ptr<DistributionGenerator<std::uniform_real_distribution<>>>
-		(new DistributionGenerator<std::uniform_real_distribution<>>(args1, args2));
+	return BlockDistributionGenerator<UniformRealDistribution>(UniformRealDistribution(args1, args2), seed);
   }
   if (random_model == "uniform_int_distribution") {
-	return std::unique_ptr<DistributionGenerator<std::uniform_int_distribution<>>>
-		(new DistributionGenerator<std::uniform_int_distribution<>>(args1, args2));
+	return BlockDistributionGenerator<UniformIntDistribution>(UniformIntDistribution(args1, args2), seed);
   }
   if (random_model == "normal_distribution") {
-	return std::unique_ptr<DistributionGenerator<std::normal_distribution<>>>
-		(new DistributionGenerator<std::normal_distribution<>>(args1, args2));
+	return BlockDistributionGenerator<NormalDistribution>(NormalDistribution(args1, args2), seed);
   }
 
   throw std::invalid_argument("Distribution not support");
 }
-}
\ No newline at end of file
+}
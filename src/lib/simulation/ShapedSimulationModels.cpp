@@ -0,0 +1,90 @@
+#include "ShapedSimulationModels.h"
+
+#include <utility>
+
+namespace basket::pricer {
+template<typename NextEventTime, typename Direction, typename TickMove>
+class ShapedSimulationModels::ModelGroup : public IModelGroup {
+ public:
+  using Model = BasicInstrumentSimulationModel<BlockDistributionGenerator<NextEventTime>,
+											   BlockDistributionGenerator<Direction>,
+											   BlockDistributionGenerator<TickMove>>;
+
+  std::uint32_t add(InstrumentSimulationModel &&model) override {
+	models_.push_back(std::move(model).template specialize<NextEventTime, Direction, TickMove>());
+	return static_cast<std::uint32_t>(models_.size() - 1);
+  }
+
+  void simulate(const std::vector<InstrumentIdType> &instruments,
+				const std::uint32_t *model_index,
+				const InstrumentPrice *prices,
+				InstrumentPrice *next_prices,
+				std::uint64_t *next_event_intervals) override {
+	for (const auto &instrumentId : instruments) {
+	  auto &model = models_[model_index[instrumentId]];
+	  next_prices[instrumentId] = produceNewPriceShape(model, prices[instrumentId]);
+	  next_event_intervals[instrumentId] = model.getNextEventTime();
+	}
+  }
+
+ private:
+  std::vector<Model> models_{};
+};
+
+template<std::size_t Shape>
+std::unique_ptr<ShapedSimulationModels::IModelGroup> ShapedSimulationModels::makeGroup() {
+  return std::make_unique<ModelGroup<DistributionOf<Shape / (DISTRIBUTION_TYPE_COUNT * DISTRIBUTION_TYPE_COUNT)>,
+									 DistributionOf<Shape / DISTRIBUTION_TYPE_COUNT % DISTRIBUTION_TYPE_COUNT>,
+									 DistributionOf<Shape % DISTRIBUTION_TYPE_COUNT>>>();
+}
+
+ShapedSimulationModels::ShapedSimulationModels() {
+  group_of_shape_.fill(-1);
+}
+
+ShapedSimulationModels::~ShapedSimulationModels() = default;
+
+void ShapedSimulationModels::add(InstrumentSimulationModel &&model) {
+  using GroupFactory = std::unique_ptr<IModelGroup> (*)();
+  static constexpr auto GROUP_FACTORIES = []<std::size_t... Shapes>(std::index_sequence<Shapes...>) {
+	return std::array<GroupFactory, MODEL_SHAPE_COUNT>{&makeGroup<Shapes>...};
+  }(std::make_index_sequence<MODEL_SHAPE_COUNT>{});
+
+  const auto shape = model.getShape();
+  if (group_of_shape_[shape] < 0) {
+	group_of_shape_[shape] = static_cast<int>(groups_.size());
+	groups_.push_back(GROUP_FACTORIES[shape]());
+  }
+
+  const auto group = group_of_shape_[shape];
+  model_group_.push_back(static_cast<std::uint32_t>(group));
+  model_index_.push_back(groups_[group]->add(std::move(model)));
+}
+
+void ShapedSimulationModels::clear() {
+  group_of_shape_.fill(-1);
+  groups_.clear();
+  model_group_.clear();
+  model_index_.clear();
+}
+
+void ShapedSimulationModels::simulate(const std::vector<InstrumentIdType> &instruments,
+									  const InstrumentPrice *prices,
+									  InstrumentPrice *next_prices,
+									  std::uint64_t *next_event_intervals,
+									  std::vector<std::vector<InstrumentIdType>> &pending) {
+  if (groups_.size() == 1) {
+	groups_.front()->simulate(instruments, model_index_.data(), prices, next_prices, next_event_intervals);
+	return;
+  }
+
+  pending.resize(groups_.size());
+  for (const auto &instrumentId : instruments) pending[model_group_[instrumentId]].push_back(instrumentId);
+
+  for (std::size_t group = 0; group < groups_.size(); group++) {
+	if (pending[group].empty()) continue;
+	groups_[group]->simulate(pending[group], model_index_.data(), prices, next_prices, next_event_intervals);
+	pending[group].clear();
+  }
+}
+}
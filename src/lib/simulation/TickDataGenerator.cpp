@@ -1,15 +1,29 @@
 #include "TickDataGenerator.h"
 
+#include <algorithm>
 #include <iostream>
+#include <random>
 #include <sstream>
+#include <string_view>
+#include <unordered_set>
 #include <utility>
 
 #include "CSVReader.h"
 
-#include "base/double_comparison.h"
+#include "base/fixed_point.h"
+#include "base/xoshiro.h"
 
 namespace basket::pricer {
-TickDataGenerator::TickDataGenerator(const std::string &csv_path) {
+namespace {
+// seed of the model at position in the simulation config, the position-th output of the master seed splitmix64 stream
+std::uint64_t modelSeed(const std::uint64_t &master_seed, const std::size_t &position) {
+  SplitMix64 seeder(master_seed + position * 0x9e3779b97f4a7c15ULL);
+  return seeder.next();
+}
+}
+
+TickDataGenerator::TickDataGenerator(const std::string &csv_path, const TickDataGeneratorConfiguration &configuration)
+	: configuration_(configuration) {
 
   constexpr static int ROW_INDEX_INSTRUMENT_NAME = 0;
   constexpr static int ROW_INDEX_NEXT_PRICE_CFG = 1;
@@ -18,214 +32,239 @@ TickDataGenerator::TickDataGenerator(const std::string &csv_path) {
   constexpr static int ROW_INDEX_NUMBER_OF_TICKS_CFG = 4;
   constexpr static int ROW_INDEX_MAX_TICKS_DIFF = 5;
   constexpr static int ROW_COUNT_TOTAL = 6;
+  constexpr static auto MASTER_SEED_ROW = "master_seed";
 
-  CSVReader csvReader(csv_path);
-  auto data = csvReader.getData();
-
-  std::istringstream iss;
-
-  for (int i = 0; i < data.size(); i += ROW_COUNT_TOTAL) {
-	const auto &instrumentName = data[i][ROW_INDEX_INSTRUMENT_NAME];
-
-	const auto &next_event_price_cfg = data[i + ROW_INDEX_NEXT_PRICE_CFG];
-	const auto &initial_price_cfg = data[i + ROW_INDEX_INITIAL_PRICE_CFG];
-	const auto &direction_cfg = data[i + ROW_INDEX_DIRECTION_CFG];
-	const auto &number_of_ticks_cfg = data[i + ROW_INDEX_NUMBER_OF_TICKS_CFG];
-
-	int max_tick_diff{0};
-	iss.clear();
-	iss.str(data[i + ROW_INDEX_MAX_TICKS_DIFF][0]);
-	iss >> max_tick_diff;
-
-	GenerationData generation_data;
-	generation_data.generation_model_ = std::move(InstrumentSimulationFactory::create(
-		next_event_price_cfg,
-		initial_price_cfg,
-		direction_cfg,
-		number_of_ticks_cfg,
-		max_tick_diff
-	));
-	generation_data.instrumentPrice = InstrumentPrice{};
-
-	instrument_model_[instrumentName] = std::move(generation_data);
-  }
-}
+  // optional first line master_seed,<seed>
+  bool first_row{true};
+  std::optional<std::uint64_t> master_seed = configuration_.seed_;
 
-void TickDataGenerator::subscribe(CallbackFunc &&callback, std::vector<std::string> &&instrumentList) {
-  callback_ = std::move(callback);
-
-  for (const auto &instrumentName : instrumentList) {
-	simulateInstrument(instrumentName);
-  }
-}
-
-void TickDataGenerator::run() {
+  // the lines of the model being read, one model every ROW_COUNT_TOTAL lines
+  std::array<std::vector<std::string>, ROW_COUNT_TOTAL> model_rows{};
+  int model_row{0};
+  std::uint64_t model_position{0};
+  std::random_device random_device;
 
-  std::set<std::string> instruments_with_events{};
-  std::uint64_t prev_event_clock_tick{0};
-
-  while (!pq_.empty()) {
-	const auto &tickEvent = pq_.top();
-
-	if (tickEvent.event_timestamp_ < lastest_event_timestamp_) {
-	  // we reached the end of the world - timestamp increment from uint64_t max back to 0
+  CSVReader csvReader(csv_path);
+  csvReader.forEachRow([&](const CSVReader::RowView &row) {
+	if (std::exchange(first_row, false) && row[0] == MASTER_SEED_ROW) {
+	  std::uint64_t seed{0};
+	  if (row.size() != 2 || !CSVReader::parseField(row[1], seed)) {
+		std::ostringstream oss;
+		oss << "Invalid " << MASTER_SEED_ROW << " line in " << csv_path << ", expected " << MASTER_SEED_ROW << ",<seed>";
+		throw std::invalid_argument(oss.str());
+	  }
+	  if (!master_seed) master_seed = seed;
 	  return;
 	}
 
-	lastest_event_timestamp_ = tickEvent.event_timestamp_;
-	callback_(tickEvent);
-	instruments_with_events.insert(tickEvent.instrumentName_);
+	model_rows[model_row].assign(row.begin(), row.end());
+	if (++model_row < ROW_COUNT_TOTAL) return;
+	model_row = 0;
+
+	const auto &instrumentName = model_rows[ROW_INDEX_INSTRUMENT_NAME][0];
+
+	ModelConfiguration model_configuration;
+	model_configuration.next_event_time_cfg_ = model_rows[ROW_INDEX_NEXT_PRICE_CFG];
+	model_configuration.initial_price_cfg_ = model_rows[ROW_INDEX_INITIAL_PRICE_CFG];
+	model_configuration.direction_cfg_ = model_rows[ROW_INDEX_DIRECTION_CFG];
+	model_configuration.tick_move_cfg_ = model_rows[ROW_INDEX_NUMBER_OF_TICKS_CFG];
+	CSVReader::parseField(model_rows[ROW_INDEX_MAX_TICKS_DIFF][0], model_configuration.max_tick_diff_);
+	if (master_seed) {
+	  model_configuration.seed_ = modelSeed(*master_seed, model_position);
+	} else {
+	  model_configuration.seed_ = (static_cast<std::uint64_t>(random_device()) << 32) | random_device();
+	}
 
-	pq_.pop();
+	// models are built upon subscription, from the same seed every time, this one rejects an invalid config upfront
+	InstrumentSimulationFactory::create(model_configuration.next_event_time_cfg_,
+										model_configuration.initial_price_cfg_,
+										model_configuration.direction_cfg_,
+										model_configuration.tick_move_cfg_,
+										model_configuration.max_tick_diff_,
+										model_configuration.seed_);
 
-	if (tickEvent.event_timestamp_ > prev_event_clock_tick || pq_.empty()) {
-	  for (const auto &instrumentName : instruments_with_events) {
-		simulateInstrument(instrumentName);
-	  }
-	  instruments_with_events.clear();
-	  prev_event_clock_tick = tickEvent.event_timestamp_;
-	}
-  }
-}
+	instrument_models_[instrumentName] = std::move(model_configuration);
+	model_position++;
+  });
 
-void TickDataGenerator::simulateInstrument(const std::string &instrumentName) {
-  auto itr = instrument_model_.find(instrumentName);
-  if (itr == instrument_model_.end()) [[unlikely]] {
+  if (model_row != 0) {
 	std::ostringstream oss;
-	oss << "Unexpected instrument - instrument " << instrumentName << " simulation model not specified?";
+	oss << "Incomplete simulation model at the end of " << csv_path << ", expected " << ROW_COUNT_TOTAL
+		<< " lines per instrument";
 	throw std::invalid_argument(oss.str());
   }
-
-  GenerationData &generationData = itr->second;
-  InstrumentPrice newInstrumentPrice = produceNewPriceShape(generationData, instrumentName);
-
-  enqueueNewTickEvents(newInstrumentPrice, generationData, instrumentName);
-  generationData.instrumentPrice = newInstrumentPrice;
 }
 
-InstrumentPrice TickDataGenerator::produceNewPriceShape(
-	const GenerationData &generationData,
-	const std::string &instrumentName) const {
-  static constexpr PriceType ticksize = 0.01;
-
-  auto &currentInstrumentPrice = generationData.instrumentPrice;
-  auto newInstrumentPrice = currentInstrumentPrice;
-
-  const PriceType &currBidPrice = currentInstrumentPrice.getBidPrice();
-  const PriceType &currAskPrice = currentInstrumentPrice.getAskPrice();
-
-  const auto &generationMode = generationData.generation_model_;
-
-  if (!double_equal(currBidPrice, 0) && !double_equal(currAskPrice, 0)) {
+void TickDataGenerator::subscribeBatch(BatchCallbackFunc &&callback, std::vector<std::string> &&instrumentList) {
+  callback_ = std::move(callback);
 
-	int maxTickMove = generationMode->getMaxTickDiff();
-	int newTickDiff{0};
+  subscribed_models_.clear();
+  instrument_prices_.clear();
 
-	do {
-	  newInstrumentPrice = currentInstrumentPrice;
+  std::unordered_set<std::string_view> subscribed_instruments;
+  for (const auto &instrumentName : instrumentList) {
+	auto itr = instrument_models_.find(instrumentName);
+	if (itr == instrument_models_.end()) {
+	  std::ostringstream oss;
+	  oss << "Unexpected instrument - instrument " << instrumentName << " simulation model not specified?";
+	  throw std::invalid_argument(oss.str());
+	}
+	if (!subscribed_instruments.insert(instrumentName).second) {
+	  std::ostringstream oss;
+	  oss << "Instrument " << instrumentName << " subscribed more than once";
+	  throw std::invalid_argument(oss.str());
+	}
 
-	  int tickMove = generationMode->getTickMove();
-	  int direction = generationMode->getDirection();
-	  auto side = generationMode->getSide();
-	  PriceType delta = ticksize * tickMove * direction;
+	const auto &model_configuration = itr->second;
+	subscribed_models_.add(std::move(*InstrumentSimulationFactory::create(model_configuration.next_event_time_cfg_,
+																		  model_configuration.initial_price_cfg_,
+																		  model_configuration.direction_cfg_,
+																		  model_configuration.tick_move_cfg_,
+																		  model_configuration.max_tick_diff_,
+																		  model_configuration.seed_)));
+	instrument_prices_.push_back(InstrumentPrice{});
+  }
+  next_instrument_prices_.assign(instrument_prices_.size(), InstrumentPrice{});
+  next_event_intervals_.assign(instrument_prices_.size(), 0);
+
+  stopWorkers();
+  partitions_.clear();
+  merged_rounds_ = 0;
+  released_rounds_.store(0, std::memory_order_relaxed);
+
+  const auto instrument_count = static_cast<int>(subscribed_models_.getInstrumentCount());
+  const int partition_count = std::max(1, std::min(configuration_.generation_threads_, instrument_count));
+
+  for (int i = 0; i < partition_count; i++) {
+	auto partition = std::make_unique<Partition>();
+	partition->first_instrument_ = static_cast<InstrumentIdType>(
+		static_cast<std::int64_t>(instrument_count) * i / partition_count);
+	partition->end_instrument_ = static_cast<InstrumentIdType>(
+		static_cast<std::int64_t>(instrument_count) * (i + 1) / partition_count);
+	partition->instruments_with_events_ = TwoLevelBitset(partition->end_instrument_ - partition->first_instrument_);
+
+	for (auto instrumentId = partition->first_instrument_; instrumentId < partition->end_instrument_; instrumentId++) {
+	  partition->instruments_to_simulate_.push_back(instrumentId);
+	}
+	simulateInstruments(*partition, lastest_event_timestamp_);
+	partitions_.push_back(std::move(partition));
+  }
+}
 
-	  if (side == Side::BID) {
-		PriceType newPrice = currBidPrice + delta;
-		newInstrumentPrice.setBidPrice(newPrice);
+TickDataGenerator::~TickDataGenerator() {
+  stopWorkers();
+}
 
-		if (newPrice > 0 &&
-			(newInstrumentPrice.getBidPrice() > newInstrumentPrice.getAskPrice() ||
-				double_equal(newInstrumentPrice.getAskPrice(), newInstrumentPrice.getBidPrice()))) {
-		  // bid crossed ask -> traded up and move price up
-		  newInstrumentPrice.setAskPrice(newPrice + (generationMode->getTickMove() * ticksize));
-		}
-	  } else if (side == Side::ASK) {
-		PriceType newPrice = currAskPrice + delta;
-		newInstrumentPrice.setAskPrice(newPrice);
+void TickDataGenerator::stopWorkers() {
+  if (workers_.empty()) return;
 
-		if (newPrice > 0 &&
-			(newInstrumentPrice.getBidPrice() > newInstrumentPrice.getAskPrice() ||
-				double_equal(newInstrumentPrice.getAskPrice(), newInstrumentPrice.getBidPrice()))) {
-		  // ask crossed bid -> traded down and move price down
-		  newInstrumentPrice.setBidPrice(newPrice - (generationMode->getTickMove() * ticksize));
-		}
-	  }
+  stopping_.store(true, std::memory_order_release);
+  released_rounds_.fetch_add(1, std::memory_order_release);
+  released_rounds_.notify_all();
 
-	  newTickDiff =
-		  static_cast<int>(std::fabs(newInstrumentPrice.getAskPrice() - newInstrumentPrice.getBidPrice()) / ticksize);
+  for (auto &worker : workers_) worker.join();
+  workers_.clear();
+  stopping_.store(false, std::memory_order_relaxed);
+}
 
-	} while (newTickDiff == 0 ||
-		newInstrumentPrice.getAskPrice() < ticksize ||
-		newInstrumentPrice.getBidPrice() < ticksize ||
-		double_equal(newInstrumentPrice.getAskPrice(), ticksize) ||
-		double_equal(newInstrumentPrice.getBidPrice(), ticksize) ||
-		maxTickMove < newTickDiff);
-  } else if (double_equal(currAskPrice, 0))  [[unlikely]] {
+void TickDataGenerator::run() {
+  runWith(callback_);
+}
 
-	PriceType newPrice{0};
-	if (double_equal(currBidPrice, 0))
-	  newPrice = generationMode->getInitialPrice();
-	else
-	  newPrice = currBidPrice + (generationMode->getTickMove() * ticksize);
+void TickDataGenerator::simulateRounds(Partition &partition) {
+  const std::uint64_t window = std::max<std::uint64_t>(1, configuration_.generation_window_);
+  std::uint64_t last_timestamp = lastest_event_timestamp_;
 
-	newInstrumentPrice.setAskPrice(newPrice);
+  for (std::uint64_t round = 0;; round++) {
+	// the events of round - 2 share the buffer, wait for their merge
+	while (true) {
+	  if (stopping_.load(std::memory_order_acquire)) return;
 
-  } else if (double_equal(currBidPrice, 0)) [[unlikely]] {
+	  const auto released = released_rounds_.load(std::memory_order_acquire);
+	  if (round < 2 || released >= round - 1) break;
+	  released_rounds_.wait(released, std::memory_order_acquire);
+	}
 
-	PriceType newPrice{0};
-	if (double_equal(currAskPrice, 0))
-	  newPrice = generationMode->getInitialPrice();
-	else
-	  newPrice = currAskPrice - (generationMode->getTickMove() * ticksize);
+	last_timestamp = (last_timestamp > std::numeric_limits<std::uint64_t>::max() - window)
+					 ? std::numeric_limits<std::uint64_t>::max() : last_timestamp + window;
 
-	newInstrumentPrice.setBidPrice(newPrice);
+	auto &events = partition.rounds_[round % 2];
+	events.clear();
+	while (simulateNextTimestamp(partition, last_timestamp, [&events](const ScheduledEvent &scheduledEvent) {
+	  events.push_back(scheduledEvent);
+	}));
 
+	partition.exhausted_[round % 2] = partition.end_of_world_ || partition.scheduled_events_.isEmpty();
+	partition.simulated_rounds_.store(round + 1, std::memory_order_release);
+	partition.simulated_rounds_.notify_all();
   }
+}
 
-  return newInstrumentPrice;
+void TickDataGenerator::simulateInstruments(Partition &partition, const std::uint64_t &now) {
+  // draws grouped by model shape, then events scheduled in instrument id order as the wheel publishes them
+  subscribed_models_.simulate(partition.instruments_to_simulate_,
+							  instrument_prices_.data(),
+							  next_instrument_prices_.data(),
+							  next_event_intervals_.data(),
+							  partition.instruments_by_model_shape_);
+
+  for (const auto &instrumentId : partition.instruments_to_simulate_) {
+	enqueueNewTickEvents(partition,
+						 instrument_prices_[instrumentId],
+						 next_instrument_prices_[instrumentId],
+						 next_event_intervals_[instrumentId],
+						 instrumentId,
+						 now);
+	instrument_prices_[instrumentId] = next_instrument_prices_[instrumentId];
+  }
+  partition.instruments_to_simulate_.clear();
 }
 
 void TickDataGenerator::enqueueNewTickEvents(
+	Partition &partition,
+	const InstrumentPrice &prevInstrumentPrice,
 	const InstrumentPrice &newInstrumentPrice,
-	const GenerationData &generationData,
-	const std::string &instrumentName) {
-
-  const auto &prevInstrumentPrice = generationData.instrumentPrice;
-  const auto &generationMode = generationData.generation_model_;
-  const std::uint64_t nextEventTime = lastest_event_timestamp_ + generationMode->getNextEventTime();
-
-  if (!double_equal(newInstrumentPrice.getAskPrice(), prevInstrumentPrice.getAskPrice())) {
-	pq_.emplace(nextEventTime,
-				newInstrumentPrice.getAskPrice(),
-				TickEventType::ASK,
-				instrumentName);
+	const std::uint64_t &nextEventInterval,
+	const InstrumentIdType &instrumentId,
+	const std::uint64_t &now) {
+
+  const std::uint64_t nextEventTime = now + nextEventInterval;
+
+  if (nextEventTime < now) [[unlikely]] {
+	// we reached the end of the world - timestamp increment from uint64_t max back to 0
+	partition.end_of_world_ = true;
+	return;
   }
-  if (!double_equal(newInstrumentPrice.getBidPrice(), prevInstrumentPrice.getBidPrice())) {
-	pq_.emplace(nextEventTime,
-				newInstrumentPrice.getBidPrice(),
-				TickEventType::BID,
-				instrumentName);
+
+  if (newInstrumentPrice.getAskPrice() != prevInstrumentPrice.getAskPrice()) {
+	partition.scheduled_events_.schedule({{nextEventTime,
+										   newInstrumentPrice.getAskPrice(),
+										   TickEventType::ASK,
+										   instrumentId}, now});
+  }
+  if (newInstrumentPrice.getBidPrice() != prevInstrumentPrice.getBidPrice()) {
+	partition.scheduled_events_.schedule({{nextEventTime,
+										   newInstrumentPrice.getBidPrice(),
+										   TickEventType::BID,
+										   instrumentId}, now});
   }
 
-  if (!double_equal(prevInstrumentPrice.getBidPrice(), 0) &&
-	  !double_equal(prevInstrumentPrice.getAskPrice(), 0)) {
+  if (prevInstrumentPrice.getBidPrice() != 0 && prevInstrumentPrice.getAskPrice() != 0) {
 
 	PriceType tradePrice{0};
 
-	if (newInstrumentPrice.getBidPrice() > prevInstrumentPrice.getAskPrice() ||
-		double_equal(newInstrumentPrice.getBidPrice(), prevInstrumentPrice.getAskPrice())) {
+	if (newInstrumentPrice.getBidPrice() >= prevInstrumentPrice.getAskPrice()) {
 	  tradePrice = prevInstrumentPrice.getAskPrice();
-	} else if (newInstrumentPrice.getAskPrice() < prevInstrumentPrice.getBidPrice() ||
-		double_equal(newInstrumentPrice.getAskPrice(), prevInstrumentPrice.getBidPrice())) {
+	} else if (newInstrumentPrice.getAskPrice() <= prevInstrumentPrice.getBidPrice()) {
 	  tradePrice = prevInstrumentPrice.getBidPrice();
 	}
-	if (!double_equal(tradePrice, 0)) {
-	  pq_.emplace(nextEventTime,
-				  tradePrice,
-				  TickEventType::TRADE,
-				  instrumentName);
+	if (tradePrice != 0) {
+	  partition.scheduled_events_.schedule({{nextEventTime,
+											 tradePrice,
+											 TickEventType::TRADE,
+											 instrumentId}, now});
 	}
   }
 
 }
-}
\ No newline at end of file
+}